@@ -20,6 +20,7 @@ endif()
 
 set(tagIN "!IN")
 set(tagOUT "!OUT")
+set(tagFAIL "!FAIL") # The tool must reject the arguments of the test.
 if(NOT MCRL2_ENABLE_EXPERIMENTAL)
   set(_skip_tests "lpsrealelm;besconvert;bessolve;pbesabstract;pbesinst;pbespareqelm;lpsbisim2pbes;txt2bes" CACHE INTERNAL "Used internally by GenerateToolTests.cmake" FORCE)
 else()
@@ -42,8 +43,11 @@ function(add_tool_test TOOL)
   set(test_IN "")
   set(test_OUT "")
   set(save_next)
+  set(test_FAIL FALSE)
   foreach(arg ${ARGN})
-    if(arg STREQUAL ${tagIN})
+    if(arg STREQUAL ${tagFAIL})
+      set(test_FAIL TRUE)
+    elseif(arg STREQUAL ${tagIN})
       set(save_next test_IN)
     elseif(arg STREQUAL ${tagOUT})
       set(save_next test_OUT)
@@ -60,6 +64,9 @@ function(add_tool_test TOOL)
 
   add_test(NAME ${test_name} WORKING_DIRECTORY ${TESTDIR} COMMAND ${TOOL} ${test_args})
   set_tests_properties(${test_name} PROPERTIES LABELS "tooltest")
+  if(test_FAIL)
+    set_tests_properties(${test_name} PROPERTIES WILL_FAIL TRUE)
+  endif()
 
   set(test_deps "")
   foreach(in_file ${test_IN})
@@ -125,7 +132,7 @@ endfunction()
 function(gen_lps2lts_release_tests LPSFILE LTSFILES ACTIONS)
   set(ARGUMENTS "-b10" "-ctau" "-D" "--error-trace" "--init-tsize=10" "-l10" "--no-info"
                 "-rjitty" "-rjittyp" ${_JITTYC} "-sd" "-sb" "-sp" "-sq\;-l100" "-sr\;-l100"
-                "--verbose\;--suppress" "--todo-max=10" "-u" "-yno")
+                "--tree-compression" "--gc-slice=1" "--verbose\;--suppress" "--todo-max=10" "-u" "-yno")
   if(ACTIONS)
     list(GET ACTIONS 0 ACTION)
     list(APPEND ARGUMENTS "-a${ACTIONS}" "-c${ACTION}")
@@ -133,6 +140,11 @@ function(gen_lps2lts_release_tests LPSFILE LTSFILES ACTIONS)
   foreach(arglist ${ARGUMENTS})
     add_tool_test(lps2lts ${arglist} ${tagIN} ${LPSFILE})
   endforeach()
+  # Combinations of options that must be rejected.
+  set(ARGUMENTS "--tree-compression\;-b10" "--por\;--threads=2" "--rewrite-profile=lps2lts.prof\;--threads=2")
+  foreach(arglist ${ARGUMENTS})
+    add_tool_test(lps2lts ${tagFAIL} ${arglist} ${tagIN} ${LPSFILE})
+  endforeach()
   foreach(ltsfile ${LTSFILES})
     add_tool_test(lps2lts ${tagIN} ${LPSFILE} ${tagOUT} ${ltsfile})
   endforeach()
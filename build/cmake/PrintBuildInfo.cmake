@@ -19,6 +19,15 @@ endif()
 if(MCRL2_ENABLE_DEPRECATED)
   set(BUILD_TYPE "${BUILD_TYPE}, developer")
 endif()
+if(MCRL2_ENABLE_THREADSAFE_TERMS)
+  set(BUILD_TYPE "${BUILD_TYPE}, thread-safe terms")
+endif()
+if(MCRL2_ENABLE_OPEN_ADDRESSING_TERM_TABLE)
+  set(BUILD_TYPE "${BUILD_TYPE}, open addressing term table")
+endif()
+if(MCRL2_ENABLE_COMPRESSED_TERM_FILES)
+  set(BUILD_TYPE "${BUILD_TYPE}, compressed term files")
+endif()
 message(STATUS "**")
 message(STATUS "** Building mCRL2 ${MCRL2_VERSION} ${BUILD_TYPE})")
 message(STATUS "** ")
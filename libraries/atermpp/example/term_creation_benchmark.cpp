@@ -0,0 +1,82 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file term_creation_benchmark.cpp
+/// \brief Measures the speed of creating new terms and of looking up existing
+///        terms in the term hashtable. Compile the toolset with and without the
+///        cmake option MCRL2_ENABLE_OPEN_ADDRESSING_TERM_TABLE to compare the
+///        chained and the open addressing hashtable.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+
+using namespace atermpp;
+
+// Runs f and returns the elapsed wall clock time in seconds.
+template <typename Function>
+static double measure(Function f)
+{
+  const std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+int main(int argc, char* argv[])
+{
+  const size_t number_of_terms=(argc>1?std::strtoul(argv[1],nullptr,10):1000000);
+  const size_t number_of_lookups=4;
+
+  function_symbol f("f",2);
+  function_symbol g("g",1);
+  std::vector<aterm_appl> terms;
+  terms.reserve(number_of_terms);
+
+  // Create terms f(g(i),i), which are all new.
+  const double creation_time=measure([&]()
+  {
+    for(size_t i=0; i<number_of_terms; ++i)
+    {
+      terms.push_back(aterm_appl(f,aterm_appl(g,aterm_int(i)),aterm_int(i)));
+    }
+  });
+
+  // Create the same terms again, in a different order, such that all of them are found in the hashtable.
+  size_t found=0;
+  const double lookup_time=measure([&]()
+  {
+    for(size_t n=0; n<number_of_lookups; ++n)
+    {
+      for(size_t i=0; i<number_of_terms; ++i)
+      {
+        const size_t j=(i*7919+n)%number_of_terms;
+        if (aterm_appl(f,aterm_appl(g,aterm_int(j)),aterm_int(j))==terms[j])
+        {
+          found++;
+        }
+      }
+    }
+  });
+
+#ifdef MCRL2_ATERMPP_OPEN_ADDRESSING
+  std::cout << "hashtable:            open addressing\n";
+#else
+  std::cout << "hashtable:            chained\n";
+#endif
+  std::cout << "terms:                " << number_of_terms << "\n"
+            << "creation:             " << creation_time << "s (" << 1e9*creation_time/number_of_terms << "ns per term)\n"
+            << "lookup:               " << lookup_time << "s (" << 1e9*lookup_time/(number_of_lookups*number_of_terms) << "ns per term)\n"
+            << "hashtable size:       " << detail::aterm_table_size << "\n"
+            << "terms in hashtable:   " << detail::total_nodes_in_hashtable << "\n";
+
+  return found==number_of_lookups*number_of_terms?0:1;
+}
@@ -45,6 +45,22 @@ aterm_appl find_if(const Term &t, MatchPredicate match)
   return output;
 }
 
+/// \brief Finds a subterm of t that matches a given predicate.
+/// Unlike find_if, each distinct subterm is inspected only once, which makes the
+/// complexity linear in the number of distinct subterms of t instead of in the size
+/// of t as a tree. This pays off for terms with much sharing.
+/// \param t A term
+/// \param match The predicate that determines if a subterm is a match
+/// \return A subterm that matches the given predicate, or aterm_appl() if none was found.
+template <typename Term, typename MatchPredicate>
+aterm_appl memoized_find_if(const Term &t, MatchPredicate match)
+{
+  aterm_appl output;
+  std::unordered_set<aterm> visited;
+  detail::memoized_find_if_impl< typename std::add_lvalue_reference< MatchPredicate >::type >(t, match, output, visited);
+  return output;
+}
+
 /// \brief Finds a subterm of t that matches a given predicate.
 /// The term is only partially traversed. If the stop predicate
 /// returns true in a subterm, the recursion is not continued.
@@ -100,6 +116,33 @@ Term replace(const Term &t, ReplaceFunction r)
   return vertical_cast<Term>(detail::replace_impl< typename std::add_lvalue_reference< ReplaceFunction >::type >(t, r));
 }
 
+/// \brief Replaces each subterm x of t by r(x), like replace, but the result for
+/// each distinct subterm is computed only once during the traversal. This makes the
+/// complexity linear in the number of distinct subterms of t instead of in the size
+/// of t as a tree. The replace function r must not depend on the position of x in t,
+/// and should not have side effects, as it is not called for repeated occurrences.
+/// \param t A term
+/// \param r The replace function that is applied to subterms.
+/// \return The result of the replacement.
+template <typename Term, typename ReplaceFunction>
+Term memoized_replace(const Term &t, ReplaceFunction r)
+{
+  std::unordered_map<aterm, aterm> cache;
+  return vertical_cast<Term>(detail::memoized_replace_impl< typename std::add_lvalue_reference< ReplaceFunction >::type >(t, r, cache));
+}
+
+/// \brief Replaces each subterm in t that is equal to old_value with new_value, like replace,
+/// but each distinct subterm of t is visited only once.
+/// \param t A term
+/// \param old_value The subterm that will be replaced.
+/// \param new_value The value that will be substituted.
+/// \return The result of the replacement.
+template <typename Term>
+Term memoized_replace(const Term &t, const aterm &old_value, const aterm &new_value)
+{
+  return memoized_replace(t, detail::default_replace(old_value, new_value));
+}
+
 /// \brief Replaces each subterm in t that is equal to old_value with new_value.
 /// The replacements are performed in top down order. For example,
 /// replace(f(f(x)), f(x), x) returns f(x) and not x.
@@ -129,6 +172,21 @@ Term bottom_up_replace(Term t, ReplaceFunction r)
   return Term(down_cast<aterm_appl>(x));
 }
 
+/// \brief Replaces each subterm x of t by r(x) in bottom up order, like bottom_up_replace,
+/// but the result for each distinct subterm is computed only once during the traversal.
+/// The replace function r must not depend on the position of x in t, and should not
+/// have side effects, as it is not called for repeated occurrences.
+/// \param t A term
+/// \param r The replace function that is applied to subterms.
+/// \return The result of the replacement.
+template <typename Term, typename ReplaceFunction>
+Term memoized_bottom_up_replace(const Term& t, ReplaceFunction r)
+{
+  std::unordered_map<aterm, aterm> cache;
+  aterm x = detail::memoized_bottom_up_replace_impl< typename std::add_lvalue_reference< ReplaceFunction >::type >(t, r, cache);
+  return vertical_cast<Term>(x);
+}
+
 /// \brief Replaces each subterm in t that is equal to old_value with new_value.
 /// The replacements are performed in top down order. For example,
 /// replace(f(f(x)), f(x), x) returns f(x) and not x.
@@ -60,8 +60,7 @@ class aterm
     {
       assert(m_term!=nullptr);
       assert(m_term->reference_count()>0);
-      m_term->decrease_reference_count();
-      return m_term->reference_count();
+      return m_term->decrease_reference_count();
     }
 
     template <bool CHECK>
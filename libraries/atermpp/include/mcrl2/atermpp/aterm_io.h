@@ -25,10 +25,24 @@ bool is_binary_aterm_stream(std::istream& is);
 bool is_binary_aterm_file(const std::string& filename);
 
 /// \brief Writes term t to a stream in binary aterm format.
+/// \details The output is compressed if binary_aterm_compression() is true.
 /// \param t A term.
 /// \param os An output stream
 void write_term_to_binary_stream(const aterm &t, std::ostream &os);
 
+/// \brief Returns true if the toolset is built with support for compressed binary aterms,
+///        see the cmake option MCRL2_ENABLE_COMPRESSED_TERM_FILES.
+bool binary_aterm_compression_is_available();
+
+/// \brief Determines whether write_term_to_binary_stream compresses its output.
+/// \details If compression is available it is enabled by default. Compressed and
+///          uncompressed streams are both read by read_term_from_binary_stream.
+/// \exception aterm_io_error if compression is enabled but not available.
+void set_binary_aterm_compression(const bool enable);
+
+/// \brief Returns true if write_term_to_binary_stream compresses its output.
+bool binary_aterm_compression();
+
 
 /// \brief Reads a term from a stream in binary aterm format.
 /// \param is An input stream.
@@ -0,0 +1,159 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/aterm_io_indexed.h
+/// \brief An indexed container of terms in binary aterm format, that
+///        can be read lazily, section by section.
+
+#ifndef MCRL2_ATERMPP_ATERM_IO_INDEXED_H
+#define MCRL2_ATERMPP_ATERM_IO_INDEXED_H
+
+#include <istream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mcrl2/atermpp/aterm_io.h"
+
+namespace atermpp
+{
+
+/// \brief Returns true if the file starts like an indexed binary aterm file.
+/// \details Both an indexed binary aterm file and an ordinary binary aterm file
+///          are recognised as binary by is_binary_aterm_file.
+/// \param filename The name of the file. If empty, nothing is read, and false is returned.
+bool is_indexed_binary_aterm_file(const std::string& filename);
+
+/// \brief Returns true if the stream starts like an indexed binary aterm file.
+/// \details The first characters of the stream are consumed.
+bool is_indexed_binary_aterm_stream(std::istream& is);
+
+/// \brief An input stream that reads from the stream buffer of another stream, and that determines
+///        whether its contents are an indexed binary aterm file without consuming them.
+/// \details This is meant for streams that cannot be rewound, such as standard input. The contents
+///          are read in chunks when they are needed, and are never copied as a whole, such that they
+///          can be passed on to read_term_from_binary_stream or an indexed_binary_aterm_file.
+class inspectable_binary_aterm_istream: public std::istream
+{
+  protected:
+    std::unique_ptr<std::streambuf> m_buffer;
+    bool m_is_indexed;
+
+  public:
+    /// \brief Constructor. Reads the first characters of is to determine its format.
+    explicit inspectable_binary_aterm_istream(std::istream& is);
+
+    ~inspectable_binary_aterm_istream();
+
+    /// \brief Returns true if the stream starts like an indexed binary aterm file.
+    bool is_indexed() const
+    {
+      return m_is_indexed;
+    }
+};
+
+/// \brief Writes a sequence of named terms, called sections, to a stream.
+/// \details Each section is stored in the ordinary binary aterm format, such that
+///          it can be decoded independently of the other sections. An index with
+///          the names and positions of the sections is written at the end by close().
+///          The stream does not need to be seekable, so writing to standard output is possible.
+class indexed_binary_aterm_writer
+{
+  protected:
+    struct section_entry
+    {
+      std::string name;
+      std::size_t offset;
+      std::size_t size;
+    };
+
+    std::ostream& m_stream;
+    std::size_t m_position;
+    std::vector<section_entry> m_index;
+    bool m_closed;
+
+    void write_bytes(const char* bytes, const std::size_t size);
+    void write_fixed_size_int(std::size_t n);
+
+  public:
+    /// \brief Constructor. Writes the header of the container to os.
+    indexed_binary_aterm_writer(std::ostream& os);
+
+    /// \brief Adds the term t as a section with the given name, which must not already be in use.
+    void add_section(const std::string& name, const aterm& t);
+
+    /// \brief Writes the index. No sections can be added afterwards.
+    void close();
+};
+
+/// \brief An indexed binary aterm file opened for reading.
+/// \details On systems that support it the file is mapped in memory. Opening the file
+///          only reads its index; the term in a section is only decoded when it is requested.
+///          The decoded terms are not kept, such that memory can be reclaimed as soon as the
+///          caller no longer uses them.
+class indexed_binary_aterm_file
+{
+  protected:
+    struct section_entry
+    {
+      std::size_t offset;
+      std::size_t size;
+    };
+
+    const char* m_data;              // The contents of the file.
+    std::size_t m_size;
+    std::vector<char> m_buffer;      // Holds the contents if the file could not be mapped in memory.
+    bool m_is_mapped;
+    std::vector<std::string> m_section_names;
+    std::map<std::string, section_entry> m_sections;
+
+    void read_index(const std::string& filename);
+    void unmap();
+    const section_entry& find_section(const std::string& name) const;
+
+  public:
+    /// \brief Opens the file and reads its index.
+    /// \param filename The name of the file. If empty, the file is read from standard input.
+    /// \exception aterm_io_error if the file cannot be opened or is not an indexed binary aterm file.
+    explicit indexed_binary_aterm_file(const std::string& filename);
+
+    /// \brief Reads the remainder of the stream in memory and reads its index.
+    /// \details This is meant for streams that cannot be mapped in memory, such as standard input.
+    /// \exception aterm_io_error if the stream does not contain an indexed binary aterm file.
+    explicit indexed_binary_aterm_file(std::istream& is);
+
+    ~indexed_binary_aterm_file();
+
+    indexed_binary_aterm_file(const indexed_binary_aterm_file&) = delete;
+    indexed_binary_aterm_file& operator=(const indexed_binary_aterm_file&) = delete;
+
+    /// \brief The names of the sections in the order in which they were written.
+    const std::vector<std::string>& section_names() const
+    {
+      return m_section_names;
+    }
+
+    bool has_section(const std::string& name) const
+    {
+      return m_sections.count(name)>0;
+    }
+
+    /// \brief The number of bytes that the encoded section occupies in the file.
+    std::size_t section_size(const std::string& name) const
+    {
+      return find_section(name).size;
+    }
+
+    /// \brief Decodes the term in the section with the given name.
+    /// \exception aterm_io_error if there is no such section.
+    aterm read_section(const std::string& name) const;
+};
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_ATERM_IO_INDEXED_H
@@ -0,0 +1,163 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/concurrent_indexed_set.h
+/// \brief An indexed set that can be used by several threads at the same time.
+
+#ifndef MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
+#define MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace atermpp
+{
+
+/// \brief An indexed set in which elements can be put and looked up by several threads concurrently.
+/// \details The elements are numbered 0, 1, 2, ... in the order in which they are put in the set.
+///          In contrast to indexed_set, elements cannot be erased.
+///
+///          The hashtable uses open addressing with atomic entries. Put and index do not take
+///          locks, except that the thread that starts a resize allocates the new hashtable under
+///          a lock. The contents of the old hashtable are moved to the new one incrementally, in
+///          chunks, by the threads that put elements in the set while the resize is in progress.
+///          Only if the new hashtable becomes full before that is finished, put waits for it.
+///          Elements are stored in segments that are never moved, such that a reference obtained
+///          by get remains valid while other threads put elements in the set.
+///
+///          The hashtable stores indices of type Index. With Index equal to std::uint32_t the
+///          hashtable needs half the memory, but the set cannot contain more than 2^32-3 elements.
+///
+///          ELEMENT must be default constructible, and copying elements must be thread safe. For terms
+///          this requires a thread-safe term library (cmake option MCRL2_ENABLE_THREADSAFE_TERMS).
+template <class ELEMENT, class Index = std::size_t>
+class concurrent_indexed_set
+{
+  protected:
+    // An entry of the hashtable is an index, or one of the following values.
+    static const Index EMPTY = static_cast<Index>(-1);
+    static const Index BUSY = static_cast<Index>(-2);  // An index is being assigned to the key in this entry.
+    static const Index MOVED = static_cast<Index>(-3); // This empty entry has been moved to a newer hashtable.
+
+    static const std::size_t FIRST_SEGMENT_SIZE_LOG = 10;
+    static const std::size_t NUMBER_OF_SEGMENTS = 8*sizeof(std::size_t)-FIRST_SEGMENT_SIZE_LOG;
+    static const std::size_t MIGRATION_CHUNK_SIZE = 4096;
+
+    struct hashtable
+    {
+      std::size_t mask;
+      std::unique_ptr<std::atomic<Index>[]> entries;
+
+      hashtable(const std::size_t size);
+
+      std::size_t size() const
+      {
+        return mask+1;
+      }
+    };
+
+    // The current hashtable and, while a resize is in progress, the previous one. A new
+    // table_state is created for each resize, such that a thread that inspects the tables
+    // always sees a consistent pair.
+    struct table_state
+    {
+      hashtable* current;
+      hashtable* previous;
+      std::atomic<std::size_t> next_chunk;
+      std::atomic<std::size_t> migrated_chunks;
+
+      table_state(hashtable* current_, hashtable* previous_)
+        : current(current_), previous(previous_), next_chunk(0), migrated_chunks(0)
+      {}
+
+      std::size_t number_of_chunks() const
+      {
+        return (previous->size()+MIGRATION_CHUNK_SIZE-1)/MIGRATION_CHUNK_SIZE;
+      }
+    };
+
+    std::atomic<table_state*> m_state;
+    std::atomic<std::size_t> m_size;
+    std::atomic<ELEMENT*> m_segments[NUMBER_OF_SEGMENTS];
+    unsigned int m_max_load;
+
+    // All hashtables and states that have been in use. Old ones are kept, as other threads may
+    // still be reading them, until release_retired_tables is called.
+    mutable std::mutex m_resize_mutex;
+    std::vector<std::unique_ptr<hashtable> > m_hashtables;
+    std::vector<std::unique_ptr<table_state> > m_states;
+
+    ELEMENT& element(const std::size_t index) const;
+    void store_element(const std::size_t index, const ELEMENT& key);
+
+    std::size_t find_in_previous(hashtable& table, const ELEMENT& key, const std::size_t hash) const;
+    bool find_in_current(hashtable& table, const ELEMENT& key, const std::size_t hash, std::size_t& result) const;
+    std::size_t find_or_block_in_previous(hashtable& table, const ELEMENT& key, const std::size_t hash);
+    bool insert(hashtable& table, const ELEMENT& key, const std::size_t hash, std::pair<std::size_t, bool>& result);
+    void move_index(hashtable& table, const Index index);
+    void migrate_chunk(table_state& state);
+    void finish_migration(table_state& state);
+    void resize(table_state& state);
+    void initialise(const std::size_t initial_size);
+
+  public:
+    /// \brief A constant that if returned as an index means that the index does not exist.
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// \brief Constructor.
+    /// \param initial_size The initial capacity of the set.
+    /// \param max_load_pct The maximum load percentage of the hashtable.
+    concurrent_indexed_set(const std::size_t initial_size = 1024, const unsigned int max_load_pct = 50);
+
+    ~concurrent_indexed_set();
+
+    concurrent_indexed_set(const concurrent_indexed_set&) = delete;
+    concurrent_indexed_set& operator=(const concurrent_indexed_set&) = delete;
+
+    /// \brief Puts key in the set, if it is not already there. Can be called concurrently.
+    /// \return A pair of the index of key, and a boolean that is true if key was not yet in the set.
+    /// \exception mcrl2::runtime_error if the number of elements does not fit in Index.
+    std::pair<std::size_t, bool> put(const ELEMENT& key);
+
+    /// \brief Returns the index of key, or npos if key is not in the set. Can be called concurrently.
+    std::size_t index(const ELEMENT& key) const;
+
+    /// \brief Returns the element with the given index, which must have been returned by put or index.
+    /// \details Can be called concurrently. The reference remains valid until the set is cleared.
+    const ELEMENT& get(const std::size_t index) const
+    {
+      return element(index);
+    }
+
+    /// \brief Returns the number of elements in the set.
+    /// \details While other threads put elements in the set, the result can include elements
+    ///          for which put has not returned yet.
+    std::size_t size() const
+    {
+      return m_size.load();
+    }
+
+    /// \brief Removes all elements from the set. Must not be called concurrently with other operations.
+    void clear();
+
+    /// \brief Frees the hashtables that are no longer in use since they were resized.
+    /// \details Must not be called concurrently with other operations.
+    void release_retired_tables();
+
+    /// \brief Returns the number of bytes used by the hashtables, including retired ones.
+    std::size_t hashtable_memory_in_bytes() const;
+};
+
+} // namespace atermpp
+
+#include "mcrl2/atermpp/detail/concurrent_indexed_set.h"
+
+#endif // MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
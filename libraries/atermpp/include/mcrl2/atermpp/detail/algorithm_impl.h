@@ -13,6 +13,9 @@
 #define MCRL2_ATERMPP_DETAIL_ALGORITHM_IMPL_H
 
 #include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "mcrl2/atermpp/aterm_appl.h"
 #include "mcrl2/atermpp/aterm_list.h"
 
@@ -167,6 +170,54 @@ void find_all_if_impl(const aterm &t, MatchPredicate op, OutputIterator& destBeg
   }
 }
 
+/// \brief Implements the memoized_find_if algorithm
+/// Subterms in visited have been inspected before without finding a match.
+/// \param t A term
+/// \param match A predicate function on terms
+/// \param output The variable to store the match in
+/// \param visited The subterms that do not contain a match
+/// \return true if a match was found, false otherwise
+template <typename MatchPredicate>
+bool memoized_find_if_impl(const aterm& t, MatchPredicate match, aterm_appl& output, std::unordered_set<aterm>& visited)
+{
+  if (!visited.insert(t).second)
+  {
+    return false;
+  }
+  if (t.type_is_appl())
+  {
+    const aterm_appl& appl = down_cast<aterm_appl>(t);
+    if (match(appl))
+    {
+      output = appl;
+      return true;
+    }
+    for (aterm_appl::iterator i = appl.begin(); i != appl.end(); ++i)
+    {
+      if (memoized_find_if_impl(*i, match, output, visited))
+      {
+        return true;
+      }
+    }
+  }
+  else if (t.type_is_list())
+  {
+    // The tails of the list are recorded as well, as lists often share their tails.
+    for (aterm_list l = down_cast<aterm_list>(t); !l.empty(); l = l.tail())
+    {
+      if (l != t && !visited.insert(l).second)
+      {
+        break;
+      }
+      if (memoized_find_if_impl(l.front(), match, output, visited))
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 //--- partial find --------------------------------------------------------//
 
 /// \brief Implements the partial_find_if_impl algorithm
@@ -287,6 +338,84 @@ aterm replace_impl(const aterm &t, ReplaceFunction f)
   return t;
 }
 
+/// \brief Applies f to the elements of the list l, using and updating a cache with the results for the tails of l.
+/// \details As lists often share their tails, only the part of l in front of the first tail
+///          that is in the cache is traversed.
+template <typename Function>
+aterm_list memoized_list_apply(const aterm_list& l, const Function& f, std::unordered_map<aterm, aterm>& cache)
+{
+  std::vector<aterm_list> tails;
+  aterm_list result;
+  for (aterm_list i = l; !i.empty(); i = i.tail())
+  {
+    const std::unordered_map<aterm, aterm>::const_iterator j = cache.find(i);
+    if (j != cache.end())
+    {
+      result = down_cast<aterm_list>(j->second);
+      break;
+    }
+    tails.push_back(i);
+  }
+  for (std::vector<aterm_list>::const_reverse_iterator i = tails.rbegin(); i != tails.rend(); ++i)
+  {
+    result.push_front(f(i->front()));
+    cache[*i] = result;
+  }
+  return result;
+}
+
+template <typename ReplaceFunction>
+aterm memoized_replace_impl(const aterm &t, ReplaceFunction f, std::unordered_map<aterm, aterm>& cache);
+
+template <typename ReplaceFunction>
+struct memoized_replace_helper
+{
+  ReplaceFunction m_replace;
+  std::unordered_map<aterm, aterm>& m_cache;
+
+  memoized_replace_helper(ReplaceFunction replace, std::unordered_map<aterm, aterm>& cache)
+    : m_replace(replace),
+      m_cache(cache)
+  {}
+
+  /// \brief Function call operator.
+  /// \param t A term
+  /// \return The function result
+  aterm operator()(const aterm &t) const
+  {
+    return memoized_replace_impl(t, m_replace, m_cache);
+  }
+};
+
+/// \brief Implements the memoized_replace algorithm
+/// \param t A term
+/// \param f A replace function on terms
+/// \param cache The results of the replacement on the subterms that have been visited before
+/// \return The result of the algorithm
+template <typename ReplaceFunction>
+aterm memoized_replace_impl(const aterm &t, ReplaceFunction f, std::unordered_map<aterm, aterm>& cache)
+{
+  if (t.type_is_list())
+  {
+    return memoized_list_apply(down_cast<aterm_list>(t), memoized_replace_helper<ReplaceFunction>(f, cache), cache);
+  }
+  if (!t.type_is_appl())
+  {
+    return t;
+  }
+  const std::unordered_map<aterm, aterm>::const_iterator i = cache.find(t);
+  if (i != cache.end())
+  {
+    return i->second;
+  }
+
+  const aterm_appl& a = down_cast<aterm_appl>(t);
+  const aterm fa = f(a);
+  const aterm result = (a == fa) ? appl_apply(a, memoized_replace_helper<ReplaceFunction>(f, cache)) : fa;
+  cache[t] = result;
+  return result;
+}
+
 struct default_replace
 {
   const aterm m_src;
@@ -400,6 +529,57 @@ aterm bottom_up_replace_impl(const aterm &t, ReplaceFunction f)
   return t;
 }
 
+template <typename ReplaceFunction>
+aterm memoized_bottom_up_replace_impl(const aterm &t, ReplaceFunction f, std::unordered_map<aterm, aterm>& cache);
+
+template <typename ReplaceFunction>
+struct memoized_bottom_up_replace_helper
+{
+  ReplaceFunction m_bottom_up_replace;
+  std::unordered_map<aterm, aterm>& m_cache;
+
+  memoized_bottom_up_replace_helper(ReplaceFunction bottom_up_replace, std::unordered_map<aterm, aterm>& cache)
+    : m_bottom_up_replace(bottom_up_replace),
+      m_cache(cache)
+  {}
+
+  /// \brief Function call operator
+  /// \param t A term
+  /// \return The function result
+  aterm operator()(const aterm &t) const
+  {
+    return memoized_bottom_up_replace_impl(t, m_bottom_up_replace, m_cache);
+  }
+};
+
+/// \brief Implements the memoized_bottom_up_replace algorithm
+/// \param t A term
+/// \param f A replace function on terms
+/// \param cache The results of the replacement on the subterms that have been visited before
+/// \return The result of the algorithm
+template <typename ReplaceFunction>
+aterm memoized_bottom_up_replace_impl(const aterm &t, ReplaceFunction f, std::unordered_map<aterm, aterm>& cache)
+{
+  if (t.type_is_list())
+  {
+    return memoized_list_apply(down_cast<aterm_list>(t), memoized_bottom_up_replace_helper<ReplaceFunction>(f, cache), cache);
+  }
+  if (!t.type_is_appl())
+  {
+    return t;
+  }
+  const std::unordered_map<aterm, aterm>::const_iterator i = cache.find(t);
+  if (i != cache.end())
+  {
+    return i->second;
+  }
+
+  const aterm_appl& a = down_cast<aterm_appl>(t);
+  const aterm result = f(appl_apply(a, memoized_bottom_up_replace_helper<ReplaceFunction>(f, cache)));
+  cache[t] = result;
+  return result;
+}
+
 struct default_bottom_up_replace
 {
   const aterm_appl m_src;
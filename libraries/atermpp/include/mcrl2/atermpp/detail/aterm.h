@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include "mcrl2/atermpp/detail/atypes.h"
+#include "mcrl2/atermpp/detail/aterm_concurrency.h"
 #include "mcrl2/atermpp/detail/function_symbol_constants.h"
 #include "mcrl2/atermpp/function_symbol.h"
 
@@ -20,7 +21,7 @@ class _aterm
 {
   protected:
     function_symbol m_function_symbol;
-    mutable size_t  m_reference_count;
+    mutable reference_count_type m_reference_count;
     mutable const _aterm* m_next;
 
   public:
@@ -34,11 +35,13 @@ class _aterm
       return m_function_symbol;
     }
 
-    void decrease_reference_count() const
+    // Returns the reference count after decreasing it. When terms are shared among
+    // threads, this is the only reliable way to observe that the count became zero.
+    size_t decrease_reference_count() const
     {
       assert(!reference_count_indicates_is_in_freelist());
       assert(!reference_count_is_zero());
-      --m_reference_count;
+      return --m_reference_count;
     } 
 
     void increase_reference_count() const
@@ -32,10 +32,11 @@ const _aterm* local_term_appl_with_converter(const function_symbol& sym,
   }
   assert(j==arity); 
 
+  term_store_lock lock;
 
-  const detail::_aterm* cur = detail::aterm_hashtable[hnr&  detail::aterm_table_mask];
-  while (cur)
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym)
     {
       bool found = true;
@@ -53,13 +54,11 @@ const _aterm* local_term_appl_with_converter(const function_symbol& sym,
         {
           temporary_args[i].~aterm();
         }
-        return cur;
+        return pin_term(cur);
       }
     }
-    cur = cur->next();
   }
 
-  assert(cur==nullptr);
   const detail::_aterm* new_term = (detail::_aterm_appl<Term>*) detail::allocate_term(TERM_SIZE_APPL(arity));
 
   // We copy the content of the temporary_args, without destruction/construction and adapting the reference counts.
@@ -69,11 +68,10 @@ const _aterm* local_term_appl_with_converter(const function_symbol& sym,
   }
   new (&const_cast<detail::_aterm*>(const_cast<detail::_aterm*>(new_term))->function()) function_symbol(sym);
 
-  // Apply the table mask after allocate_term, which may resize the table.
-  insert_in_hashtable(new_term,hnr&  detail::aterm_table_mask);
+  insert_in_hashtable(new_term,hnr);
   call_creation_hook(new_term);
 
-  return new_term;
+  return pin_term(new_term);
 }
 
 template <class Term, class ForwardIterator>
@@ -92,9 +90,11 @@ const _aterm* local_term_appl(const function_symbol& sym, const ForwardIterator
   }
   assert(j==arity);
 
-  const detail::_aterm* cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
-  while (cur)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym)
     {
       bool found = true;
@@ -112,13 +112,11 @@ const _aterm* local_term_appl(const function_symbol& sym, const ForwardIterator
         {
           temporary_args[i].~aterm();
         }
-        return cur;
+        return pin_term(cur);
       }
     }
-    cur = cur->next();
   }
 
-  assert(cur==nullptr);
   const detail::_aterm* new_term = (detail::_aterm_appl<Term>*) detail::allocate_term(TERM_SIZE_APPL(arity));
 
   // We copy the content of the temporary_args, without destruction/construction and adapting the reference counts.
@@ -129,11 +127,10 @@ const _aterm* local_term_appl(const function_symbol& sym, const ForwardIterator
 
   new (&const_cast<detail::_aterm*>(const_cast<detail::_aterm*>(new_term))->function()) function_symbol(sym);
 
-  // Apply the table_mask after applying allocate_term, which may resize the hash_table.
-  insert_in_hashtable(new_term,hnr & detail::aterm_table_mask);
+  insert_in_hashtable(new_term,hnr);
   call_creation_hook(new_term);
   
-  return new_term;
+  return pin_term(new_term);
 }
 
 inline const _aterm* term_appl0(const function_symbol& sym)
@@ -142,27 +139,25 @@ inline const _aterm* term_appl0(const function_symbol& sym)
 
   HashNumber hnr = SHIFT(addressf(sym));
 
-  const detail::_aterm *cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
+  term_store_lock lock;
 
-  while (cur)
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
 
-  cur = detail::allocate_term(detail::TERM_SIZE);
-  /* Delay masking until after allocate */
-  hnr &= detail::aterm_table_mask;
+  const detail::_aterm* cur = detail::allocate_term(detail::TERM_SIZE);
   new (&const_cast<detail::_aterm*>(cur)->function()) function_symbol(sym);
 
   insert_in_hashtable(cur,hnr);
 
   call_creation_hook(cur);
 
-  return cur;
+  return pin_term(cur);
 }
 
 template <class Term>
@@ -173,20 +168,19 @@ const _aterm* term_appl1(const function_symbol& sym, const Term& arg0)
 
   HashNumber hnr = COMBINE(SHIFT(addressf(sym)), arg0);
 
-  const detail::_aterm *cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
-  while (cur)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if ((sym==cur->function()) &&
          reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[0] == arg0)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
 
-  cur = detail::allocate_term(TERM_SIZE_APPL(1));
-  /* Delay masking until after allocate_term */
-  hnr &= detail::aterm_table_mask;
+  const detail::_aterm* cur = detail::allocate_term(TERM_SIZE_APPL(1));
 
   new (&const_cast<detail::_aterm*>(cur)->function()) function_symbol(sym);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[0])) Term(arg0);
@@ -194,7 +188,7 @@ const _aterm* term_appl1(const function_symbol& sym, const Term& arg0)
 
   call_creation_hook(cur);
 
-  return cur;
+  return pin_term(cur);
 }
 
 template <class Term>
@@ -206,21 +200,20 @@ const _aterm* term_appl2(const function_symbol& sym, const Term& arg0, const Ter
   CHECK_TERM(arg1);
   HashNumber hnr = COMBINE(COMBINE(SHIFT(addressf(sym)), arg0),arg1);
 
-  const detail::_aterm *cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
-  while (cur)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[0] == arg0 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[1] == arg1)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
 
-  cur = detail::allocate_term(TERM_SIZE_APPL(2));
-  /* Delay masking until after allocate_term */
-  hnr &= detail::aterm_table_mask;
+  const detail::_aterm* cur = detail::allocate_term(TERM_SIZE_APPL(2));
   new (&const_cast<detail::_aterm*>(cur)->function()) function_symbol(sym);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[0])) Term(arg0);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[1])) Term(arg1);
@@ -229,7 +222,7 @@ const _aterm* term_appl2(const function_symbol& sym, const Term& arg0, const Ter
 
   call_creation_hook(cur);
 
-  return cur;
+  return pin_term(cur);
 }
 
 template <class Term>
@@ -243,22 +236,21 @@ const _aterm* term_appl3(const function_symbol& sym, const Term& arg0, const Ter
   CHECK_TERM(arg2);
   HashNumber hnr = COMBINE(COMBINE(COMBINE(SHIFT(addressf(sym)), arg0),arg1),arg2);
 
-  const detail::_aterm *cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
-  while (cur)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[0] == arg0 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[1] == arg1 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[2] == arg2)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
 
-  cur = detail::allocate_term(TERM_SIZE_APPL(3));
-  /* Delay masking until after allocate_term */
-  hnr &= detail::aterm_table_mask;
+  const detail::_aterm* cur = detail::allocate_term(TERM_SIZE_APPL(3));
   new (&const_cast<detail::_aterm*>(cur)->function()) function_symbol(sym);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[0])) Term(arg0);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[1])) Term(arg1);
@@ -268,7 +260,7 @@ const _aterm* term_appl3(const function_symbol& sym, const Term& arg0, const Ter
 
   call_creation_hook(cur);
 
-  return cur;
+  return pin_term(cur);
 }
 
 template <class Term>
@@ -282,25 +274,21 @@ const _aterm *term_appl4(const function_symbol& sym, const Term& arg0, const Ter
 
   HashNumber hnr = COMBINE(COMBINE(COMBINE(COMBINE(SHIFT(addressf(sym)), arg0), arg1), arg2), arg3);
 
-  const detail::_aterm* cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
-  while (cur)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[0] == arg0 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[1] == arg1 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[2] == arg2 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[3] == arg3)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
-
-  assert(!cur);
-
-  cur = detail::allocate_term(TERM_SIZE_APPL(4));
-  /* Delay masking until after allocate_term */
-  hnr &= detail::aterm_table_mask;
+  const detail::_aterm* cur = detail::allocate_term(TERM_SIZE_APPL(4));
   new (&const_cast<detail::_aterm*>(cur)->function()) function_symbol(sym);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[0])) Term(arg0);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[1])) Term(arg1);
@@ -311,7 +299,7 @@ const _aterm *term_appl4(const function_symbol& sym, const Term& arg0, const Ter
 
   call_creation_hook(cur);
 
-  return cur;
+  return pin_term(cur);
 }
 
 template <class Term>
@@ -328,9 +316,11 @@ const _aterm* term_appl5(const function_symbol& sym, const Term& arg0, const Ter
 
   HashNumber hnr = COMBINE(COMBINE(COMBINE(COMBINE(COMBINE(SHIFT(addressf(sym)), arg0), arg1), arg2), arg3), arg4);
 
-  const detail::_aterm *cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
-  while (cur)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[0] == arg0 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[1] == arg1 &&
@@ -338,16 +328,10 @@ const _aterm* term_appl5(const function_symbol& sym, const Term& arg0, const Ter
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[3] == arg3 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[4] == arg4)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
-
-  assert(!cur);
-
-  cur = detail::allocate_term(TERM_SIZE_APPL(5));
-  /* Delay masking until after allocate_term */
-  hnr &= detail::aterm_table_mask;
+  const detail::_aterm* cur = detail::allocate_term(TERM_SIZE_APPL(5));
   new (&const_cast<detail::_aterm*>(cur)->function()) function_symbol(sym);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[0])) Term(arg0);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[1])) Term(arg1);
@@ -359,7 +343,7 @@ const _aterm* term_appl5(const function_symbol& sym, const Term& arg0, const Ter
 
   call_creation_hook(cur);
 
-  return cur;
+  return pin_term(cur);
 }
 
 template <class Term>
@@ -376,9 +360,11 @@ const _aterm *term_appl6(const function_symbol& sym, const Term& arg0, const Ter
 
   HashNumber hnr = COMBINE(COMBINE(COMBINE(COMBINE(COMBINE(COMBINE(SHIFT(addressf(sym)), arg0), arg1), arg2), arg3), arg4), arg5);
 
-  const detail::_aterm* cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
-  while (cur)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[0] == arg0 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[1] == arg1 &&
@@ -387,16 +373,10 @@ const _aterm *term_appl6(const function_symbol& sym, const Term& arg0, const Ter
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[4] == arg4 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[5] == arg5)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
-
-  assert(!cur);
-
-  cur = detail::allocate_term(TERM_SIZE_APPL(6));
-  /* Delay masking until after allocate_term */
-  hnr &= detail::aterm_table_mask;
+  const detail::_aterm* cur = detail::allocate_term(TERM_SIZE_APPL(6));
 
   new (&const_cast<detail::_aterm*>(cur)->function()) function_symbol(sym);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[0])) Term(arg0);
@@ -410,7 +390,7 @@ const _aterm *term_appl6(const function_symbol& sym, const Term& arg0, const Ter
 
   call_creation_hook(cur);
 
-  return cur;
+  return pin_term(cur);
 }
 
 template <class Term>
@@ -428,9 +408,11 @@ const _aterm *term_appl7(const function_symbol& sym, const Term& arg0, const Ter
 
   HashNumber hnr = COMBINE(COMBINE(COMBINE(COMBINE(COMBINE(COMBINE(COMBINE(SHIFT(addressf(sym)), arg0), arg1), arg2), arg3), arg4), arg5), arg6);
 
-  const detail::_aterm* cur = detail::aterm_hashtable[hnr & detail::aterm_table_mask];
-  while (cur)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
   {
+    const detail::_aterm* cur=i.term();
     if (cur->function()==sym &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[0] == arg0 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[1] == arg1 &&
@@ -440,16 +422,10 @@ const _aterm *term_appl7(const function_symbol& sym, const Term& arg0, const Ter
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[5] == arg5 &&
         reinterpret_cast<const detail::_aterm_appl<Term>*>(cur)->arg[6] == arg6)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
-
-  assert(!cur);
-
-  cur = detail::allocate_term(TERM_SIZE_APPL(7));
-  /* Delay masking until after allocate_term */
-  hnr &= detail::aterm_table_mask;
+  const detail::_aterm* cur = detail::allocate_term(TERM_SIZE_APPL(7));
 
   new (&const_cast<detail::_aterm*>(cur)->function()) function_symbol(sym);
   new (&(reinterpret_cast<detail::_aterm_appl<Term>*>(const_cast<detail::_aterm*>(cur))->arg[0])) Term(arg0);
@@ -464,7 +440,7 @@ const _aterm *term_appl7(const function_symbol& sym, const Term& arg0, const Ter
 
   call_creation_hook(cur);
 
-  return cur;
+  return pin_term(cur);
 }
 } //namespace detail
 
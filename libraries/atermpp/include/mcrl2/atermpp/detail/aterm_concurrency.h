@@ -0,0 +1,114 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/detail/aterm_concurrency.h
+/// \brief Primitives that make the term store usable from several threads.
+/// \details The term store is only thread safe if the toolset is compiled with
+///          MCRL2_ATERMPP_THREAD_SAFE defined (cmake option MCRL2_ENABLE_THREADSAFE_TERMS).
+///          Otherwise all primitives in this file compile to nothing, such that
+///          the single threaded term library does not pay for thread safety.
+
+#ifndef MCRL2_ATERMPP_DETAIL_ATERM_CONCURRENCY_H
+#define MCRL2_ATERMPP_DETAIL_ATERM_CONCURRENCY_H
+
+#include <cstddef>
+
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+#include <atomic>
+#include <mutex>
+#endif
+
+namespace atermpp
+{
+
+namespace detail
+{
+
+class _aterm;
+
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+
+/// \brief The type of reference counters of terms and function symbols.
+typedef std::atomic<size_t> reference_count_type;
+
+static_assert(sizeof(reference_count_type)==sizeof(size_t),"An atomic reference count must be as large as a size_t");
+
+/// \brief The mutex that guards the term and function symbol hashtables, the free lists and garbage collection.
+/// \details The mutex is recursive, as creation and deletion hooks, and the destruction of function symbols
+///          during garbage collection, can reenter the term store.
+std::recursive_mutex& term_store_mutex();
+
+/// \brief Scoped lock on the term store.
+class term_store_lock
+{
+  protected:
+    std::lock_guard<std::recursive_mutex> m_lock;
+
+  public:
+    term_store_lock()
+     : m_lock(term_store_mutex())
+    {}
+};
+
+/// \brief Each thread that creates terms owns one term_pin, which contains the term that has been
+///        returned most recently by this thread from the term store.
+/// \details A term that is found in, or inserted into, the hashtable can have reference count 0
+///          until the caller has wrapped it in an aterm. The pinned term is protected by the garbage
+///          collector, such that another thread cannot collect it in the meantime.
+struct term_pin
+{
+  const _aterm* term;
+
+  term_pin();
+  ~term_pin();
+};
+
+inline term_pin& thread_term_pin()
+{
+  static thread_local term_pin pin;
+  return pin;
+}
+
+/// \brief Protects t against garbage collection until this thread obtains another term.
+/// \details Must be called while the term store is locked.
+inline const _aterm* pin_term(const _aterm* t)
+{
+  thread_term_pin().term=t;
+  return t;
+}
+
+/// \brief Increases, if protect is true, or decreases the reference counts of the terms pinned by other threads.
+/// \details Used by the garbage collector, which must be called with a locked term store.
+void protect_pinned_terms(const bool protect);
+
+#else
+
+typedef size_t reference_count_type;
+
+class term_store_lock
+{
+  public:
+    term_store_lock()
+    {}
+};
+
+inline const _aterm* pin_term(const _aterm* t)
+{
+  return t;
+}
+
+inline void protect_pinned_terms(const bool)
+{}
+
+#endif // MCRL2_ATERMPP_THREAD_SAFE
+
+} // namespace detail
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_DETAIL_ATERM_CONCURRENCY_H
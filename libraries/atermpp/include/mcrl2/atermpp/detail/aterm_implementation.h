@@ -52,16 +52,32 @@ struct TermInfo
 
 extern size_t aterm_table_mask;
 extern size_t aterm_table_size;
+
+#ifdef MCRL2_ATERMPP_OPEN_ADDRESSING
+/// \brief A slot in the open addressing hashtable. The complete hash number is stored
+///        next to the term, such that terms with another hash number can be skipped
+///        without reading the term itself. A slot is empty if its term is nullptr.
+struct hashtable_slot
+{
+  HashNumber hash;
+  const _aterm* term;
+};
+
+extern hashtable_slot* aterm_hashtable;
+#else
 extern const detail::_aterm* * aterm_hashtable;
+#endif
 
 extern aterm static_undefined_aterm;  // detail/aterm_implementation.h
 extern aterm static_empty_aterm_list;
 
 extern size_t terminfo_size;
 extern size_t total_nodes_in_hashtable;
+extern size_t number_of_hashtable_resizes;
 extern TermInfo *terminfo;
 
 extern size_t garbage_collect_count_down;
+extern size_t garbage_collection_slice_size;
 
 void initialise_administration();
 void initialise_aterm_administration();
@@ -69,6 +85,7 @@ void initialise_aterm_administration();
 void resize_aterm_hashtable();
 void allocate_block(const size_t size);
 void collect_terms_with_reference_count_0();
+void collect_terms_with_reference_count_0_incrementally();
 
 void call_creation_hook(const _aterm*);
 
@@ -140,6 +157,14 @@ inline const _aterm* allocate_term(const size_t size)
     assert(size<terminfo_size);
   }
 
+#ifdef MCRL2_ATERMPP_OPEN_ADDRESSING
+  if (2*total_nodes_in_hashtable>=aterm_table_size)
+  {
+    // Linear probing requires that at least half of the slots are empty to keep sequences of
+    // occupied slots short. Resizing is necessary when the hashtable is (almost) full.
+    resize_aterm_hashtable();
+  }
+#else
   if (total_nodes_in_hashtable>=aterm_table_size)
   {
     // The hashtable is not big enough to hold nr_of_nodes_for_the_next_garbage_collect. So, resizing
@@ -147,6 +172,7 @@ inline const _aterm* allocate_term(const size_t size)
     // an arbitrary number of element, at some performance penalty.
     resize_aterm_hashtable();
   }
+#endif
 
   TermInfo& ti = terminfo[size];
   if (garbage_collect_count_down>0)
@@ -157,7 +183,14 @@ inline const _aterm* allocate_term(const size_t size)
   if (garbage_collect_count_down==0 && ti.at_freelist==nullptr) // It is time to collect free terms, and there are
                                                              // no free terms left.
   {
-    collect_terms_with_reference_count_0();
+    if (garbage_collection_slice_size==0)
+    {
+      collect_terms_with_reference_count_0();
+    }
+    else
+    {
+      collect_terms_with_reference_count_0_incrementally();
+    }
   }
   if (ti.at_freelist==nullptr)
   {
@@ -174,6 +207,123 @@ inline const _aterm* allocate_term(const size_t size)
   return at;
 }
 
+#ifdef MCRL2_ATERMPP_OPEN_ADDRESSING
+
+/// \brief The first slot in which a term with hash number hnr can be stored.
+/// \details The hash numbers of terms that are created after each other are often close to each
+///          other, which would lead to long sequences of occupied slots. Therefore the hash number
+///          is scrambled first.
+inline size_t home_position(const HashNumber hnr)
+{
+  const size_t h=hnr*static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+  return (h ^ (h>>(4*sizeof(size_t)))) & aterm_table_mask;
+}
+
+/// \brief Iterates over the terms in the hashtable with hash number hnr.
+class hashtable_cursor
+{
+  protected:
+    const HashNumber m_hnr;
+    size_t m_position;
+
+    void skip_other_hash_numbers()
+    {
+      while (aterm_hashtable[m_position].term!=nullptr && aterm_hashtable[m_position].hash!=m_hnr)
+      {
+        m_position=(m_position+1) & aterm_table_mask;
+      }
+    }
+
+  public:
+    hashtable_cursor(const HashNumber hnr)
+     : m_hnr(hnr),
+       m_position(home_position(hnr))
+    {
+      skip_other_hash_numbers();
+    }
+
+    /// \brief The current term, or nullptr if there are no more terms with hash number hnr.
+    const _aterm* term() const
+    {
+      return aterm_hashtable[m_position].term;
+    }
+
+    void next()
+    {
+      m_position=(m_position+1) & aterm_table_mask;
+      skip_other_hash_numbers();
+    }
+};
+
+inline void remove_from_hashtable(const _aterm *t)
+{
+  size_t position = home_position(hash_number(t));
+  while (aterm_hashtable[position].term!=t)
+  {
+    assert(aterm_hashtable[position].term!=nullptr); /* This only occurs if the hashtable is in error. */
+    position=(position+1) & aterm_table_mask;
+  }
+
+  /* Shift subsequent terms backwards, such that no term becomes unreachable from its home position.
+     This avoids tombstones, which would make lookups slower over time. */
+  size_t next_position=position;
+  while (true)
+  {
+    next_position=(next_position+1) & aterm_table_mask;
+    const hashtable_slot& next_slot=aterm_hashtable[next_position];
+    if (next_slot.term==nullptr)
+    {
+      break;
+    }
+    const size_t home=home_position(next_slot.hash);
+    // The term at next_position may be moved to position iff its home is not in (position, next_position].
+    if (((next_position-home) & aterm_table_mask) >= ((next_position-position) & aterm_table_mask))
+    {
+      aterm_hashtable[position]=next_slot;
+      position=next_position;
+    }
+  }
+  aterm_hashtable[position].term=nullptr;
+  total_nodes_in_hashtable--;
+}
+
+inline void insert_in_hashtable(const _aterm *t, const HashNumber hnr)
+{
+  size_t position = home_position(hnr);
+  while (aterm_hashtable[position].term!=nullptr)
+  {
+    position=(position+1) & aterm_table_mask;
+  }
+  aterm_hashtable[position].hash=hnr;
+  aterm_hashtable[position].term=t;
+  total_nodes_in_hashtable++;
+}
+
+#else
+
+/// \brief Iterates over the terms in the hashtable bucket of hash number hnr.
+class hashtable_cursor
+{
+  protected:
+    const _aterm* m_term;
+
+  public:
+    hashtable_cursor(const HashNumber hnr)
+     : m_term(aterm_hashtable[hnr & aterm_table_mask])
+    {}
+
+    /// \brief The current term, or nullptr if the end of the bucket has been reached.
+    const _aterm* term() const
+    {
+      return m_term;
+    }
+
+    void next()
+    {
+      m_term=m_term->next();
+    }
+};
+
 inline void remove_from_hashtable(const _aterm *t)
 {
   /* Remove the node from the aterm_hashtable */
@@ -203,14 +353,17 @@ inline void remove_from_hashtable(const _aterm *t)
   assert(0);
 }
 
-inline void insert_in_hashtable(const _aterm *t, const size_t hnr)
+inline void insert_in_hashtable(const _aterm *t, const HashNumber hnr)
 {
-
-  t->set_next(detail::aterm_hashtable[hnr]);
-  detail::aterm_hashtable[hnr] = t;
+  // The mask is applied here, as allocate_term may have resized the table after hnr was calculated.
+  const size_t bucket = hnr & aterm_table_mask;
+  t->set_next(aterm_hashtable[bucket]);
+  aterm_hashtable[bucket] = t;
   total_nodes_in_hashtable++;
 }
 
+#endif // MCRL2_ATERMPP_OPEN_ADDRESSING
+
 inline const _aterm* address(const aterm& t)
 {
   return t.m_term;
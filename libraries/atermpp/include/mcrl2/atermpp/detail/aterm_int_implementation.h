@@ -18,25 +18,25 @@ inline const _aterm* aterm_int(size_t val)
 {
   HashNumber hnr = COMBINE(SHIFT(addressf(function_adm.AS_INT)), val);
 
-  const _aterm* cur = aterm_hashtable[hnr & aterm_table_mask];
-  while (cur)
-  { if  (cur->function()==function_adm.AS_INT && reinterpret_cast<const _aterm_int*>(cur)->value == val)
+  term_store_lock lock;
+
+  for(hashtable_cursor i(hnr); i.term()!=nullptr; i.next())
+  {
+    const _aterm* cur=i.term();
+    if (cur->function()==function_adm.AS_INT && reinterpret_cast<const _aterm_int*>(cur)->value == val)
     {
-      return cur;
+      return pin_term(cur);
     }
-    cur = cur->next();
   }
 
-  cur = allocate_term(TERM_SIZE_INT);
-  /* Delay masking until after allocate */
-  hnr &= aterm_table_mask;
+  const _aterm* cur = allocate_term(TERM_SIZE_INT);
   new (&const_cast<_aterm *>(cur)->function()) function_symbol(function_adm.AS_INT);
   reinterpret_cast<_aterm_int*>(const_cast<_aterm *>(cur))->value = val;
 
   insert_in_hashtable(cur,hnr);
 
-  assert((hnr & aterm_table_mask) == (hash_number(cur) & aterm_table_mask));
-  return cur;
+  assert(hnr == hash_number(cur));
+  return pin_term(cur);
 }
 
 } // namespace detail
@@ -0,0 +1,86 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/detail/aterm_io_compression.h
+/// \brief Stream buffers that compress and decompress binary aterms in blocks.
+///        They are only available if the toolset is built with the cmake option
+///        MCRL2_ENABLE_COMPRESSED_TERM_FILES.
+
+#ifndef MCRL2_ATERMPP_DETAIL_ATERM_IO_COMPRESSION_H
+#define MCRL2_ATERMPP_DETAIL_ATERM_IO_COMPRESSION_H
+
+#ifdef MCRL2_ATERMPP_COMPRESSION
+
+#include <deque>
+#include <future>
+#include <streambuf>
+#include <vector>
+
+namespace atermpp
+{
+
+namespace detail
+{
+
+/// \brief A stream buffer that compresses its contents in blocks and writes them to another stream buffer.
+/// \details Each block is compressed by a separate task, such that several blocks are compressed in
+///          parallel, while the compressed blocks are written in order. A block is preceded by
+///          its compressed and uncompressed size, each four bytes; a compressed size of 0 marks
+///          the end of the stream, which is written by finish().
+class block_compressing_streambuf: public std::streambuf
+{
+  protected:
+    std::streambuf* m_target;
+    std::vector<char> m_block;
+    std::deque<std::future<std::vector<char> > > m_pending;
+    std::size_t m_maximal_number_of_pending_blocks;
+    bool m_finished;
+
+    void submit_block();
+    void write_pending_blocks(const std::size_t remaining);
+
+    int_type overflow(int_type c);
+    int sync();
+
+  public:
+    block_compressing_streambuf(std::streambuf* target, const std::size_t block_size = 1 << 20);
+
+    /// \brief Calls finish() if that has not been done yet. Errors are ignored.
+    ~block_compressing_streambuf();
+
+    /// \brief Compresses and writes the remaining contents, and writes the end of the stream.
+    /// \exception aterm_io_error if a block cannot be compressed or written.
+    void finish();
+};
+
+/// \brief A stream buffer that reads blocks written by a block_compressing_streambuf.
+/// \details While the contents of a block are being consumed, the next block is already
+///          read and decompressed by a separate task. Nothing is read beyond the end of the
+///          compressed stream.
+class block_decompressing_streambuf: public std::streambuf
+{
+  protected:
+    std::streambuf* m_source;
+    std::vector<char> m_block;
+    std::future<std::vector<char> > m_next_block;
+
+    std::future<std::vector<char> > read_block();
+
+    int_type underflow();
+
+  public:
+    block_decompressing_streambuf(std::streambuf* source);
+};
+
+} // namespace detail
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_COMPRESSION
+
+#endif // MCRL2_ATERMPP_DETAIL_ATERM_IO_COMPRESSION_H
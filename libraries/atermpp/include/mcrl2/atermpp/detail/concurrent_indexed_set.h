@@ -0,0 +1,455 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/detail/concurrent_indexed_set.h
+/// \brief Implementation of the concurrent indexed set.
+
+#ifndef MCRL2_ATERMPP_DETAIL_CONCURRENT_INDEXED_SET_H
+#define MCRL2_ATERMPP_DETAIL_CONCURRENT_INDEXED_SET_H
+
+#include <cassert>
+#include <functional>
+#include <string>
+#include <thread>
+#include "mcrl2/atermpp/concurrent_indexed_set.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace atermpp
+{
+namespace detail
+{
+
+// Returns the position of the leftmost bit that is set in n, which must be positive.
+inline std::size_t highest_bit(std::size_t n)
+{
+  assert(n>0);
+#if defined(__GNUC__) || defined(__clang__)
+  return 8*sizeof(unsigned long long)-1-__builtin_clzll(n);
+#else
+  std::size_t result=0;
+  while (n>>=1)
+  {
+    ++result;
+  }
+  return result;
+#endif
+}
+
+} // namespace detail
+
+template <class ELEMENT, class Index>
+const Index concurrent_indexed_set<ELEMENT, Index>::EMPTY;
+
+template <class ELEMENT, class Index>
+const Index concurrent_indexed_set<ELEMENT, Index>::BUSY;
+
+template <class ELEMENT, class Index>
+const Index concurrent_indexed_set<ELEMENT, Index>::MOVED;
+
+template <class ELEMENT, class Index>
+const std::size_t concurrent_indexed_set<ELEMENT, Index>::npos;
+
+template <class ELEMENT, class Index>
+concurrent_indexed_set<ELEMENT, Index>::hashtable::hashtable(const std::size_t size)
+  : mask(size-1),
+    entries(new std::atomic<Index>[size])
+{
+  assert((size & mask)==0);
+  for (std::size_t i=0; i<size; ++i)
+  {
+    entries[i].store(EMPTY, std::memory_order_relaxed);
+  }
+}
+
+template <class ELEMENT, class Index>
+inline ELEMENT& concurrent_indexed_set<ELEMENT, Index>::element(const std::size_t index) const
+{
+  // Segment s contains 2^s times as many elements as segment 0.
+  const std::size_t s=detail::highest_bit((index>>FIRST_SEGMENT_SIZE_LOG)+1);
+  const std::size_t offset=index-((((std::size_t)1<<s)-1)<<FIRST_SEGMENT_SIZE_LOG);
+  return m_segments[s].load()[offset];
+}
+
+template <class ELEMENT, class Index>
+void concurrent_indexed_set<ELEMENT, Index>::store_element(const std::size_t index, const ELEMENT& key)
+{
+  const std::size_t s=detail::highest_bit((index>>FIRST_SEGMENT_SIZE_LOG)+1);
+  if (m_segments[s].load()==nullptr)
+  {
+    ELEMENT* segment=new ELEMENT[(std::size_t)1<<(s+FIRST_SEGMENT_SIZE_LOG)];
+    ELEMENT* expected=nullptr;
+    if (!m_segments[s].compare_exchange_strong(expected, segment))
+    {
+      // Another thread allocated this segment first.
+      delete[] segment;
+    }
+  }
+  element(index)=key;
+}
+
+template <class ELEMENT, class Index>
+void concurrent_indexed_set<ELEMENT, Index>::initialise(const std::size_t initial_size)
+{
+  std::size_t size=MIGRATION_CHUNK_SIZE;
+  while (size*m_max_load<initial_size*100)
+  {
+    size=2*size;
+  }
+  m_hashtables.emplace_back(new hashtable(size));
+  m_states.emplace_back(new table_state(m_hashtables.back().get(), nullptr));
+  m_state.store(m_states.back().get());
+  m_size.store(0);
+  for (std::size_t s=0; s<NUMBER_OF_SEGMENTS; ++s)
+  {
+    m_segments[s].store(nullptr);
+  }
+}
+
+template <class ELEMENT, class Index>
+concurrent_indexed_set<ELEMENT, Index>::concurrent_indexed_set(const std::size_t initial_size, const unsigned int max_load_pct)
+  : m_max_load(max_load_pct)
+{
+  assert(0<max_load_pct && max_load_pct<100);
+  initialise(initial_size);
+}
+
+template <class ELEMENT, class Index>
+concurrent_indexed_set<ELEMENT, Index>::~concurrent_indexed_set()
+{
+  for (std::size_t s=0; s<NUMBER_OF_SEGMENTS; ++s)
+  {
+    delete[] m_segments[s].load();
+  }
+}
+
+// Looks up key in a hashtable that is being moved to a newer one, without modifying it.
+template <class ELEMENT, class Index>
+std::size_t concurrent_indexed_set<ELEMENT, Index>::find_in_previous(hashtable& table, const ELEMENT& key, const std::size_t hash) const
+{
+  for (std::size_t c=hash & table.mask; ; c=(c+1) & table.mask)
+  {
+    Index v=table.entries[c].load();
+    while (v==BUSY)
+    {
+      std::this_thread::yield();
+      v=table.entries[c].load();
+    }
+    if (v==EMPTY || v==MOVED)
+    {
+      return npos;
+    }
+    if (element(v)==key)
+    {
+      return v;
+    }
+  }
+}
+
+// Looks up key in the current hashtable. Returns false if the hashtable turns out to be
+// moved to a newer one, in which case the lookup must be retried.
+template <class ELEMENT, class Index>
+bool concurrent_indexed_set<ELEMENT, Index>::find_in_current(hashtable& table, const ELEMENT& key, const std::size_t hash, std::size_t& result) const
+{
+  for (std::size_t c=hash & table.mask; ; c=(c+1) & table.mask)
+  {
+    Index v=table.entries[c].load();
+    while (v==BUSY)
+    {
+      std::this_thread::yield();
+      v=table.entries[c].load();
+    }
+    if (v==MOVED)
+    {
+      return false;
+    }
+    if (v==EMPTY)
+    {
+      result=npos;
+      return true;
+    }
+    if (element(v)==key)
+    {
+      result=v;
+      return true;
+    }
+  }
+}
+
+// Looks up key in a hashtable that is being moved to a newer one. If key is not found, the empty
+// entry at which the search ended is marked as moved, such that no thread can insert key in this
+// hashtable anymore, and key can safely be inserted in the newer hashtable.
+template <class ELEMENT, class Index>
+std::size_t concurrent_indexed_set<ELEMENT, Index>::find_or_block_in_previous(hashtable& table, const ELEMENT& key, const std::size_t hash)
+{
+  for (std::size_t c=hash & table.mask; ; c=(c+1) & table.mask)
+  {
+    Index v=table.entries[c].load();
+    while (v==EMPTY || v==BUSY)
+    {
+      if (v==EMPTY)
+      {
+        if (table.entries[c].compare_exchange_strong(v, MOVED))
+        {
+          return npos;
+        }
+      }
+      else
+      {
+        std::this_thread::yield();
+        v=table.entries[c].load();
+      }
+    }
+    if (v==MOVED)
+    {
+      return npos;
+    }
+    if (element(v)==key)
+    {
+      return v;
+    }
+  }
+}
+
+// Inserts key in the hashtable, unless it is already there. Returns false if the hashtable turns
+// out to be moved to a newer one, in which case the insertion must be retried.
+template <class ELEMENT, class Index>
+bool concurrent_indexed_set<ELEMENT, Index>::insert(hashtable& table, const ELEMENT& key, const std::size_t hash, std::pair<std::size_t, bool>& result)
+{
+  for (std::size_t c=hash & table.mask; ; c=(c+1) & table.mask)
+  {
+    Index v=table.entries[c].load();
+    while (v==EMPTY || v==BUSY)
+    {
+      if (v==EMPTY)
+      {
+        if (table.entries[c].compare_exchange_strong(v, BUSY))
+        {
+          // This entry is reserved for key. Other threads wait until its index is known.
+          const std::size_t n=m_size.fetch_add(1);
+          if (n>=static_cast<std::size_t>(MOVED))
+          {
+            throw mcrl2::runtime_error("The number of elements in a concurrent indexed set exceeds its maximum of " + std::to_string(static_cast<std::size_t>(MOVED)) + ".");
+          }
+          store_element(n, key);
+          table.entries[c].store(static_cast<Index>(n));
+          result=std::make_pair(n, true);
+          return true;
+        }
+      }
+      else
+      {
+        std::this_thread::yield();
+        v=table.entries[c].load();
+      }
+    }
+    if (v==MOVED)
+    {
+      return false;
+    }
+    if (element(v)==key)
+    {
+      result=std::make_pair(static_cast<std::size_t>(v), false);
+      return true;
+    }
+  }
+}
+
+// Inserts an index that is moved from the previous hashtable. Its key cannot be in the table yet.
+template <class ELEMENT, class Index>
+void concurrent_indexed_set<ELEMENT, Index>::move_index(hashtable& table, const Index index)
+{
+  for (std::size_t c=std::hash<ELEMENT>()(element(index)) & table.mask; ; c=(c+1) & table.mask)
+  {
+    Index v=EMPTY;
+    if (table.entries[c].compare_exchange_strong(v, index))
+    {
+      return;
+    }
+    assert(v!=MOVED);
+  }
+}
+
+template <class ELEMENT, class Index>
+void concurrent_indexed_set<ELEMENT, Index>::migrate_chunk(table_state& state)
+{
+  const std::size_t number_of_chunks=state.number_of_chunks();
+  const std::size_t chunk=state.next_chunk.fetch_add(1);
+  if (chunk>=number_of_chunks)
+  {
+    return;
+  }
+
+  hashtable& previous=*state.previous;
+  const std::size_t end=std::min(previous.size(), (chunk+1)*MIGRATION_CHUNK_SIZE);
+  for (std::size_t c=chunk*MIGRATION_CHUNK_SIZE; c<end; ++c)
+  {
+    Index v=previous.entries[c].load();
+    while (v==EMPTY || v==BUSY)
+    {
+      if (v==EMPTY)
+      {
+        if (previous.entries[c].compare_exchange_strong(v, MOVED))
+        {
+          break;
+        }
+      }
+      else
+      {
+        std::this_thread::yield();
+        v=previous.entries[c].load();
+      }
+    }
+    if (v!=EMPTY && v!=MOVED)
+    {
+      move_index(*state.current, v);
+    }
+  }
+
+  if (state.migrated_chunks.fetch_add(1)+1==number_of_chunks)
+  {
+    finish_migration(state);
+  }
+}
+
+template <class ELEMENT, class Index>
+void concurrent_indexed_set<ELEMENT, Index>::finish_migration(table_state& state)
+{
+  std::lock_guard<std::mutex> lock(m_resize_mutex);
+  assert(m_state.load()==&state);
+  m_states.emplace_back(new table_state(state.current, nullptr));
+  m_state.store(m_states.back().get());
+}
+
+template <class ELEMENT, class Index>
+void concurrent_indexed_set<ELEMENT, Index>::resize(table_state& state)
+{
+  assert(state.previous==nullptr);
+  std::unique_lock<std::mutex> lock(m_resize_mutex, std::try_to_lock);
+  if (!lock.owns_lock() || m_state.load()!=&state)
+  {
+    // Another thread is resizing, or has already done so.
+    return;
+  }
+  m_hashtables.emplace_back(new hashtable(2*state.current->size()));
+  m_states.emplace_back(new table_state(m_hashtables.back().get(), state.current));
+  m_state.store(m_states.back().get());
+}
+
+template <class ELEMENT, class Index>
+std::pair<std::size_t, bool> concurrent_indexed_set<ELEMENT, Index>::put(const ELEMENT& key)
+{
+  const std::size_t hash=std::hash<ELEMENT>()(key);
+  while (true)
+  {
+    table_state& state=*m_state.load();
+    if (m_size.load()*100>=state.current->size()*m_max_load)
+    {
+      // The current hashtable is too full to insert elements. Start a resize, or help to finish
+      // the resize that is in progress, which must complete before the next resize can start.
+      if (state.previous==nullptr)
+      {
+        resize(state);
+      }
+      else
+      {
+        migrate_chunk(state);
+      }
+      std::this_thread::yield();
+      continue;
+    }
+
+    if (state.previous!=nullptr)
+    {
+      migrate_chunk(state);
+      const std::size_t n=find_or_block_in_previous(*state.previous, key, hash);
+      if (n!=npos)
+      {
+        return std::make_pair(n, false);
+      }
+    }
+
+    std::pair<std::size_t, bool> result;
+    if (insert(*state.current, key, hash, result))
+    {
+      return result;
+    }
+  }
+}
+
+template <class ELEMENT, class Index>
+std::size_t concurrent_indexed_set<ELEMENT, Index>::index(const ELEMENT& key) const
+{
+  const std::size_t hash=std::hash<ELEMENT>()(key);
+  while (true)
+  {
+    table_state& state=*m_state.load();
+    if (state.previous!=nullptr)
+    {
+      const std::size_t n=find_in_previous(*state.previous, key, hash);
+      if (n!=npos)
+      {
+        return n;
+      }
+    }
+
+    std::size_t result;
+    if (find_in_current(*state.current, key, hash, result))
+    {
+      return result;
+    }
+  }
+}
+
+template <class ELEMENT, class Index>
+void concurrent_indexed_set<ELEMENT, Index>::release_retired_tables()
+{
+  while (m_state.load()->previous!=nullptr)
+  {
+    migrate_chunk(*m_state.load());
+  }
+
+  hashtable* current=m_state.load()->current;
+  for (std::unique_ptr<hashtable>& t: m_hashtables)
+  {
+    if (t.get()==current)
+    {
+      std::swap(t, m_hashtables.front());
+    }
+  }
+  m_hashtables.resize(1);
+  std::swap(m_states.back(), m_states.front());
+  m_states.resize(1);
+}
+
+template <class ELEMENT, class Index>
+void concurrent_indexed_set<ELEMENT, Index>::clear()
+{
+  for (std::size_t s=0; s<NUMBER_OF_SEGMENTS; ++s)
+  {
+    delete[] m_segments[s].load();
+  }
+  m_hashtables.clear();
+  m_states.clear();
+  initialise(0);
+}
+
+template <class ELEMENT, class Index>
+std::size_t concurrent_indexed_set<ELEMENT, Index>::hashtable_memory_in_bytes() const
+{
+  std::lock_guard<std::mutex> lock(m_resize_mutex);
+  std::size_t result=0;
+  for (const std::unique_ptr<hashtable>& t: m_hashtables)
+  {
+    result=result+t->size()*sizeof(std::atomic<Index>);
+  }
+  return result;
+}
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_DETAIL_CONCURRENT_INDEXED_SET_H
@@ -2,6 +2,7 @@
 #define DETAIL_FUNCTION_SYMBOL_H
 
 #include <string>
+#include "mcrl2/atermpp/detail/aterm_concurrency.h"
 
 const size_t FUNCTION_SYMBOL_BLOCK_CLASS=14;
 const size_t FUNCTION_SYMBOL_BLOCK_SIZE=1<<FUNCTION_SYMBOL_BLOCK_CLASS;
@@ -22,7 +23,7 @@ struct _function_symbol
 {
     size_t arity;
     _function_symbol* next;
-    mutable size_t reference_count;
+    mutable reference_count_type reference_count;
     std::string name;
     size_t number;
 }; 
@@ -38,6 +39,12 @@ bool is_valid_function_symbol(const detail::_function_symbol* f)
   return (f->reference_count>0) && check_that_the_function_symbol_points_to_memory_containing_a_function(f);
 }
 
+// Make room for n function symbols on top of the ones that exist, such that the
+// administration does not need to be extended while they are created. This is
+// useful when the number of function symbols is known in advance, e.g., from the
+// header of a file.
+extern void reserve_function_symbols(const size_t n);
+
 // set index such that no function symbol exists with the name 'prefix + std::to_string(n)'
 // for all values n >= index
 extern size_t get_sufficiently_large_postfix_index(const std::string& prefix_);
@@ -68,9 +75,17 @@ struct index_increaser
     return *this;
   }
 
+  bool operator==(const index_increaser& other) const
+  {
+    return m_index==other.m_index;
+  }
+
   void operator ()(size_t new_index)
   {
-    *m_initial_index=new_index;
+    if (*m_initial_index<new_index)
+    {
+      *m_initial_index=new_index;
+    }
     if (*m_index<new_index)
     {
       *m_index=new_index;
@@ -78,12 +93,17 @@ struct index_increaser
   }
 };
 
+// The administration of a prefix for which function symbols are generated. It
+// is defined in function_symbol.cpp.
+struct prefix_administration;
+
 // register a prefix for a function symbol, such that the index of this prefix can be increased when
-// some other process makes a function symbol with the same prefix.
-extern void register_function_symbol_prefix_string(const std::string& prefix, index_increaser& increase_index);
+// some other process makes a function symbol with the same prefix. The administration of the prefix
+// is returned, which must be passed to the function symbols that are generated with this prefix.
+extern prefix_administration& register_function_symbol_prefix_string(const std::string& prefix, index_increaser& increase_index);
 
 // deregister a prefix for a function symbol.
-extern void deregister_function_symbol_prefix_string(const std::string& prefix);
+extern void deregister_function_symbol_prefix_string(const std::string& prefix, const index_increaser& increase_index);
 
 } // namespace detail
 } // namespace atermpp
@@ -0,0 +1,140 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/detail/index_table.h
+/// \brief The hashtable of an indexed set, which stores its indices in
+///        32 bits as long as they fit.
+
+#ifndef MCRL2_ATERMPP_DETAIL_INDEX_TABLE_H
+#define MCRL2_ATERMPP_DETAIL_INDEX_TABLE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace atermpp
+{
+namespace detail
+{
+
+/* in the hashtable we use the following constants to
+   indicate designated positions */
+static const size_t EMPTY(-1);
+static const size_t DELETED(-2);
+
+/* their counterparts in a table with 32 bit entries */
+static const std::uint32_t COMPACT_EMPTY(-1);
+static const std::uint32_t COMPACT_DELETED(-2);
+
+/// \brief A table of indices, in which the constants EMPTY and DELETED can be stored as well.
+/// \details As long as all stored indices are smaller than 2^32-2, the table uses 32 bits per
+///          entry. When a larger index is stored, the table is widened to a size_t per entry.
+///          For tables with many entries this halves the memory that is needed in practice.
+class index_table
+{
+  protected:
+    std::vector<std::uint32_t> m_compact_table;
+    std::vector<size_t> m_wide_table;
+    bool m_is_wide;
+
+    static size_t widen(const std::uint32_t v)
+    {
+      if (v>=COMPACT_DELETED)
+      {
+        return v==COMPACT_EMPTY?EMPTY:DELETED;
+      }
+      return v;
+    }
+
+    static std::uint32_t narrow(const size_t v)
+    {
+      if (v>=DELETED)
+      {
+        return v==EMPTY?COMPACT_EMPTY:COMPACT_DELETED;
+      }
+      assert(v<COMPACT_DELETED);
+      return static_cast<std::uint32_t>(v);
+    }
+
+    void make_wide()
+    {
+      m_wide_table.resize(m_compact_table.size());
+      for(size_t i=0; i<m_compact_table.size(); ++i)
+      {
+        m_wide_table[i]=widen(m_compact_table[i]);
+      }
+      m_compact_table=std::vector<std::uint32_t>();
+      m_is_wide=true;
+    }
+
+  public:
+    /// \brief Constructor. All entries are EMPTY.
+    index_table(const size_t size=0)
+     : m_compact_table(size,COMPACT_EMPTY),
+       m_is_wide(false)
+    {}
+
+    size_t size() const
+    {
+      return m_is_wide?m_wide_table.size():m_compact_table.size();
+    }
+
+    size_t operator[](const size_t i) const
+    {
+      return m_is_wide?m_wide_table[i]:widen(m_compact_table[i]);
+    }
+
+    /// \brief Sets entry i to v, which is an index, EMPTY or DELETED.
+    void set(const size_t i, const size_t v)
+    {
+      if (m_is_wide)
+      {
+        m_wide_table[i]=v;
+        return;
+      }
+      if (v<DELETED && v>=COMPACT_DELETED)
+      {
+        make_wide();
+        m_wide_table[i]=v;
+        return;
+      }
+      m_compact_table[i]=narrow(v);
+    }
+
+    /// \brief Resizes the table to size entries, which are all EMPTY.
+    /// \details A widened table remains wide.
+    void assign(const size_t size)
+    {
+      if (m_is_wide)
+      {
+        m_wide_table.assign(size,EMPTY);
+      }
+      else
+      {
+        m_compact_table.assign(size,COMPACT_EMPTY);
+      }
+    }
+
+    /// \brief Returns true if the entries are stored in a size_t each.
+    bool is_wide() const
+    {
+      return m_is_wide;
+    }
+
+    /// \brief The number of bytes occupied by the entries.
+    size_t memory_in_bytes() const
+    {
+      return m_is_wide?m_wide_table.capacity()*sizeof(size_t):m_compact_table.capacity()*sizeof(std::uint32_t);
+    }
+};
+
+} // namespace detail
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_DETAIL_INDEX_TABLE_H
@@ -24,12 +24,6 @@ namespace detail
 
 static const size_t STEP = 1; /* The position on which the next hash entry //searched */
 
-
-/* in the hashtable we use the following constants to
-   indicate designated positions */
-static const size_t EMPTY(-1);
-static const size_t DELETED(-2);
-
 inline size_t approximatepowerof2(size_t n)
 {
   size_t mask = n;
@@ -83,11 +77,11 @@ size_t indexed_set<ELEMENT>::put_in_hashtable(const ELEMENT& key, size_t n)
       { 
         --nr_of_insertions_until_next_rehash;
         assert(nr_of_insertions_until_next_rehash!=npos);
-        hashtable[c] = n;
+        hashtable.set(c, n);
       }
       else
       { 
-        hashtable[deleted_position] = n;
+        hashtable.set(deleted_position, n);
       }
       return n;
     }
@@ -129,8 +123,7 @@ inline void indexed_set<ELEMENT>::resize_hashtable()
 
   size_t newsizeMinus1 = detail::calculateNewSize(sizeMinus1,largest_used_index, max_load);
 
-  hashtable.clear();
-  hashtable.resize(newsizeMinus1+1,detail::EMPTY); 
+  hashtable.assign(newsizeMinus1+1);
 
   sizeMinus1=newsizeMinus1;
   nr_of_insertions_until_next_rehash = ((sizeMinus1/100)*max_load);
@@ -162,7 +155,7 @@ inline indexed_set<ELEMENT>::indexed_set(size_t initial_size /* = 100 */, unsign
       : sizeMinus1(detail::approximatepowerof2(initial_size)),
         max_load(max_load_pct),
         nr_of_insertions_until_next_rehash(((sizeMinus1/100)*max_load)),
-        hashtable(std::vector<size_t>(1+sizeMinus1,detail::EMPTY))
+        hashtable(1+sizeMinus1)
 {
 }
 
@@ -220,7 +213,7 @@ bool indexed_set<ELEMENT>::erase(const ELEMENT& key)
     }
   }
 
-  hashtable[c] = detail::DELETED;
+  hashtable.set(c, detail::DELETED);
 
   assert(m_keys.size()>v);
   assert(!ELEMENT().defined());
@@ -248,7 +241,7 @@ inline bool indexed_set<ELEMENT>::defined(size_t index) const
 template <class ELEMENT>
 inline void indexed_set<ELEMENT>::clear()
 {
-  hashtable.assign(sizeMinus1+1,detail::EMPTY);
+  hashtable.assign(sizeMinus1+1);
   m_keys.clear();
   free_positions=std::stack<size_t>();
 }
@@ -50,11 +50,12 @@ class function_symbol
     }
 
     /// A special function symbol constructor for use in the function symbol
-    /// generator. This constructor assumes that the name and arity combination
-    /// does not exist yet, and that the prefix and number combination is neatly
-    /// recoreded in the appropriate number generator as being used. Furthermore,
-    /// it takes a pointer to a char* to represent its string.
-    function_symbol(const char* name_begin, const char* name_end, const size_t arity_);
+    /// generator. The name consists of the prefix of the generator followed by
+    /// the number index, and it is represented by a range of chars. The name
+    /// is not checked against the registered prefixes, but index is recorded as
+    /// being used in the administration of the prefix.
+    function_symbol(const char* name_begin, const char* name_end, const size_t arity_,
+                    detail::prefix_administration& prefix, const size_t index);
 
 
   public:
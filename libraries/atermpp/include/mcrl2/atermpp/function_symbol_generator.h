@@ -29,6 +29,7 @@ class function_symbol_generator
     size_t m_initial_index; // cache the value that is set in the constructor
     size_t m_index;
     std::unique_ptr<char[]> m_string_buffer;
+    detail::prefix_administration* m_prefix_administration;
 
   public:
     /// \brief Constructor
@@ -46,9 +47,9 @@ class function_symbol_generator
       // set m_index such that no function symbol exists with the name 'prefix + std::to_string(n)'
       // for all values n >= m_index
       m_index = detail::get_sufficiently_large_postfix_index(prefix);
-      detail::index_increaser increase_m_index(m_initial_index,m_index);
-      detail::register_function_symbol_prefix_string(prefix,increase_m_index);
       m_initial_index = m_index;
+      detail::index_increaser increase_m_index(m_initial_index,m_index);
+      m_prefix_administration = &detail::register_function_symbol_prefix_string(prefix,increase_m_index);
     }
 
     /// \brief Restores the index back to the value that was initially assigned in the constructor.
@@ -59,7 +60,7 @@ class function_symbol_generator
 
     ~function_symbol_generator()
     {
-      detail::deregister_function_symbol_prefix_string(m_prefix);
+      detail::deregister_function_symbol_prefix_string(m_prefix,detail::index_increaser(m_initial_index,m_index));
     }
 
     /// \brief Generates a unique function symbol with the given prefix followed by a number.
@@ -68,7 +69,7 @@ class function_symbol_generator
       // Put the number m_index after the prefix in the string buffer.
       char* end = mcrl2::utilities::number2string(m_index, &m_string_buffer[m_prefix.size()]);
       m_index++;
-      return function_symbol(&m_string_buffer[0], end, arity);
+      return function_symbol(&m_string_buffer[0], end, arity, *m_prefix_administration, m_index-1);
     }
 };
 
@@ -0,0 +1,75 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/garbage_collection.h
+/// \brief Control over, and statistics of, the garbage collector of the term library.
+
+#ifndef MCRL2_ATERMPP_GARBAGE_COLLECTION_H
+#define MCRL2_ATERMPP_GARBAGE_COLLECTION_H
+
+#include <cstddef>
+#include <iostream>
+
+namespace atermpp
+{
+
+/// \brief Statistics about the garbage collections that took place.
+/// \details Times are wall clock times in seconds.
+struct garbage_collection_statistics
+{
+  /// \brief The number of complete garbage collections.
+  size_t number_of_collections;
+
+  /// \brief The number of slices of the incremental garbage collector.
+  size_t number_of_slices;
+
+  /// \brief The number of terms that were put back in the free lists.
+  size_t number_of_reclaimed_terms;
+
+  /// \brief The total time spent collecting garbage.
+  double total_time;
+
+  /// \brief The longest time that a single collection or slice took.
+  double maximal_pause;
+
+  garbage_collection_statistics()
+   : number_of_collections(0),
+     number_of_slices(0),
+     number_of_reclaimed_terms(0),
+     total_time(0.0),
+     maximal_pause(0.0)
+  {}
+};
+
+/// \brief Sets the garbage collector to incremental mode.
+/// \details In incremental mode each garbage collection inspects at most blocks_per_slice
+///          blocks of terms, continuing where the previous slice stopped. The work is amortised
+///          over term allocations, and the pause times are bounded by the size of a slice instead
+///          of the size of the whole term store. Blocks that became empty are kept for reuse; they
+///          are only returned to the operating system by a complete garbage collection.
+///          If blocks_per_slice is 0, all garbage is collected at once, which is the default.
+/// \param blocks_per_slice The number of blocks that are inspected in one garbage collection.
+void set_incremental_garbage_collection(const size_t blocks_per_slice);
+
+/// \brief Returns the statistics of the garbage collections up till now.
+const garbage_collection_statistics& get_garbage_collection_statistics();
+
+/// \brief Prints garbage collection statistics.
+inline
+std::ostream& operator<<(std::ostream& out, const garbage_collection_statistics& s)
+{
+  return out << "garbage collections: " << s.number_of_collections
+             << ", incremental slices: " << s.number_of_slices
+             << ", reclaimed terms: " << s.number_of_reclaimed_terms
+             << ", total time: " << s.total_time << "s"
+             << ", maximal pause: " << s.maximal_pause << "s";
+}
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_GARBAGE_COLLECTION_H
@@ -16,6 +16,7 @@
 #include <stack>
 #include <cassert>
 #include "mcrl2/atermpp/detail/aterm_implementation.h"
+#include "mcrl2/atermpp/detail/index_table.h"
 
 namespace atermpp
 {
@@ -28,7 +29,7 @@ class indexed_set
     size_t sizeMinus1;
     unsigned int max_load;
     size_t nr_of_insertions_until_next_rehash;
-    std::vector<size_t> hashtable;
+    detail::index_table hashtable;
     std::deque <ELEMENT > m_keys;
     std::stack < size_t > free_positions; 
 
@@ -118,6 +119,14 @@ class indexed_set
     {
       return m_keys.size()-free_positions.size();
     }
+
+    /// \brief Returns the number of bytes used by the hashtable of the set.
+    /// \details As long as fewer than 2^32-2 indices are in use, the hashtable uses
+    ///          32 bits per entry. It is widened automatically if more indices are needed.
+    std::size_t hashtable_memory_in_bytes() const
+    {
+      return hashtable.memory_in_bytes();
+    }
 };
 
 } // namespace atermpp
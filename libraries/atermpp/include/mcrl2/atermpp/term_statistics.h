@@ -0,0 +1,91 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/term_statistics.h
+/// \brief Statistics about the memory used by the term library.
+
+#ifndef MCRL2_ATERMPP_TERM_STATISTICS_H
+#define MCRL2_ATERMPP_TERM_STATISTICS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "mcrl2/atermpp/garbage_collection.h"
+
+namespace atermpp
+{
+
+/// \brief The terms in the term store with a particular function symbol.
+struct function_symbol_statistics
+{
+  std::string name;
+  size_t arity;
+
+  /// \brief The number of terms with a positive reference count.
+  size_t referenced_terms;
+
+  /// \brief The number of terms with reference count 0, that are not yet garbage collected.
+  size_t unreferenced_terms;
+
+  /// \brief The number of bytes occupied by all these terms.
+  size_t bytes;
+};
+
+/// \brief The blocks in the term store holding terms of a particular size.
+struct size_class_statistics
+{
+  /// \brief The size of the terms in this class, in machine words.
+  size_t term_size;
+  size_t number_of_blocks;
+  size_t referenced_terms;
+  size_t unreferenced_terms;
+
+  /// \brief The number of terms in the free list.
+  size_t free_terms;
+
+  /// \brief The number of bytes occupied by the blocks of this class.
+  size_t bytes;
+};
+
+/// \brief A snapshot of the term store.
+struct term_statistics
+{
+  /// \brief Statistics per function symbol, ordered by decreasing number of bytes.
+  std::vector<function_symbol_statistics> function_symbols;
+
+  /// \brief Statistics per size class, ordered by term size. Classes without blocks are omitted.
+  std::vector<size_class_statistics> size_classes;
+
+  size_t hashtable_size;
+  size_t terms_in_hashtable;
+
+  /// \brief The number of buckets (chained hashtable) or sequences of consecutive
+  ///        occupied slots (open addressing hashtable) that contain terms.
+  size_t number_of_chains;
+
+  /// \brief The length of the longest bucket or sequence of occupied slots.
+  size_t longest_chain;
+
+  /// \brief The number of times the hashtable has been enlarged.
+  size_t number_of_hashtable_resizes;
+
+  garbage_collection_statistics garbage_collection;
+};
+
+/// \brief Collects statistics about the term store.
+/// \details This inspects every term in the store, so its complexity is linear in the size of the store.
+term_statistics get_term_statistics();
+
+/// \brief Prints statistics about the term store.
+/// \param out The stream to which the statistics are written.
+/// \param number_of_function_symbols The number of function symbols using the most memory that are listed.
+void print_term_statistics(std::ostream& out, const size_t number_of_function_symbols = 20);
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_TERM_STATISTICS_H
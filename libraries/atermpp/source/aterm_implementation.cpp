@@ -8,6 +8,7 @@
 #include <string.h>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 
 
 #include "mcrl2/utilities/logger.h"
@@ -15,6 +16,9 @@
 #include "mcrl2/atermpp/detail/aterm_implementation.h"
 #include "mcrl2/atermpp/detail/aterm_int.h"
 #include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/garbage_collection.h"
+#include "mcrl2/atermpp/term_statistics.h"
+#include "mcrl2/utilities/tool_statistics.h"
 
 
 #ifdef DMALLOC
@@ -82,7 +86,11 @@ static const size_t INITIAL_MAX_TERM_SIZE = 16;
 
 size_t aterm_table_size=INITIAL_TERM_TABLE_SIZE;
 size_t aterm_table_mask=INITIAL_TERM_TABLE_SIZE-1;
+#ifdef MCRL2_ATERMPP_OPEN_ADDRESSING
+hashtable_slot* aterm_hashtable;
+#else
 const _aterm* * aterm_hashtable;
+#endif
 
 aterm static_undefined_aterm;
 aterm static_empty_aterm_list(aterm_appl(detail::function_adm.AS_EMPTY_LIST));
@@ -93,6 +101,112 @@ size_t garbage_collect_count_down=0;
 TermInfo *terminfo;
 
 size_t total_nodes_in_hashtable = 0;
+size_t number_of_hashtable_resizes = 0;
+
+// The number of blocks that one slice of the incremental garbage collector inspects.
+// If 0, garbage is collected by inspecting all blocks at once.
+size_t garbage_collection_slice_size=0;
+
+// The size and the block at which the next slice of the incremental garbage collector starts.
+static size_t incremental_collection_size=TERM_SIZE;
+static Block* incremental_collection_block=nullptr;
+
+static size_t total_number_of_blocks=0;
+
+static garbage_collection_statistics gc_statistics;
+
+static void print_term_statistics_with_default_length(std::ostream& out)
+{
+  print_term_statistics(out);
+}
+
+// Makes the statistics of the term store available to all tools, see the option --term-stats.
+// This is done here and not in term_statistics.cpp, such that it also happens when linking statically.
+static const bool term_statistics_printer_is_registered=
+  (mcrl2::utilities::term_statistics_printer()=print_term_statistics_with_default_length, true);
+
+// Allows all tools to make the garbage collector incremental, see the option --gc-slice.
+static const bool incremental_garbage_collection_configurator_is_registered=
+  (mcrl2::utilities::incremental_garbage_collection_configurator()=set_incremental_garbage_collection, true);
+
+// Measures the duration of a garbage collection and records it in gc_statistics.
+class garbage_collection_timer
+{
+  protected:
+    std::chrono::steady_clock::time_point m_start;
+
+  public:
+    garbage_collection_timer(const bool is_incremental)
+     : m_start(std::chrono::steady_clock::now())
+    {
+      if (is_incremental)
+      {
+        gc_statistics.number_of_slices++;
+      }
+      else
+      {
+        gc_statistics.number_of_collections++;
+      }
+    }
+
+    ~garbage_collection_timer()
+    {
+      const double pause=std::chrono::duration<double>(std::chrono::steady_clock::now()-m_start).count();
+      gc_statistics.total_time+=pause;
+      gc_statistics.maximal_pause=std::max(gc_statistics.maximal_pause,pause);
+    }
+};
+
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+// The mutex and the list of pins are never destroyed, as terms and function symbols
+// may still be freed during the destruction of static objects.
+std::recursive_mutex& term_store_mutex()
+{
+  static std::recursive_mutex* mutex=new std::recursive_mutex();
+  return *mutex;
+}
+
+static std::vector<term_pin*>& term_pins()
+{
+  static std::vector<term_pin*>* pins=new std::vector<term_pin*>();
+  return *pins;
+}
+
+term_pin::term_pin()
+ : term(nullptr)
+{
+  term_store_lock lock;
+  term_pins().push_back(this);
+}
+
+term_pin::~term_pin()
+{
+  term_store_lock lock;
+  std::vector<term_pin*>& pins=term_pins();
+  pins.erase(std::find(pins.begin(),pins.end(),this));
+}
+
+void protect_pinned_terms(const bool protect)
+{
+  // The thread that collects garbage has wrapped all terms it obtained in aterms,
+  // so its own pin does not need protection.
+  const term_pin* own_pin=&thread_term_pin();
+  for(const term_pin* pin: term_pins())
+  {
+    if (pin!=own_pin && pin->term!=nullptr)
+    {
+      if (protect)
+      {
+        pin->term->increase_reference_count();
+      }
+      else
+      {
+        pin->term->decrease_reference_count();
+      }
+    }
+  }
+}
+#endif
 
 void call_creation_hook(const detail::_aterm* term)
 {
@@ -123,6 +237,7 @@ void free_term_aux(const detail::_aterm* t, const detail::_aterm*& terms_to_be_r
   assert(t->reference_count()==0);
 
   call_deletion_hook(t);
+  gc_statistics.number_of_reclaimed_terms++;
 
   const function_symbol &f=t->function();
   const size_t arity=f.arity();
@@ -169,6 +284,43 @@ void free_term(const detail::_aterm* t)
 }
 
 
+#ifdef MCRL2_ATERMPP_OPEN_ADDRESSING
+void resize_aterm_hashtable()
+{
+  const size_t old_size=aterm_table_size;
+  hashtable_slot* const old_hashtable=aterm_hashtable;
+  hashtable_slot* new_hashtable=reinterpret_cast<hashtable_slot*>(calloc(2*old_size,sizeof(hashtable_slot)));
+
+  if (new_hashtable==nullptr)
+  {
+    // Contrary to a chained hashtable, an open addressing hashtable cannot contain more
+    // terms than it has slots.
+    if (total_nodes_in_hashtable+1<old_size)
+    {
+      mCRL2log(mcrl2::log::warning) << "could not resize hashtable to size " << 2*old_size << ". ";
+      return;
+    }
+    throw std::runtime_error("Out of memory. Cannot resize the aterm hashtable.");
+  }
+  aterm_table_size=2*old_size;
+  aterm_table_mask=aterm_table_size-1;
+  aterm_hashtable=new_hashtable;
+
+  /*  Rehash all old elements. The stored hash numbers make it unnecessary to access the terms. */
+  total_nodes_in_hashtable=0;
+  for (size_t p=0; p<old_size; ++p)
+  {
+    if (old_hashtable[p].term!=nullptr)
+    {
+      assert(!old_hashtable[p].term->reference_count_indicates_is_in_freelist());
+      insert_in_hashtable(old_hashtable[p].term,old_hashtable[p].hash);
+    }
+  }
+  free(old_hashtable);
+  number_of_hashtable_resizes++;
+  mCRL2log(mcrl2::log::debug) << "resized the term hashtable to " << aterm_table_size << " slots.\n";
+}
+#else
 void resize_aterm_hashtable()
 {
   static bool resizing_aterm_hashtable_has_failed=false;
@@ -213,13 +365,19 @@ void resize_aterm_hashtable()
   }
   free(aterm_hashtable);
   aterm_hashtable=new_hashtable;
+  number_of_hashtable_resizes++;
+  mCRL2log(mcrl2::log::debug) << "resized the term hashtable to " << aterm_table_size << " buckets.\n";
 }
+#endif
 
 void collect_terms_with_reference_count_0()
 {
   // This function puts all with reference count==0 in the freelist, in the reverse order as
   // the sequence of blocks.
+  garbage_collection_timer timer(false);
 
+  // Terms that other threads are about to protect must survive this garbage collection.
+  protect_pinned_terms(true);
 
   // First put all terms with reference count 0 in the freelist.
   for(size_t size=TERM_SIZE; size<terminfo_size; ++size)
@@ -289,6 +447,49 @@ void collect_terms_with_reference_count_0()
     }
   }
   garbage_collect_count_down=(1+number_of_blocks)*(BLOCK_SIZE/(sizeof(size_t)*16));
+  total_number_of_blocks=number_of_blocks;
+
+  // Blocks may have been freed, so the incremental collector starts anew.
+  incremental_collection_size=TERM_SIZE;
+  incremental_collection_block=nullptr;
+  protect_pinned_terms(false);
+}
+
+void collect_terms_with_reference_count_0_incrementally()
+{
+  // Terms with reference count 0 in the next garbage_collection_slice_size blocks are put in the freelists,
+  // together with their subterms that become unreferenced. The freelists are not rebuilt and no
+  // blocks are freed, such that the duration of a slice does not depend on the size of the term store.
+  garbage_collection_timer timer(true);
+  protect_pinned_terms(true);
+
+  size_t blocks_to_visit=std::min(garbage_collection_slice_size,total_number_of_blocks);
+  while (blocks_to_visit>0)
+  {
+    if (incremental_collection_block==nullptr)
+    {
+      // Continue with the blocks of the next size, and wrap around after the largest size.
+      incremental_collection_size=(incremental_collection_size+1<terminfo_size?incremental_collection_size+1:TERM_SIZE);
+      incremental_collection_block=terminfo[incremental_collection_size].at_block;
+      continue;
+    }
+
+    const size_t size=incremental_collection_size;
+    Block* b=incremental_collection_block;
+    for(size_t *p=b->data; p<b->end; p=p+size)
+    {
+      const _aterm* p1=reinterpret_cast<_aterm*>(p);
+      if (p1->reference_count()==0)
+      {
+        free_term(p1);
+      }
+    }
+    incremental_collection_block=b->next_by_size;
+    blocks_to_visit--;
+  }
+
+  garbage_collect_count_down=garbage_collection_slice_size*(BLOCK_SIZE/(sizeof(size_t)*16));
+  protect_pinned_terms(false);
 }
 
 #ifdef MCRL2_CHECK_ATERMPP_CLEANUP
@@ -360,7 +561,11 @@ void initialise_aterm_administration()
    * the first time, which may be due to the initialisation of a global variable in a .cpp file, or
    * due to the initialisation of a pre-main initialisation of a static variable, which some
    * compilers do. */
+#ifdef MCRL2_ATERMPP_OPEN_ADDRESSING
+  aterm_hashtable=reinterpret_cast<hashtable_slot*>(calloc(aterm_table_size,sizeof(hashtable_slot)));
+#else
   aterm_hashtable=reinterpret_cast<const _aterm**>(calloc(aterm_table_size,sizeof(_aterm*)));
+#endif
   if (aterm_hashtable==nullptr)
   {
     throw std::runtime_error("Out of memory. Cannot create an aterm symbol hashtable.");
@@ -429,11 +634,22 @@ void allocate_block(const size_t size)
 
   newblock->next_by_size = ti.at_block;
   ti.at_block = newblock;
+  total_number_of_blocks++;
   assert(ti.at_block != nullptr);
   assert(ti.at_freelist != nullptr);
 }
 
 } // namespace detail
 
-} // namespace atermpp
+void set_incremental_garbage_collection(const size_t blocks_per_slice)
+{
+  detail::term_store_lock lock;
+  detail::garbage_collection_slice_size=blocks_per_slice;
+}
 
+const garbage_collection_statistics& get_garbage_collection_statistics()
+{
+  return detail::gc_statistics;
+}
+
+} // namespace atermpp
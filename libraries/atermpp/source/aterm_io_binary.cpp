@@ -16,6 +16,7 @@
 #include "mcrl2/atermpp/detail/utility.h"
 #include "mcrl2/atermpp/aterm_int.h"
 #include "mcrl2/atermpp/detail/aterm_io_implementation.h"
+#include "mcrl2/atermpp/detail/aterm_io_compression.h"
 #include "mcrl2/utilities/exception.h"
 #include "mcrl2/utilities/logger.h"
 
@@ -140,6 +141,19 @@ static size_t AT_calcUniqueAFuns(const aterm& t, std::vector<size_t>& count)
 
 static const size_t BAF_MAGIC = 0xbaf;
 
+// The magic number of a container of terms in binary aterm format, see aterm_io_indexed.cpp.
+static const size_t INDEXED_BAF_MAGIC = 0x1baf;
+
+// The magic number of a binary aterm stream that is compressed in blocks, see aterm_io_compression.cpp.
+// It is followed by the compressed blocks, which contain an ordinary binary aterm stream.
+static const size_t COMPRESSED_BAF_MAGIC = 0x2baf;
+
+#ifdef MCRL2_ATERMPP_COMPRESSION
+static bool compress_binary_aterms = true;
+#else
+static bool compress_binary_aterms = false;
+#endif
+
 // The BAF_VERSION constant is the version number of the ATerms written in BAF
 // format. As of 29 August 2013 this version number is used by the mCRL2
 // toolset. Whenever the file format of mCRL2 files is changed, the BAF_VERSION
@@ -831,12 +845,51 @@ write_baf(const aterm& t, ostream& os)
 void write_term_to_binary_stream(const aterm& t, std::ostream& os)
 {
   aterm_io_init(os);
+#ifdef MCRL2_ATERMPP_COMPRESSION
+  if (compress_binary_aterms)
+  {
+    writeInt(0, os);
+    writeInt(COMPRESSED_BAF_MAGIC, os);
+    detail::block_compressing_streambuf buffer(os.rdbuf());
+    std::ostream compressed(&buffer);
+    const bool written=write_baf(t, compressed);
+    buffer.finish();
+    if (!written || !os.good())
+    {
+      throw aterm_io_error("Fail to write term to string");
+    }
+    return;
+  }
+#endif
   if (!write_baf(t, os))
   {
     throw aterm_io_error("Fail to write term to string");
   }
 }
 
+bool binary_aterm_compression_is_available()
+{
+#ifdef MCRL2_ATERMPP_COMPRESSION
+  return true;
+#else
+  return false;
+#endif
+}
+
+void set_binary_aterm_compression(const bool enable)
+{
+  if (enable && !binary_aterm_compression_is_available())
+  {
+    throw aterm_io_error("Compression of binary aterms is not available; the toolset must be built with MCRL2_ENABLE_COMPRESSED_TERM_FILES.");
+  }
+  compress_binary_aterms=enable;
+}
+
+bool binary_aterm_compression()
+{
+  return compress_binary_aterms;
+}
+
 /**
   * Read a single symbol from file.
   */
@@ -1070,6 +1123,20 @@ aterm read_baf(istream& is)
   {
     val = readInt(is);
   }
+  if (val == COMPRESSED_BAF_MAGIC)
+  {
+#ifdef MCRL2_ATERMPP_COMPRESSION
+    detail::block_decompressing_streambuf buffer(is.rdbuf());
+    std::istream decompressed(&buffer);
+    return read_baf(decompressed);
+#else
+    throw aterm_io_error("read_baf: this binary aterm stream is compressed, which requires a toolset built with MCRL2_ENABLE_COMPRESSED_TERM_FILES.");
+#endif
+  }
+  if (val == INDEXED_BAF_MAGIC)
+  {
+    throw aterm_io_error("read_baf: this is an indexed binary aterm file, whose sections must be read using an indexed_binary_aterm_file.");
+  }
   if (val != BAF_MAGIC)
   {
     throw aterm_io_error("read_baf: error reading BAF_MAGIC!");
@@ -1084,8 +1151,9 @@ aterm read_baf(istream& is)
   nr_unique_symbols = readInt(is);
   /* std::size_t nr_unique_terms = */ readInt(is);
 
-  // Allocate symbol space
+  // Allocate symbol space, and make room for the symbols in the function symbol table in one go.
   read_symbols = std::vector<sym_read_entry>(nr_unique_symbols);
+  detail::reserve_function_symbols(nr_unique_symbols);
 
   if (!read_all_symbols(is))
   {
@@ -0,0 +1,210 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file aterm_io_compression.cpp
+/// \brief Block compression of binary aterm streams, using zlib.
+
+#ifdef MCRL2_ATERMPP_COMPRESSION
+
+#include <algorithm>
+#include <thread>
+#include <zlib.h>
+
+#include "mcrl2/atermpp/aterm_io.h"
+#include "mcrl2/atermpp/detail/aterm_io_compression.h"
+
+namespace atermpp
+{
+
+namespace detail
+{
+
+static const std::size_t BLOCK_HEADER_SIZE = 8;
+
+// Speed matters more than the compression ratio, as the blocks are written while a tool is running.
+static const int COMPRESSION_LEVEL = Z_BEST_SPEED;
+
+static void write_uint32(std::size_t n, char* p)
+{
+  for(std::size_t i=0; i<4; ++i)
+  {
+    p[i]=static_cast<char>(n & 0xff);
+    n=n>>8;
+  }
+}
+
+static std::size_t read_uint32(const char* p)
+{
+  return static_cast<std::size_t>(static_cast<unsigned char>(p[0])) |
+         static_cast<std::size_t>(static_cast<unsigned char>(p[1]))<<8 |
+         static_cast<std::size_t>(static_cast<unsigned char>(p[2]))<<16 |
+         static_cast<std::size_t>(static_cast<unsigned char>(p[3]))<<24;
+}
+
+// Returns the compressed block, preceded by its header.
+static std::vector<char> compress_block(const std::vector<char>& block)
+{
+  uLongf compressed_size=compressBound(block.size());
+  std::vector<char> result(BLOCK_HEADER_SIZE+compressed_size);
+  if (compress2(reinterpret_cast<Bytef*>(&result[BLOCK_HEADER_SIZE]), &compressed_size,
+                reinterpret_cast<const Bytef*>(block.data()), block.size(), COMPRESSION_LEVEL)!=Z_OK)
+  {
+    throw aterm_io_error("Failed to compress a block of a binary aterm stream.");
+  }
+  result.resize(BLOCK_HEADER_SIZE+compressed_size);
+  write_uint32(compressed_size, &result[0]);
+  write_uint32(block.size(), &result[4]);
+  return result;
+}
+
+static std::vector<char> decompress_block(const std::vector<char>& compressed, const std::size_t size)
+{
+  std::vector<char> result(size);
+  uLongf decompressed_size=size;
+  if (uncompress(reinterpret_cast<Bytef*>(result.data()), &decompressed_size,
+                 reinterpret_cast<const Bytef*>(compressed.data()), compressed.size())!=Z_OK || decompressed_size!=size)
+  {
+    throw aterm_io_error("Failed to decompress a block of a compressed binary aterm stream.");
+  }
+  return result;
+}
+
+/* ------------------------------ compression ------------------------------ */
+
+block_compressing_streambuf::block_compressing_streambuf(std::streambuf* target, const std::size_t block_size)
+ : m_target(target),
+   m_block(block_size),
+   m_maximal_number_of_pending_blocks(std::max(1u, std::thread::hardware_concurrency())),
+   m_finished(false)
+{
+  setp(m_block.data(), m_block.data()+m_block.size());
+}
+
+block_compressing_streambuf::~block_compressing_streambuf()
+{
+  if (!m_finished)
+  {
+    try
+    {
+      finish();
+    }
+    catch (...)
+    {
+    }
+  }
+}
+
+void block_compressing_streambuf::submit_block()
+{
+  if (pptr()==pbase())
+  {
+    return;
+  }
+  std::vector<char> block(pbase(), pptr());
+  m_pending.push_back(std::async(std::launch::async, compress_block, std::move(block)));
+  setp(m_block.data(), m_block.data()+m_block.size());
+  write_pending_blocks(m_maximal_number_of_pending_blocks);
+}
+
+void block_compressing_streambuf::write_pending_blocks(const std::size_t remaining)
+{
+  while (m_pending.size()>remaining)
+  {
+    const std::vector<char> compressed=m_pending.front().get();
+    m_pending.pop_front();
+    if (m_target->sputn(compressed.data(), compressed.size())!=static_cast<std::streamsize>(compressed.size()))
+    {
+      throw aterm_io_error("Failed to write a compressed block of a binary aterm stream.");
+    }
+  }
+}
+
+block_compressing_streambuf::int_type block_compressing_streambuf::overflow(int_type c)
+{
+  submit_block();
+  if (!traits_type::eq_int_type(c, traits_type::eof()))
+  {
+    *pptr()=traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int block_compressing_streambuf::sync()
+{
+  submit_block();
+  write_pending_blocks(0);
+  return m_target->pubsync();
+}
+
+void block_compressing_streambuf::finish()
+{
+  m_finished=true;
+  submit_block();
+  write_pending_blocks(0);
+  char end_marker[BLOCK_HEADER_SIZE]={ 0 };
+  if (m_target->sputn(end_marker, BLOCK_HEADER_SIZE)!=static_cast<std::streamsize>(BLOCK_HEADER_SIZE))
+  {
+    throw aterm_io_error("Failed to write the end of a compressed binary aterm stream.");
+  }
+}
+
+/* ------------------------------ decompression ------------------------------ */
+
+block_decompressing_streambuf::block_decompressing_streambuf(std::streambuf* source)
+ : m_source(source),
+   m_next_block(read_block())
+{
+  setg(nullptr, nullptr, nullptr);
+}
+
+// Reads the next compressed block, and starts decompressing it. At the end of the stream
+// an empty block is returned.
+std::future<std::vector<char> > block_decompressing_streambuf::read_block()
+{
+  char header[BLOCK_HEADER_SIZE];
+  if (m_source->sgetn(header, BLOCK_HEADER_SIZE)!=static_cast<std::streamsize>(BLOCK_HEADER_SIZE))
+  {
+    throw aterm_io_error("Unexpected end of a compressed binary aterm stream.");
+  }
+  const std::size_t compressed_size=read_uint32(header);
+  const std::size_t size=read_uint32(header+4);
+  if (compressed_size==0)
+  {
+    return std::async(std::launch::deferred, []() { return std::vector<char>(); });
+  }
+
+  std::vector<char> compressed(compressed_size);
+  if (m_source->sgetn(compressed.data(), compressed_size)!=static_cast<std::streamsize>(compressed_size))
+  {
+    throw aterm_io_error("Unexpected end of a compressed binary aterm stream.");
+  }
+  return std::async(std::launch::async, decompress_block, std::move(compressed), size);
+}
+
+block_decompressing_streambuf::int_type block_decompressing_streambuf::underflow()
+{
+  if (!m_next_block.valid())
+  {
+    return traits_type::eof();
+  }
+  m_block=m_next_block.get();
+  if (m_block.empty())
+  {
+    return traits_type::eof();
+  }
+  m_next_block=read_block();
+  setg(m_block.data(), m_block.data(), m_block.data()+m_block.size());
+  return traits_type::to_int_type(*gptr());
+}
+
+} // namespace detail
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_COMPRESSION
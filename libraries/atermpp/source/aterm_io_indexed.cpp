@@ -0,0 +1,434 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file aterm_io_indexed.cpp
+/// \brief An indexed container of terms in binary aterm format.
+///
+/// The layout of an indexed binary aterm file is as follows. All integers are
+/// written with detail::writeInt, except for those marked as fixed, which are
+/// eight bytes, least significant byte first, such that files larger than 4GB
+/// can be indexed.
+///
+///   header:    0, INDEXED_BAF_MAGIC, INDEXED_BAF_VERSION
+///   sections:  a sequence of terms, each in the ordinary binary aterm format
+///   index:     number of sections, followed for each section by
+///              the length of its name, its name, its offset (fixed) and its size (fixed)
+///   trailer:   the offset of the index (fixed), and the eight characters of INDEX_TRAILER.
+///
+/// The header starts with a 0, like the ordinary binary aterm format, but the
+/// second integer differs from BAF_MAGIC, which lets the ordinary reader reject
+/// these files with a clear message.
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <streambuf>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mcrl2/atermpp/aterm_io_indexed.h"
+#include "mcrl2/atermpp/detail/aterm_io_implementation.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace atermpp
+{
+
+static const std::size_t INDEXED_BAF_MAGIC = 0x1baf;
+static const std::size_t INDEXED_BAF_VERSION = 0x0001;
+static const char INDEX_TRAILER[8] = { 'm', 'C', 'R', 'L', '2', 'i', 'd', 'x' };
+static const std::size_t TRAILER_SIZE = 16;
+
+namespace detail
+{
+
+// A stream buffer that forwards its output to another stream buffer, and counts the number of characters.
+class counting_streambuf: public std::streambuf
+{
+  protected:
+    std::streambuf* m_target;
+    std::size_t m_count;
+
+    int_type overflow(int_type c)
+    {
+      if (traits_type::eq_int_type(c, traits_type::eof()))
+      {
+        return traits_type::not_eof(c);
+      }
+      m_count++;
+      return m_target->sputc(traits_type::to_char_type(c));
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n)
+    {
+      const std::streamsize written=m_target->sputn(s, n);
+      m_count+=written;
+      return written;
+    }
+
+  public:
+    counting_streambuf(std::streambuf* target)
+     : m_target(target),
+       m_count(0)
+    {}
+
+    std::size_t count() const
+    {
+      return m_count;
+    }
+};
+
+// A stream buffer that reads from a block of memory.
+class memory_streambuf: public std::streambuf
+{
+  public:
+    memory_streambuf(const char* data, const std::size_t size)
+    {
+      char* p=const_cast<char*>(data);
+      setg(p, p, p+size);
+    }
+};
+
+// A stream buffer that reads chunks from another stream buffer. Before the first character is
+// consumed, the whole first chunk is available in the get area, which allows to inspect the header.
+class chunked_streambuf: public std::streambuf
+{
+  protected:
+    std::streambuf* m_source;
+    std::vector<char> m_chunk;
+
+    int_type underflow()
+    {
+      const std::streamsize n=m_source->sgetn(m_chunk.data(), m_chunk.size());
+      if (n<=0)
+      {
+        return traits_type::eof();
+      }
+      setg(m_chunk.data(), m_chunk.data(), m_chunk.data()+n);
+      return traits_type::to_int_type(*gptr());
+    }
+
+  public:
+    chunked_streambuf(std::streambuf* source)
+     : m_source(source),
+       m_chunk(1UL << 16)
+    {
+      setg(m_chunk.data(), m_chunk.data(), m_chunk.data());
+    }
+
+    // The characters in the get area, which are the start of the stream as long as nothing is consumed.
+    const char* available() const
+    {
+      return gptr();
+    }
+
+    std::size_t available_size() const
+    {
+      return egptr()-gptr();
+    }
+};
+
+static std::size_t read_fixed_size_int(const char* p)
+{
+  std::size_t result=0;
+  for(std::size_t i=8; i>0; --i)
+  {
+    result=(result<<8) | static_cast<unsigned char>(p[i-1]);
+  }
+  return result;
+}
+
+static bool starts_with_indexed_header(std::istream& is)
+{
+  try
+  {
+    return detail::readInt(is)==0 && detail::readInt(is)==INDEXED_BAF_MAGIC;
+  }
+  catch (std::runtime_error&)
+  {
+    return false;
+  }
+}
+
+} // namespace detail
+
+bool is_indexed_binary_aterm_file(const std::string& filename)
+{
+  if (filename.empty())
+  {
+    return false;
+  }
+  std::ifstream is(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+  return is.good() && detail::starts_with_indexed_header(is);
+}
+
+bool is_indexed_binary_aterm_stream(std::istream& is)
+{
+  return detail::starts_with_indexed_header(is);
+}
+
+inspectable_binary_aterm_istream::inspectable_binary_aterm_istream(std::istream& is)
+ : std::istream(nullptr),
+   m_is_indexed(false)
+{
+  detail::chunked_streambuf* buffer=new detail::chunked_streambuf(is.rdbuf());
+  m_buffer.reset(buffer);
+  rdbuf(buffer);
+  if (peek()!=traits_type::eof())
+  {
+    detail::memory_streambuf header_buffer(buffer->available(), buffer->available_size());
+    std::istream header(&header_buffer);
+    m_is_indexed=detail::starts_with_indexed_header(header);
+  }
+}
+
+inspectable_binary_aterm_istream::~inspectable_binary_aterm_istream()
+{
+}
+
+/* ------------------------------ writer ------------------------------ */
+
+indexed_binary_aterm_writer::indexed_binary_aterm_writer(std::ostream& os)
+ : m_stream(os),
+   m_position(0),
+   m_closed(false)
+{
+  unsigned char buf[8];
+  for(std::size_t n: { std::size_t(0), INDEXED_BAF_MAGIC, INDEXED_BAF_VERSION })
+  {
+    write_bytes(reinterpret_cast<char*>(buf), detail::writeIntToBuf(n, buf));
+  }
+}
+
+void indexed_binary_aterm_writer::write_bytes(const char* bytes, const std::size_t size)
+{
+  m_stream.write(bytes, size);
+  m_position+=size;
+}
+
+void indexed_binary_aterm_writer::write_fixed_size_int(std::size_t n)
+{
+  char buf[8];
+  for(std::size_t i=0; i<8; ++i)
+  {
+    buf[i]=static_cast<char>(n & 0xff);
+    n=n>>8;
+  }
+  write_bytes(buf, 8);
+}
+
+void indexed_binary_aterm_writer::add_section(const std::string& name, const aterm& t)
+{
+  assert(!m_closed);
+  for(const section_entry& e: m_index)
+  {
+    if (e.name==name)
+    {
+      throw aterm_io_error("The section " + name + " occurs twice in an indexed binary aterm file.");
+    }
+  }
+
+  detail::counting_streambuf counter(m_stream.rdbuf());
+  std::ostream counting_stream(&counter);
+  write_term_to_binary_stream(t, counting_stream);
+  if (!counting_stream.good())
+  {
+    throw aterm_io_error("Failed to write section " + name + " of an indexed binary aterm file.");
+  }
+  const section_entry e={ name, m_position, counter.count() };
+  m_index.push_back(e);
+  m_position+=counter.count();
+}
+
+void indexed_binary_aterm_writer::close()
+{
+  assert(!m_closed);
+  const std::size_t index_offset=m_position;
+  unsigned char buf[8];
+  write_bytes(reinterpret_cast<char*>(buf), detail::writeIntToBuf(m_index.size(), buf));
+  for(const section_entry& e: m_index)
+  {
+    write_bytes(reinterpret_cast<char*>(buf), detail::writeIntToBuf(e.name.size(), buf));
+    write_bytes(e.name.data(), e.name.size());
+    write_fixed_size_int(e.offset);
+    write_fixed_size_int(e.size);
+  }
+  write_fixed_size_int(index_offset);
+  write_bytes(INDEX_TRAILER, sizeof(INDEX_TRAILER));
+  m_stream.flush();
+  m_closed=true;
+  if (!m_stream.good())
+  {
+    throw aterm_io_error("Failed to write the index of an indexed binary aterm file.");
+  }
+}
+
+/* ------------------------------ reader ------------------------------ */
+
+indexed_binary_aterm_file::indexed_binary_aterm_file(const std::string& filename)
+ : m_data(nullptr),
+   m_size(0),
+   m_is_mapped(false)
+{
+  if (filename.empty())
+  {
+    m_buffer.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+  }
+  else
+  {
+#ifndef _WIN32
+    const int fd=open(filename.c_str(), O_RDONLY);
+    if (fd<0)
+    {
+      throw aterm_io_error("Cannot open file " + filename + " for reading.");
+    }
+    struct stat status;
+    if (fstat(fd, &status)==0 && status.st_size>0)
+    {
+      void* p=mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p!=MAP_FAILED)
+      {
+        m_data=static_cast<const char*>(p);
+        m_size=status.st_size;
+        m_is_mapped=true;
+      }
+    }
+    ::close(fd);
+#endif
+    if (!m_is_mapped)
+    {
+      mCRL2log(mcrl2::log::debug) << "Reading " << filename << " into memory, as it cannot be mapped.\n";
+      std::ifstream is(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+      if (!is.good())
+      {
+        throw aterm_io_error("Cannot open file " + filename + " for reading.");
+      }
+      m_buffer.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    }
+  }
+
+  if (!m_is_mapped)
+  {
+    m_data=m_buffer.data();
+    m_size=m_buffer.size();
+  }
+
+  try
+  {
+    read_index(filename);
+  }
+  catch (...)
+  {
+    unmap();
+    throw;
+  }
+}
+
+indexed_binary_aterm_file::indexed_binary_aterm_file(std::istream& is)
+ : m_buffer(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()),
+   m_is_mapped(false)
+{
+  m_data=m_buffer.data();
+  m_size=m_buffer.size();
+  read_index("");
+}
+
+indexed_binary_aterm_file::~indexed_binary_aterm_file()
+{
+  unmap();
+}
+
+void indexed_binary_aterm_file::unmap()
+{
+#ifndef _WIN32
+  if (m_is_mapped)
+  {
+    munmap(const_cast<char*>(m_data), m_size);
+    m_is_mapped=false;
+  }
+#endif
+}
+
+void indexed_binary_aterm_file::read_index(const std::string& filename)
+{
+  const std::string name=(filename.empty()?std::string("input"):"file " + filename);
+  detail::memory_streambuf header_buffer(m_data, m_size);
+  std::istream header(&header_buffer);
+  if (!detail::starts_with_indexed_header(header))
+  {
+    throw aterm_io_error("The " + name + " is not an indexed binary aterm file.");
+  }
+  const std::size_t version=detail::readInt(header);
+  if (version!=INDEXED_BAF_VERSION)
+  {
+    throw baf_version_error(version, INDEXED_BAF_VERSION);
+  }
+
+  if (m_size<TRAILER_SIZE || std::memcmp(m_data+m_size-sizeof(INDEX_TRAILER), INDEX_TRAILER, sizeof(INDEX_TRAILER))!=0)
+  {
+    throw aterm_io_error("The " + name + " is truncated; the index of the indexed binary aterm file is missing.");
+  }
+  const std::size_t index_offset=detail::read_fixed_size_int(m_data+m_size-TRAILER_SIZE);
+  if (index_offset>m_size-TRAILER_SIZE)
+  {
+    throw aterm_io_error("The index of the " + name + " is corrupt.");
+  }
+
+  const char* end=m_data+m_size-TRAILER_SIZE;
+  detail::memory_streambuf index_buffer(m_data+index_offset, end-(m_data+index_offset));
+  std::istream index(&index_buffer);
+  try
+  {
+    const std::size_t number_of_sections=detail::readInt(index);
+    for(std::size_t i=0; i<number_of_sections; ++i)
+    {
+      const std::size_t length=detail::readInt(index);
+      std::string section_name(length, ' ');
+      char fixed[16];
+      if (!index.read(&section_name[0], length) || !index.read(fixed, 16))
+      {
+        throw std::runtime_error("unexpected end of index");
+      }
+      const section_entry e={ detail::read_fixed_size_int(fixed), detail::read_fixed_size_int(fixed+8) };
+      if (e.offset>index_offset || e.size>index_offset-e.offset)
+      {
+        throw std::runtime_error("section " + section_name + " lies outside the file");
+      }
+      m_section_names.push_back(section_name);
+      m_sections[section_name]=e;
+    }
+  }
+  catch (std::runtime_error& e)
+  {
+    throw aterm_io_error("The index of the " + name + " is corrupt (" + e.what() + ").");
+  }
+}
+
+const indexed_binary_aterm_file::section_entry& indexed_binary_aterm_file::find_section(const std::string& name) const
+{
+  std::map<std::string, section_entry>::const_iterator i=m_sections.find(name);
+  if (i==m_sections.end())
+  {
+    throw aterm_io_error("The indexed binary aterm file does not contain a section " + name + ".");
+  }
+  return i->second;
+}
+
+aterm indexed_binary_aterm_file::read_section(const std::string& name) const
+{
+  const section_entry& e=find_section(name);
+  detail::memory_streambuf buffer(m_data+e.offset, e.size);
+  std::istream is(&buffer);
+  return read_term_from_binary_stream(is);
+}
+
+} // namespace atermpp
@@ -4,9 +4,12 @@
 #include <cassert>
 #include <stdexcept>
 
+#include <limits>
 #include <set>
 #include <string.h>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 
 #include "mcrl2/utilities/logger.h"
@@ -37,6 +40,7 @@ namespace detail
   // The function_lookup_table is not a vector to prevent it from being destroyed prematurely.
   static size_t function_symbol_index_table_size=0;
   size_t function_symbol_index_table_number_of_elements=0;
+  static size_t function_symbol_count=0; // The number of function symbols that are in use.
   static _function_symbol* function_symbol_free_list=END_OF_LIST;
   constant_function_symbols function_adm;
 
@@ -91,57 +95,133 @@ namespace detail
     return false;
   }
 
-  // A map that records for each prefix a function that must be called to set the
-  // postfix number to a sufficiently high number if a function symbol with the same
-  // prefix string is registered.
+  // The administration of a prefix for which function symbols with a postfix number are generated.
+  // As long as it exists, it is kept up to date when function symbols are created, such that a new
+  // generator for a known prefix does not need to inspect all function symbols to find a fresh index.
+  struct prefix_administration
+  {
+    // No function symbol with the name prefix+n, with n>=next_free_index, has been made.
+    size_t next_free_index;
+    // The functions that must be called to set the postfix index of the generators that use
+    // this prefix to a sufficiently high number if a function symbol with this prefix is made.
+    std::vector<index_increaser> generators;
+
+    prefix_administration(const size_t index)
+     : next_free_index(index)
+    {}
+  };
+
+  // The map with the prefix administrations is not destroyed, such that generators
+  // in global variables can safely deregister themselves. It is created on first use.
+  typedef std::unordered_map<std::string, prefix_administration> prefix_administration_map;
+  static prefix_administration_map* prefix_to_administration=nullptr;
+
+  // If the name ends in a number n that fits in a size_t, the number of characters before this
+  // number is put in prefix_length, n is put in number and true is returned.
+  static bool split_postfix_number(const char* name_begin, const char* name_end, size_t& prefix_length, size_t& number)
+  {
+    const char* start_of_number=name_end;
+    while (start_of_number!=name_begin && isdigit(static_cast<unsigned char>(*(start_of_number-1))))
+    {
+      --start_of_number;
+    }
+    if (start_of_number==name_end) // There is no trailing number.
+    {
+      return false;
+    }
+    number=0;
+    for(const char* i=start_of_number; i!=name_end; ++i)
+    {
+      const size_t digit=*i-'0';
+      if (number>(std::numeric_limits<size_t>::max()-1-digit)/10) // number+1 must fit in a size_t as well.
+      {
+        return false;
+      }
+      number=10*number+digit;
+    }
+    prefix_length=start_of_number-name_begin;
+    return true;
+  }
 
-  static std::map < std::string, detail::index_increaser> prefix_to_register_function_map;
+  // Record that a function symbol with the name prefix+number has been made.
+  static void update_prefix_administration(prefix_administration& prefix, const size_t number)
+  {
+    if (number>=prefix.next_free_index)
+    {
+      prefix.next_free_index=number+1;
+    }
+    for(index_increaser& increase_index: prefix.generators)
+    {
+      increase_index(number+1); // Set the index belonging to the prefix to at least a safe number+1.
+    }
+  }
 
-  size_t get_sufficiently_large_postfix_index(const std::string& prefix_)
+  static prefix_administration& find_prefix_administration(const std::string& prefix_)
   {
+    prefix_administration_map::iterator i=prefix_to_administration->find(prefix_);
+    if (i!=prefix_to_administration->end())
+    {
+      return i->second;
+    }
+
+    // The prefix is not known yet. Find the largest postfix number among all function symbols.
     size_t index=0;
     for(size_t i=0; i<function_symbol_index_table_number_of_elements; ++i)
     {
       for(size_t j=0; j<FUNCTION_SYMBOL_BLOCK_SIZE; ++j )
       {
-        std::string& function_name=detail::function_symbol_index_table[i][j].name;
-        if (function_name.compare(0,prefix_.size(),prefix_)==0)   // The function name starts with the prefix
+        const std::string& function_name=detail::function_symbol_index_table[i][j].name;
+        size_t prefix_length;
+        size_t number;
+        if (function_name.compare(0,prefix_.size(),prefix_)==0 &&  // The function name starts with the prefix
+            split_postfix_number(function_name.data(),function_name.data()+function_name.size(),prefix_length,number) &&
+            prefix_length<=prefix_.size() &&
+            number>=index)
         {
-          std::string potential_number=function_name.substr(prefix_.size()); // Get the trailing string after prefix_ of function_name.
-          size_t end_of_number;
-          try
-          {
-            size_t number=std::stol(potential_number,&end_of_number);
-            if (end_of_number==potential_number.size()) // A proper number was read.
-            {
-              if (number>=index)
-              {
-                index=number+1;
-              }
-            }
-          }
-          catch (std::exception&)
-          {
-            // Can be std::invalid_argument or an out_of_range exception.
-            // In both cases nothing needs to be done, and the exception can be ignored.
-          }
+          index=number+1;
         }
       }
     }
-    return index;
+    return prefix_to_administration->insert(std::make_pair(prefix_,prefix_administration(index))).first->second;
+  }
+
+  size_t get_sufficiently_large_postfix_index(const std::string& prefix_)
+  {
+    term_store_lock lock;
+    if (function_symbol_table_size==0)
+    {
+      initialise_administration();
+    }
+    return find_prefix_administration(prefix_).next_free_index;
   }
 
   // register a prefix for a function symbol, such that the index of this prefix can be increased when
   // some other process makes a function symbol with the same prefix.
-  void register_function_symbol_prefix_string(const std::string& prefix, index_increaser& increase_index)
+  prefix_administration& register_function_symbol_prefix_string(const std::string& prefix, index_increaser& increase_index)
   {
-    prefix_to_register_function_map[prefix]=increase_index;
+    term_store_lock lock;
+    if (function_symbol_table_size==0)
+    {
+      initialise_administration();
+    }
+    prefix_administration& result=find_prefix_administration(prefix);
+    result.generators.push_back(increase_index);
+    return result;
   }
 
   // deregister a prefix for a function symbol.
-  void deregister_function_symbol_prefix_string(const std::string& prefix)
+  void deregister_function_symbol_prefix_string(const std::string& prefix, const index_increaser& increase_index)
   {
-    prefix_to_register_function_map.erase(prefix);
+    term_store_lock lock;
+    std::vector<index_increaser>& generators=find_prefix_administration(prefix).generators;
+    for(std::vector<index_increaser>::iterator i=generators.begin(); i!=generators.end(); ++i)
+    {
+      if (*i==increase_index)
+      {
+        generators.erase(i);
+        return;
+      }
+    }
   }
 
 
@@ -155,6 +235,7 @@ namespace detail
 
     if (function_symbol_table_size==0)
     {
+      prefix_to_administration=new prefix_administration_map();
       function_symbol_table_size=INITIAL_FUNCTION_HASH_TABLE_SIZE;
       function_symbol_table_mask=function_symbol_table_size-1;
 
@@ -181,9 +262,6 @@ namespace detail
 
       initialise_aterm_administration();
 
-      // Take care that the prefix_to_register_function_map is initialized. Use a placement new, because
-      // the memory address of prefix_to_register_function_map may be unitialized.
-      new (&prefix_to_register_function_map) std::map < std::string, detail::index_increaser>();
     }
   }
 
@@ -191,7 +269,7 @@ namespace detail
   template <class StringIterator>
   static HashNumber calculate_hash_of_function_symbol(const StringIterator string_begin, const StringIterator string_end, const size_t arity);
 
-  static void resize_function_symbol_hashtable()
+  static bool resize_function_symbol_hashtable()
   {
     function_symbol_table_size  <<=1;  // Double the size.
 
@@ -203,7 +281,7 @@ namespace detail
       mCRL2log(mcrl2::log::warning) << "could not resize function symbol hashtable to class " << function_symbol_table_size << ".";
       function_symbol_table_size  >>=1; // Restore the size by dividing it by 2.
       function_symbol_hashtable=old_function_symbol_hashtable;
-      return;
+      return false;
     }
     function_symbol_table_mask  = function_symbol_table_size-1;
 
@@ -226,8 +304,23 @@ namespace detail
         }
       }
     }
+    return true;
   }
 
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+  static bool is_in_function_symbol_hashtable(const _function_symbol* f, const HashNumber hnr)
+  {
+    for(const _function_symbol* cur=function_symbol_hashtable[hnr]; cur!=END_OF_LIST; cur=cur->next)
+    {
+      if (cur==f)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+#endif
+
   static const size_t MAGIC_PRIME = 7;
 
   template <class StringIterator>
@@ -242,6 +335,26 @@ namespace detail
 
     return hnr*MAGIC_PRIME;
   }
+
+  void reserve_function_symbols(const size_t n)
+  {
+    term_store_lock lock;
+    if (function_symbol_table_size==0)
+    {
+      initialise_administration();
+    }
+    while (function_symbol_index_table_number_of_elements*FUNCTION_SYMBOL_BLOCK_SIZE<function_symbol_count+n)
+    {
+      create_new_function_symbol_block();
+    }
+    while (function_symbol_index_table_number_of_elements<<(FUNCTION_SYMBOL_BLOCK_CLASS+1) > function_symbol_table_size)
+    {
+      if (!resize_function_symbol_hashtable())
+      {
+        return;
+      }
+    }
+  }
 } // namespace detail
 
 function_symbol::function_symbol()
@@ -268,6 +381,7 @@ static void initialize_function_symbol_administration()
 
 function_symbol::function_symbol(const std::string& name, const size_t arity_)
 {
+  detail::term_store_lock lock;
   initialize_function_symbol_administration();
   const HashNumber hnr = detail::calculate_hash_of_function_symbol(name.begin(), name.end(), arity_) & detail::function_symbol_table_mask;
   /* Find symbol in table */
@@ -301,44 +415,45 @@ function_symbol::function_symbol(const std::string& name, const size_t arity_)
   m_function_symbol=cur;
   increase_reference_count<false>();
 
-  // Check whether there is a registered prefix p such that name equal pn where n is a number.
+  detail::function_symbol_count++;
+
+  // Check whether there is a known prefix p such that name equal pn where n is a number.
   // In that case prevent that pn will be generated as a fresh function name.
-  size_t start_of_index=name.find_last_not_of("0123456789")+1;
-  if (start_of_index<name.size()) // Otherwise there is no trailing number.
+  size_t prefix_length;
+  size_t number;
+  if (!detail::prefix_to_administration->empty() &&
+      detail::split_postfix_number(name.data(), name.data()+name.size(), prefix_length, number))
   {
-    std::string potential_number=name.substr(start_of_index); // Get the trailing string after prefix_ of function_name.
-    std::string prefix=name.substr(0,start_of_index);
-    std::map < std::string, detail::index_increaser>::iterator i=detail::prefix_to_register_function_map.find(prefix);
-    if (i!=detail::prefix_to_register_function_map.end())  // i points to the prefix.
+    detail::prefix_administration_map::iterator i=detail::prefix_to_administration->find(name.substr(0,prefix_length));
+    if (i!=detail::prefix_to_administration->end())  // i points to the prefix.
     {
-      try
-      {
-        size_t number=std::stol(potential_number);
-        i->second(number+1); // Set the index belonging to the found prefix to at least a safe number+1.
-      }
-      catch (std::exception)
-      {
-        // Can be std::invalid_argument or an out_of_range exception.
-        // In both cases nothing needs to be done, and the exception can be ignored.
-      }
+      detail::update_prefix_administration(i->second, number);
     }
   }
 }
 
 
-// Create a function symbol from a string and an arity, of which it is guaranteed
-// that such a function does not exist. This is an optimisation of the function_symbol contruction
-// for functions that are constructed using a prefix string and a number.
-function_symbol::function_symbol(const char* name_begin, const char* name_end, const size_t arity_)
+// Create a function symbol from a string that consists of a prefix and a number, and an arity.
+// This is an optimisation of the function_symbol contruction for functions that are constructed by
+// a function symbol generator. The name is only turned into a string if the function symbol is new,
+// and instead of checking the name against all known prefixes, only the administration of the
+// prefix of the generator is updated.
+function_symbol::function_symbol(const char* name_begin, const char* name_end, const size_t arity_,
+                                 detail::prefix_administration& prefix, const size_t index)
 {
+  detail::term_store_lock lock;
   initialize_function_symbol_administration();
+  if (index>=prefix.next_free_index)
+  {
+    prefix.next_free_index=index+1;
+  }
   const HashNumber hnr = detail::calculate_hash_of_function_symbol(name_begin, name_end, arity_) & detail::function_symbol_table_mask;
   /* Find symbol in table */
   detail::_function_symbol* cur = detail::function_symbol_hashtable[hnr];
-  std::string name(name_begin);
+  const size_t name_length=name_end-name_begin;
   while (cur!=detail::END_OF_LIST)
   {
-    if (cur->arity==arity_ && cur->name==name)
+    if (cur->arity==arity_ && cur->name.compare(0,std::string::npos,name_begin,name_length)==0)
     {
       // The function_symbol was already present. Return it.
       m_function_symbol=cur;
@@ -358,24 +473,35 @@ function_symbol::function_symbol(const char* name_begin, const char* name_end, c
   cur=detail::function_symbol_free_list;
   detail::function_symbol_free_list = cur->next;
   assert(cur->reference_count==0);
-  cur->name=name;
+  cur->name.assign(name_begin,name_end);
   cur->arity=arity_;
   cur->next=detail::function_symbol_hashtable[hnr];
 
   detail::function_symbol_hashtable[hnr] = cur;
   m_function_symbol=cur;
   increase_reference_count<false>();
+  detail::function_symbol_count++;
 }
 
 
 void function_symbol::free_function_symbol() const
 {
-  assert(m_function_symbol->reference_count==0);
+  detail::term_store_lock lock;
   /* Calculate hashnumber */
   const HashNumber hnr = detail::calculate_hash_of_function_symbol(m_function_symbol->name.begin(),
                                                                    m_function_symbol->name.end(),
                                                                    m_function_symbol->arity) & detail::function_symbol_table_mask;
 
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+  // Between the moment the reference count became 0 and obtaining the lock, another thread
+  // may have found this function symbol in the hashtable, or it may have freed it already.
+  if (m_function_symbol->reference_count>0 || !detail::is_in_function_symbol_hashtable(m_function_symbol,hnr))
+  {
+    return;
+  }
+#endif
+  assert(m_function_symbol->reference_count==0);
+
   /* Update hashtable */
   if (detail::function_symbol_hashtable[hnr] == m_function_symbol)
   {
@@ -394,6 +520,7 @@ void function_symbol::free_function_symbol() const
 
   const_cast<detail::_function_symbol*>(m_function_symbol)->next = detail::function_symbol_free_list;
   detail::function_symbol_free_list = const_cast<detail::_function_symbol*>(m_function_symbol);
+  detail::function_symbol_count--;
 }
 
 } // namespace atermpp
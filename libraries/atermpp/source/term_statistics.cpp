@@ -0,0 +1,171 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file term_statistics.cpp
+/// \brief Statistics about the memory used by the term library.
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+#include "mcrl2/atermpp/detail/aterm_implementation.h"
+#include "mcrl2/atermpp/term_statistics.h"
+
+namespace atermpp
+{
+
+namespace detail
+{
+
+static void count_chains(term_statistics& result)
+{
+  result.number_of_chains=0;
+  result.longest_chain=0;
+#ifdef MCRL2_ATERMPP_OPEN_ADDRESSING
+  // Sequences of occupied slots may wrap around the end of the table; they are counted in two parts.
+  size_t length=0;
+  for(size_t i=0; i<=aterm_table_size; ++i)
+  {
+    if (i<aterm_table_size && aterm_hashtable[i].term!=nullptr)
+    {
+      length++;
+    }
+    else if (length>0)
+    {
+      result.number_of_chains++;
+      result.longest_chain=std::max(result.longest_chain,length);
+      length=0;
+    }
+  }
+#else
+  for(size_t i=0; i<aterm_table_size; ++i)
+  {
+    size_t length=0;
+    for(const _aterm* t=aterm_hashtable[i]; t!=nullptr; t=t->next())
+    {
+      length++;
+    }
+    if (length>0)
+    {
+      result.number_of_chains++;
+      result.longest_chain=std::max(result.longest_chain,length);
+    }
+  }
+#endif
+}
+
+} // namespace detail
+
+term_statistics get_term_statistics()
+{
+  using namespace detail;
+  term_store_lock lock;
+
+  term_statistics result;
+  std::map<size_t, function_symbol_statistics> per_function_symbol;
+
+  for(size_t size=TERM_SIZE; size<terminfo_size; ++size)
+  {
+    size_class_statistics c={ size, 0, 0, 0, 0, 0 };
+    for(const Block* b=terminfo[size].at_block; b!=nullptr; b=b->next_by_size)
+    {
+      c.number_of_blocks++;
+      c.bytes+=sizeof(Block*)+sizeof(size_t*)+(b->end-b->data)*sizeof(size_t);
+      for(const size_t* p=b->data; p<b->end; p=p+size)
+      {
+        const _aterm* t=reinterpret_cast<const _aterm*>(p);
+        if (t->reference_count_indicates_is_in_freelist())
+        {
+          c.free_terms++;
+          continue;
+        }
+
+        const function_symbol& f=t->function();
+        std::map<size_t, function_symbol_statistics>::iterator i=per_function_symbol.find(f.number());
+        if (i==per_function_symbol.end())
+        {
+          const function_symbol_statistics s={ f.name(), f.arity(), 0, 0, 0 };
+          i=per_function_symbol.insert(std::make_pair(f.number(),s)).first;
+        }
+        i->second.bytes+=size*sizeof(size_t);
+        if (t->reference_count_is_zero())
+        {
+          c.unreferenced_terms++;
+          i->second.unreferenced_terms++;
+        }
+        else
+        {
+          c.referenced_terms++;
+          i->second.referenced_terms++;
+        }
+      }
+    }
+    if (c.number_of_blocks>0)
+    {
+      result.size_classes.push_back(c);
+    }
+  }
+
+  for(std::map<size_t, function_symbol_statistics>::const_iterator i=per_function_symbol.begin(); i!=per_function_symbol.end(); ++i)
+  {
+    result.function_symbols.push_back(i->second);
+  }
+  std::stable_sort(result.function_symbols.begin(), result.function_symbols.end(),
+                   [](const function_symbol_statistics& x, const function_symbol_statistics& y){ return x.bytes>y.bytes; });
+
+  result.hashtable_size=aterm_table_size;
+  result.terms_in_hashtable=total_nodes_in_hashtable;
+  count_chains(result);
+  result.number_of_hashtable_resizes=number_of_hashtable_resizes;
+  result.garbage_collection=get_garbage_collection_statistics();
+  return result;
+}
+
+void print_term_statistics(std::ostream& out, const size_t number_of_function_symbols)
+{
+  const term_statistics s=get_term_statistics();
+
+  size_t total_bytes=0;
+  out << "Term statistics\n"
+      << "  size classes (term size in words, blocks, referenced, unreferenced, free terms, bytes):\n";
+  for(const size_class_statistics& c: s.size_classes)
+  {
+    out << "    " << std::setw(4) << c.term_size
+        << std::setw(10) << c.number_of_blocks
+        << std::setw(14) << c.referenced_terms
+        << std::setw(14) << c.unreferenced_terms
+        << std::setw(14) << c.free_terms
+        << std::setw(16) << c.bytes << "\n";
+    total_bytes+=c.bytes;
+  }
+  out << "  total bytes in blocks: " << total_bytes << "\n";
+
+  out << "  function symbols (referenced, unreferenced terms, bytes):\n";
+  for(size_t i=0; i<s.function_symbols.size() && i<number_of_function_symbols; ++i)
+  {
+    const function_symbol_statistics& f=s.function_symbols[i];
+    out << "    " << std::setw(14) << f.referenced_terms
+        << std::setw(14) << f.unreferenced_terms
+        << std::setw(16) << f.bytes
+        << "  " << f.name << "/" << f.arity << "\n";
+  }
+  if (s.function_symbols.size()>number_of_function_symbols)
+  {
+    out << "    ... and " << s.function_symbols.size()-number_of_function_symbols << " other function symbols\n";
+  }
+
+  out << "  hashtable: " << s.terms_in_hashtable << " terms in " << s.hashtable_size << " entries"
+      << " (load " << static_cast<double>(s.terms_in_hashtable)/s.hashtable_size << ")"
+      << ", " << s.number_of_chains << " chains"
+      << ", average chain length " << (s.number_of_chains==0?0.0:static_cast<double>(s.terms_in_hashtable)/s.number_of_chains)
+      << ", longest chain " << s.longest_chain
+      << ", " << s.number_of_hashtable_resizes << " resizes\n";
+  out << "  " << s.garbage_collection << std::endl;
+}
+
+} // namespace atermpp
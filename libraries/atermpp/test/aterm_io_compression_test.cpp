@@ -0,0 +1,90 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file aterm_io_compression_test.cpp
+/// \brief Test reading and writing compressed binary aterms.
+
+#include <sstream>
+#include <boost/test/minimal.hpp>
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_list.h"
+#include "mcrl2/atermpp/aterm_io.h"
+#include "mcrl2/atermpp/detail/aterm_io_compression.h"
+
+using namespace atermpp;
+
+static aterm large_term()
+{
+  function_symbol f("f",2);
+  aterm_list result;
+  for(size_t i=0; i<100000; ++i)
+  {
+    result.push_front(aterm_appl(f,aterm_int(i),aterm_int(i%17)));
+  }
+  return result;
+}
+
+// Writes and reads t, followed by some other data that must not be consumed by the reader.
+static void test_round_trip(const aterm& t, const bool compress)
+{
+  set_binary_aterm_compression(compress);
+  std::stringstream s;
+  write_term_to_binary_stream(t, s);
+  s << "trailing data";
+
+  BOOST_CHECK(read_term_from_binary_stream(s)==t);
+  std::string rest;
+  std::getline(s, rest);
+  BOOST_CHECK(rest=="trailing data");
+}
+
+#ifdef MCRL2_ATERMPP_COMPRESSION
+// Compresses a sequence of characters spanning many small blocks.
+static void test_streambufs()
+{
+  std::stringstream s;
+  {
+    detail::block_compressing_streambuf buffer(s.rdbuf(), 64);
+    std::ostream os(&buffer);
+    for(size_t i=0; i<1000; ++i)
+    {
+      os << i << ' ';
+    }
+    buffer.finish();
+  }
+
+  detail::block_decompressing_streambuf buffer(s.rdbuf());
+  std::istream is(&buffer);
+  for(size_t i=0; i<1000; ++i)
+  {
+    size_t j;
+    is >> j;
+    BOOST_CHECK(i==j);
+  }
+  size_t j;
+  BOOST_CHECK(!(is >> j));
+}
+#endif
+
+int test_main(int argc, char* argv[])
+{
+  const aterm t=large_term();
+  test_round_trip(t, false);
+  test_round_trip(read_term_from_string("f(a,[1,2])"), false);
+  if (binary_aterm_compression_is_available())
+  {
+    test_round_trip(t, true);
+    test_round_trip(read_term_from_string("f(a,[1,2])"), true);
+  }
+#ifdef MCRL2_ATERMPP_COMPRESSION
+  test_streambufs();
+#endif
+  return 0;
+}
@@ -0,0 +1,158 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file aterm_io_indexed_test.cpp
+/// \brief Test the indexed binary aterm format.
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <boost/test/minimal.hpp>
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_list.h"
+#include "mcrl2/atermpp/aterm_io.h"
+#include "mcrl2/atermpp/aterm_io_indexed.h"
+
+using namespace atermpp;
+
+void test_indexed_file()
+{
+  const std::string filename="aterm_io_indexed_test.taf";
+  const aterm t1=read_term_from_string("f(g(1,[a,b]),g(1,[a,b]))");
+  aterm_list l;
+  for(size_t i=0; i<10000; ++i)
+  {
+    l.push_front(aterm_appl(function_symbol("h",1),aterm_int(i)));
+  }
+  const aterm t2=l;
+
+  {
+    std::ofstream os(filename.c_str(), std::ofstream::out | std::ofstream::binary);
+    indexed_binary_aterm_writer writer(os);
+    writer.add_section("first", t1);
+    writer.add_section("second", t2);
+    writer.add_section("empty", aterm_list());
+    writer.close();
+  }
+
+  BOOST_CHECK(is_binary_aterm_file(filename));
+  BOOST_CHECK(is_indexed_binary_aterm_file(filename));
+
+  {
+    const indexed_binary_aterm_file f(filename);
+    BOOST_CHECK(f.section_names().size()==3);
+    BOOST_CHECK(f.section_names()[1]=="second");
+    BOOST_CHECK(f.has_section("first"));
+    BOOST_CHECK(!f.has_section("third"));
+    BOOST_CHECK(f.section_size("second")>f.section_size("first"));
+
+    // The sections can be read in any order.
+    BOOST_CHECK(f.read_section("second")==t2);
+    BOOST_CHECK(f.read_section("first")==t1);
+    BOOST_CHECK(f.read_section("empty")==aterm_list());
+
+    bool thrown=false;
+    try
+    {
+      f.read_section("third");
+    }
+    catch (aterm_io_error&)
+    {
+      thrown=true;
+    }
+    BOOST_CHECK(thrown);
+  }
+
+  // The ordinary reader refuses an indexed file.
+  {
+    std::ifstream is(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+    bool thrown=false;
+    try
+    {
+      read_term_from_binary_stream(is);
+    }
+    catch (aterm_io_error&)
+    {
+      thrown=true;
+    }
+    BOOST_CHECK(thrown);
+  }
+  std::remove(filename.c_str());
+}
+
+void test_ordinary_file_is_not_indexed()
+{
+  const std::string filename="aterm_io_indexed_test.baf";
+  {
+    std::ofstream os(filename.c_str(), std::ofstream::out | std::ofstream::binary);
+    write_term_to_binary_stream(read_term_from_string("f(a)"), os);
+  }
+  BOOST_CHECK(is_binary_aterm_file(filename));
+  BOOST_CHECK(!is_indexed_binary_aterm_file(filename));
+
+  bool thrown=false;
+  try
+  {
+    indexed_binary_aterm_file f(filename);
+  }
+  catch (aterm_io_error&)
+  {
+    thrown=true;
+  }
+  BOOST_CHECK(thrown);
+  std::remove(filename.c_str());
+}
+
+// Streams that cannot be rewound, such as standard input, are inspected without consuming them.
+// The terms are large, such that they do not fit in the first chunk that is inspected.
+void test_inspectable_stream()
+{
+  aterm_list l;
+  for(size_t i=0; i<100000; ++i)
+  {
+    l.push_front(aterm_appl(function_symbol("h",1),aterm_int(i)));
+  }
+  const aterm t=l;
+
+  {
+    std::stringstream s;
+    write_term_to_binary_stream(t, s);
+    inspectable_binary_aterm_istream is(s);
+    BOOST_CHECK(!is.is_indexed());
+    BOOST_CHECK(read_term_from_binary_stream(is)==t);
+  }
+
+  {
+    std::stringstream s;
+    indexed_binary_aterm_writer writer(s);
+    writer.add_section("first", t);
+    writer.add_section("second", read_term_from_string("f(a)"));
+    writer.close();
+    inspectable_binary_aterm_istream is(s);
+    BOOST_CHECK(is.is_indexed());
+    const indexed_binary_aterm_file f(is);
+    BOOST_CHECK(f.read_section("first")==t);
+    BOOST_CHECK(f.read_section("second")==read_term_from_string("f(a)"));
+  }
+
+  {
+    std::stringstream s;
+    inspectable_binary_aterm_istream is(s);
+    BOOST_CHECK(!is.is_indexed());
+  }
+}
+
+int test_main(int argc, char* argv[])
+{
+  test_indexed_file();
+  test_ordinary_file_is_not_indexed();
+  test_inspectable_stream();
+  return 0;
+}
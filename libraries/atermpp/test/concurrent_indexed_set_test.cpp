@@ -0,0 +1,140 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file concurrent_indexed_set_test.cpp
+/// \brief Test the concurrent indexed set, and the compact hashtable of
+///        the indexed set. If the term library is not thread safe, the
+///        workers are run one after another.
+
+#include <cstdint>
+#include <vector>
+#include <boost/test/minimal.hpp>
+
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+#include <thread>
+#endif
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/concurrent_indexed_set.h"
+#include "mcrl2/atermpp/indexed_set.h"
+
+using namespace atermpp;
+
+static const size_t number_of_workers=4;
+static const size_t number_of_elements=100000;
+
+// Every worker puts the same elements, in a different order, such that they
+// frequently compete for the same entries, also while the set is resized.
+template <class Set, class Function>
+static void put_elements(Set& set, Function element, const size_t worker, std::vector<size_t>& indices)
+{
+  indices.resize(number_of_elements);
+  for(size_t i=0; i<number_of_elements; ++i)
+  {
+    const size_t j=(worker%2==0)?i:number_of_elements-1-i;
+    indices[j]=set.put(element(j)).first;
+  }
+}
+
+template <class Set, class Function>
+void test_concurrent_put(Set& set, Function element)
+{
+  std::vector<std::vector<size_t> > indices(number_of_workers);
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+  std::vector<std::thread> workers;
+  for(size_t i=0; i<number_of_workers; ++i)
+  {
+    workers.push_back(std::thread(put_elements<Set, Function>,std::ref(set),element,i,std::ref(indices[i])));
+  }
+  for(std::thread& w: workers)
+  {
+    w.join();
+  }
+#else
+  for(size_t i=0; i<number_of_workers; ++i)
+  {
+    put_elements(set,element,i,indices[i]);
+  }
+#endif
+
+  // Each element must have obtained a single index, and the indices must be 0, 1, 2, ...
+  BOOST_CHECK(set.size()==number_of_elements);
+  std::vector<bool> used(number_of_elements,false);
+  for(size_t j=0; j<number_of_elements; ++j)
+  {
+    const size_t n=indices[0][j];
+    BOOST_CHECK(n<number_of_elements && !used[n]);
+    used[n]=true;
+    BOOST_CHECK(set.get(n)==element(j));
+    BOOST_CHECK(set.index(element(j))==n);
+    for(size_t i=1; i<number_of_workers; ++i)
+    {
+      BOOST_CHECK(indices[i][j]==n);
+    }
+  }
+  BOOST_CHECK(set.index(element(number_of_elements))==Set::npos);
+}
+
+static size_t number(const size_t i)
+{
+  return 7*i+1;
+}
+
+static aterm_appl term(const size_t i)
+{
+  static function_symbol f("f",1);
+  return aterm_appl(f,aterm_int(i));
+}
+
+void test_concurrent_indexed_set()
+{
+  concurrent_indexed_set<size_t> numbers(16);
+  test_concurrent_put(numbers,number);
+
+  concurrent_indexed_set<aterm_appl, std::uint32_t> terms(16);
+  test_concurrent_put(terms,term);
+  terms.release_retired_tables();
+  BOOST_CHECK(terms.index(term(3))!=terms.npos);
+  BOOST_CHECK(terms.hashtable_memory_in_bytes()<numbers.hashtable_memory_in_bytes());
+
+  terms.clear();
+  BOOST_CHECK(terms.size()==0);
+  BOOST_CHECK(terms.index(term(3))==terms.npos);
+  BOOST_CHECK(terms.put(term(3)).first==0);
+}
+
+void test_compact_indexed_set()
+{
+  indexed_set<aterm_appl> set(16);
+  for(size_t i=0; i<number_of_elements; ++i)
+  {
+    BOOST_CHECK(set.put(term(i)).first==i);
+  }
+  BOOST_CHECK(set.hashtable_memory_in_bytes()<=set.size()*4*sizeof(std::uint32_t));
+  for(size_t i=0; i<number_of_elements; ++i)
+  {
+    BOOST_CHECK(static_cast<size_t>(set.index(term(i)))==i);
+  }
+
+  // A table with 32 bit entries is widened as soon as a large index is stored.
+  detail::index_table table(4);
+  table.set(0,detail::DELETED);
+  table.set(1,12345);
+  BOOST_CHECK(!table.is_wide());
+  table.set(2,static_cast<size_t>(1)<<40);
+  BOOST_CHECK(table.is_wide());
+  BOOST_CHECK(table[0]==detail::DELETED && table[1]==12345 && table[2]==static_cast<size_t>(1)<<40 && table[3]==detail::EMPTY);
+}
+
+int test_main(int argc, char* argv[])
+{
+  test_concurrent_indexed_set();
+  test_compact_indexed_set();
+  return 0;
+}
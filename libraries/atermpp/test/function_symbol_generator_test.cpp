@@ -52,9 +52,52 @@ void test_generator()
   std::cout << "q2 == " << q2 << " name = " << q2.name() << " arity = " << q2.arity() << " number = " << q2.number() << std::endl;
 }
 
+// Generators for a prefix that is already known do not inspect all function
+// symbols, but they must still generate fresh function symbols.
+void test_known_prefix()
+{
+  function_symbol_generator bgenerator("b");
+  const function_symbol b0 = bgenerator();
+  const function_symbol b1 = bgenerator();
+  BOOST_CHECK(b0.name() == "b0" && b1.name() == "b1");
+  {
+    function_symbol_generator bgenerator1("b");
+    BOOST_CHECK(bgenerator1().name() == "b2");
+  }
+
+  function_symbol b20("b20", 0);
+  BOOST_CHECK(bgenerator().name() == "b21");
+  function_symbol_generator bgenerator2("b");
+  BOOST_CHECK(bgenerator2().name() == "b22");
+
+  // After clear, a generator may reuse its own names, but a new generator may not.
+  bgenerator.clear();
+  function_symbol_generator bgenerator3("b");
+  BOOST_CHECK(bgenerator3().name() == "b23");
+
+  // Large numbers, and numbers that do not fit, are handled as well.
+  function_symbol b_large("b18446744073709551614", 0);
+  function_symbol b_too_large("b99999999999999999999", 0);
+  function_symbol_generator cgenerator("c");
+  function_symbol c_large("c1000000", 0);
+  BOOST_CHECK(cgenerator().name() == "c1000001");
+}
+
+void test_reserve()
+{
+  detail::reserve_function_symbols(100000);
+  function_symbol_generator generator("r");
+  for (size_t i = 0; i < 100000; ++i)
+  {
+    BOOST_CHECK(generator(1).arity() == 1);
+  }
+}
+
 int test_main(int argc, char* argv[])
 {
   test_generator();
+  test_known_prefix();
+  test_reserve();
 
   return 0;
 }
@@ -0,0 +1,61 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file garbage_collection_test.cpp
+/// \brief Test the incremental garbage collector.
+
+#include <vector>
+#include <boost/test/minimal.hpp>
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/garbage_collection.h"
+
+using namespace atermpp;
+
+void test_incremental_garbage_collection()
+{
+  set_incremental_garbage_collection(4);
+  const garbage_collection_statistics& statistics=get_garbage_collection_statistics();
+  const size_t reclaimed_before=statistics.number_of_reclaimed_terms;
+
+  function_symbol f("f",2);
+  std::vector<aterm_appl> kept;
+  for(size_t i=0; i<200000; ++i)
+  {
+    // Only every hundredth term is kept; the others become garbage immediately.
+    aterm_appl t(f,aterm_int(i),aterm_int(i+1));
+    if (i%100==0)
+    {
+      kept.push_back(t);
+    }
+  }
+
+  BOOST_CHECK(statistics.number_of_slices>0);
+  BOOST_CHECK(statistics.number_of_reclaimed_terms>reclaimed_before);
+  BOOST_CHECK(statistics.maximal_pause<=statistics.total_time);
+
+  // The terms that were kept must have survived the collections.
+  for(size_t j=0; j<kept.size(); ++j)
+  {
+    BOOST_CHECK(kept[j]==aterm_appl(f,aterm_int(100*j),aterm_int(100*j+1)));
+    BOOST_CHECK(aterm_int(kept[j][0]).value()==100*j);
+  }
+
+  // A complete collection is still possible in incremental mode.
+  const size_t collections_before=statistics.number_of_collections;
+  detail::collect_terms_with_reference_count_0();
+  BOOST_CHECK(statistics.number_of_collections==collections_before+1);
+  set_incremental_garbage_collection(0);
+}
+
+int test_main(int argc, char* argv[])
+{
+  test_incremental_garbage_collection();
+  return 0;
+}
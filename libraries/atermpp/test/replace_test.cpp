@@ -263,6 +263,52 @@ void test3()
   BOOST_CHECK(t3 == t4);
 }
 
+// Returns f(f(...,...),f(...,...)) of depth n with leaves x, which is a tree of size 2^n,
+// but has only n+1 distinct subterms.
+static aterm_appl shared_term(const size_t n, const aterm_appl& x)
+{
+  aterm_appl result = x;
+  for (size_t i = 0; i < n; ++i)
+  {
+    result = aterm_appl(f2(), result, result);
+  }
+  return result;
+}
+
+void test_memoized()
+{
+  aterm x = read_term_from_string("g(f(x),f(y),[h(f(x)),f(x)],h(f(x)))");
+  BOOST_CHECK(memoized_replace(x, fg_replacer()) == replace(x, fg_replacer()));
+  BOOST_CHECK(memoized_bottom_up_replace(x, fg_replacer()) == bottom_up_replace(x, fg_replacer()));
+  BOOST_CHECK(memoized_find_if(x, is_f()) == find_if(x, is_f()));
+  BOOST_CHECK(memoized_find_if(x, is_z()) == aterm_appl());
+
+  aterm t = read_term_from_string("PBES(PBInit(PropVarInst(X,[OpId(@c0,SortId(Nat),131)],0)))");
+  BOOST_CHECK(memoized_replace(t, index_remover()) == replace(t, index_remover()));
+  BOOST_CHECK(memoized_bottom_up_replace(t, index_remover()) == bottom_up_replace(t, index_remover()));
+
+  // The following terms are far too large to be traversed as trees.
+  const aterm_appl a(read_term_from_string("a"));
+  const aterm_appl b(read_term_from_string("b"));
+  const aterm_appl s = shared_term(200, a);
+  BOOST_CHECK(memoized_replace(s, a, b) == shared_term(200, b));
+  BOOST_CHECK(memoized_bottom_up_replace(s, detail::default_bottom_up_replace(a, b)) == shared_term(200, b));
+  BOOST_CHECK(memoized_find_if(s, is_z()) == aterm_appl());
+  aterm_list ls;
+  ls.push_front(s);
+  BOOST_CHECK(memoized_find_if(ls, is_a_or_b()) == a);
+
+  // Long lists are not traversed recursively.
+  aterm_list l;
+  for (size_t i = 0; i < 1000000; ++i)
+  {
+    l.push_front(a);
+  }
+  const aterm_list l1 = memoized_replace(l, a, b);
+  BOOST_CHECK(l1.size() == l.size() && l1.front() == b);
+  BOOST_CHECK(memoized_find_if(l, is_g()) == aterm_appl());
+}
+
 int test_main(int argc, char** argv)
 {
   test_find();
@@ -270,6 +316,7 @@ int test_main(int argc, char** argv)
   test1();
   test2();
   test3();
+  test_memoized();
 
   return 0;
 }
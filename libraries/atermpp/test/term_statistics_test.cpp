@@ -0,0 +1,69 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file term_statistics_test.cpp
+/// \brief Test the statistics about the term store.
+
+#include <sstream>
+#include <vector>
+#include <boost/test/minimal.hpp>
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/term_statistics.h"
+
+using namespace atermpp;
+
+void test_term_statistics()
+{
+  function_symbol f("term_statistics_test_f",2);
+  std::vector<aterm_appl> terms;
+  for(size_t i=0; i<1000; ++i)
+  {
+    terms.push_back(aterm_appl(f,aterm_int(i),aterm_int(i)));
+  }
+
+  const term_statistics s=get_term_statistics();
+  bool found=false;
+  for(const function_symbol_statistics& fs: s.function_symbols)
+  {
+    if (fs.name=="term_statistics_test_f")
+    {
+      found=true;
+      BOOST_CHECK(fs.arity==2);
+      BOOST_CHECK(fs.referenced_terms==1000);
+      BOOST_CHECK(fs.bytes>=1000*(sizeof(detail::_aterm)+2*sizeof(aterm)));
+    }
+  }
+  BOOST_CHECK(found);
+
+  for(size_t i=1; i<s.function_symbols.size(); ++i)
+  {
+    BOOST_CHECK(s.function_symbols[i-1].bytes>=s.function_symbols[i].bytes);
+  }
+
+  size_t terms_in_blocks=0;
+  for(const size_class_statistics& c: s.size_classes)
+  {
+    BOOST_CHECK(c.number_of_blocks>0);
+    terms_in_blocks+=c.referenced_terms+c.unreferenced_terms;
+  }
+  BOOST_CHECK(terms_in_blocks==s.terms_in_hashtable);
+  BOOST_CHECK(s.longest_chain>0);
+  BOOST_CHECK(s.number_of_chains<=s.terms_in_hashtable);
+
+  std::ostringstream out;
+  print_term_statistics(out,5);
+  BOOST_CHECK(out.str().find("term_statistics_test_f/2")!=std::string::npos);
+}
+
+int test_main(int argc, char* argv[])
+{
+  test_term_statistics();
+  return 0;
+}
@@ -0,0 +1,79 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file thread_safety_test.cpp
+/// \brief Test the creation of terms from several threads. If the term
+///        library is not thread safe, the workers are run one after another.
+
+#include <vector>
+#include <boost/test/minimal.hpp>
+
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+#include <thread>
+#endif
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_list.h"
+
+using namespace atermpp;
+
+static const size_t number_of_workers=4;
+static const size_t number_of_terms=20000;
+
+// Builds the same terms in every worker; maximal sharing requires the results to be equal.
+static void build_terms(std::vector<aterm_appl>& result)
+{
+  function_symbol f("f",2);
+  function_symbol g("g",1);
+  for(size_t i=0; i<number_of_terms; ++i)
+  {
+    aterm_appl t(g,aterm_int(i));
+    term_list<aterm> l;
+    l.push_front(t);
+    l.push_front(aterm_int(i%7));
+    result.push_back(aterm_appl(f,t,l));
+  }
+}
+
+void test_concurrent_creation()
+{
+  std::vector<std::vector<aterm_appl> > results(number_of_workers);
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+  std::vector<std::thread> workers;
+  for(size_t i=0; i<number_of_workers; ++i)
+  {
+    workers.push_back(std::thread(build_terms,std::ref(results[i])));
+  }
+  for(std::thread& w: workers)
+  {
+    w.join();
+  }
+#else
+  for(size_t i=0; i<number_of_workers; ++i)
+  {
+    build_terms(results[i]);
+  }
+#endif
+
+  for(size_t i=1; i<number_of_workers; ++i)
+  {
+    BOOST_CHECK(results[i].size()==number_of_terms);
+    for(size_t j=0; j<number_of_terms; ++j)
+    {
+      // Equal terms must have the same address.
+      BOOST_CHECK(results[0][j]==results[i][j]);
+    }
+  }
+}
+
+int test_main(int argc, char* argv[])
+{
+  test_concurrent_creation();
+  return 0;
+}
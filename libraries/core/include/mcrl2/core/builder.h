@@ -14,6 +14,7 @@
 
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
 
 #include "mcrl2/atermpp/container_utility.h"
 #include "mcrl2/core/identifier_string.h"
@@ -181,6 +182,56 @@ make_update_apply_builder(const Function& f)
   return update_apply_builder<Builder, Function>(f);
 }
 
+// apply a builder without additional template arguments, and memoize its results on terms of type Term.
+// Each distinct subterm of type Term is traversed only once, which makes the builder linear in the
+// size of the term as a DAG instead of as a tree. This is only correct if the result on a subterm
+// does not depend on its context, e.g. on the variables that are bound at its position. Note that
+// enter and leave are not called for subterms whose result is found in the cache.
+template <template <class> class Builder, class Function, class Term>
+struct memoizing_update_apply_builder: public Builder<memoizing_update_apply_builder<Builder, Function, Term> >
+{
+  typedef Builder<memoizing_update_apply_builder<Builder, Function, Term> > super;
+
+  using super::enter;
+  using super::leave;
+  using super::apply;
+  using super::update;
+
+  typedef typename Function::result_type result_type;
+  typedef typename Function::argument_type argument_type;
+
+  const Function& f_;
+  std::unordered_map<atermpp::aterm, atermpp::aterm> m_cache;
+
+  result_type apply(const argument_type& x)
+  {
+    return f_(x);
+  }
+
+  Term apply(const Term& x)
+  {
+    const std::unordered_map<atermpp::aterm, atermpp::aterm>::const_iterator i = m_cache.find(x);
+    if (i != m_cache.end())
+    {
+      return atermpp::down_cast<Term>(i->second);
+    }
+    const Term result = super::apply(x);
+    m_cache[x] = result;
+    return result;
+  }
+
+  memoizing_update_apply_builder(const Function& f)
+    : f_(f)
+  {}
+};
+
+template <template <class> class Builder, class Term, class Function>
+memoizing_update_apply_builder<Builder, Function, Term>
+make_memoizing_update_apply_builder(const Function& f)
+{
+  return memoizing_update_apply_builder<Builder, Function, Term>(f);
+}
+
 // apply a builder with one additional template argument
 template <template <class> class Builder, class Function, class Arg1>
 class update_apply_builder_arg1: public Builder<update_apply_builder_arg1<Builder, Function, Arg1> >
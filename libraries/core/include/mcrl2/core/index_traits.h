@@ -98,6 +98,8 @@ struct index_traits
   static inline
   std::size_t insert(const KeyType& x)
   {
+    // Variables can be created by several threads if the term library is thread safe.
+    atermpp::detail::term_store_lock lock;
     auto& m = variable_index_map<Variable, KeyType>();
     auto i = m.find(x);
     if (i == m.end())
@@ -125,6 +127,7 @@ struct index_traits
   static inline
   void erase(const KeyType& x)
   {
+    atermpp::detail::term_store_lock lock;
     auto& m = variable_index_map<Variable, KeyType>();
     auto& s = variable_map_free_numbers<Variable, KeyType>();
     auto i = m.find(x);
@@ -442,6 +442,26 @@ class BDD_Prover: protected rewriter
 
   protected:
 
+    void initialise(bool a_path_eliminator, smt_solver_type a_solver_type, bool a_apply_induction)
+    {
+      f_reverse = true;
+      f_full = true;
+      f_apply_induction = a_apply_induction;
+      f_info.set_reverse(f_reverse);
+      f_info.set_full(f_full);
+      mCRL2log(log::debug) << "Flags:" << std::endl
+                      << "  Reverse: " << bool_to_char_string(f_reverse) << "," << std::endl
+                      << "  Full: " << bool_to_char_string(f_full) << "," << std::endl;
+      if (a_path_eliminator)
+      {
+        f_bdd_simplifier = new BDD_Path_Eliminator(a_solver_type);
+      }
+      else
+      {
+        f_bdd_simplifier = new BDD_Simplifier();
+      }
+    }
+
     /// \brief A binary decision diagram in the internal representation of the rewriter.
     data_expression f_internal_bdd;
     substitution_type bdd_sigma;
@@ -486,6 +506,7 @@ class BDD_Prover: protected rewriter
         case(jitty):
 #ifdef MCRL2_JITTYC_AVAILABLE
         case(jitty_compiling):
+        case(jitty_tiered):
 #endif
         {
           /* These provers are ok */
@@ -505,22 +526,28 @@ class BDD_Prover: protected rewriter
         }
       }
 
-      f_reverse = true;
-      f_full = true;
-      f_apply_induction = a_apply_induction;
-      f_info.set_reverse(f_reverse);
-      f_info.set_full(f_full);
-      mCRL2log(log::debug) << "Flags:" << std::endl
-                      << "  Reverse: " << bool_to_char_string(f_reverse) << "," << std::endl
-                      << "  Full: " << bool_to_char_string(f_full) << "," << std::endl;
-      if (a_path_eliminator)
-      {
-        f_bdd_simplifier = new BDD_Path_Eliminator(a_solver_type);
-      }
-      else
-      {
-        f_bdd_simplifier = new BDD_Simplifier();
-      }
+      initialise(a_path_eliminator, a_solver_type, a_apply_induction);
+    }
+
+    /// \brief Constructor that uses the given rewriter, which must use the strategy jitty or jittyc.
+    ///        The prover does not share any mutable state with other provers if the rewriter
+    ///        is not shared.
+    BDD_Prover(
+      mcrl2::data::data_specification const& data_spec,
+      const std::shared_ptr<detail::Rewriter>& a_rewriter,
+      int a_time_limit = 0,
+      bool a_path_eliminator = false,
+      smt_solver_type a_solver_type = solver_type_cvc,
+      bool a_apply_induction = false)
+      :
+        mcrl2::data::rewriter(a_rewriter),
+                       f_manipulator(f_info),
+                       f_info(),
+                       f_induction(data_spec)
+    {
+      f_time_limit = a_time_limit;
+      f_processed = false;
+      initialise(a_path_eliminator, a_solver_type, a_apply_induction);
     }
 
     /// \brief Destructor that destroys the BDD simplifier BDD_Prover::f_bdd_simplifier.
@@ -0,0 +1,110 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/enumerator_domain_cache.h
+/// \brief A size bounded cache for the enumerated domains of finite sorts.
+
+#ifndef MCRL2_DATA_DETAIL_ENUMERATOR_DOMAIN_CACHE_H
+#define MCRL2_DATA_DETAIL_ENUMERATOR_DOMAIN_CACHE_H
+
+#include <cstddef>
+#include <map>
+#include "mcrl2/data/data_expression.h"
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+// Stores the maximal number of data expressions in an enumerator domain cache.
+// The value 0 means that no domains are cached.
+template <class T> // note, T is only a dummy
+struct enumerator_domain_cache_size
+{
+  static std::size_t size;
+};
+
+// Initialization
+template <class T>
+std::size_t enumerator_domain_cache_size<T>::size = 65536;
+
+inline
+void set_enumerator_domain_cache_size(std::size_t size)
+{
+  enumerator_domain_cache_size<std::size_t>::size = size;
+}
+
+inline
+std::size_t get_enumerator_domain_cache_size()
+{
+  return enumerator_domain_cache_size<std::size_t>::size;
+}
+
+/// \brief Stores for sorts the expressions with which the enumerator expands a variable
+///        of that sort, such that they are not computed again for every variable.
+/// \details For a finite function sort or finite set sort these are all its elements. For
+///          a sort with constructors these are the normal forms of the constructors
+///          without arguments, where a constructor with arguments is represented by a
+///          default data expression. The cache holds at most get_enumerator_domain_cache_size()
+///          expressions. Domains that do not fit anymore are not stored, such that
+///          references to stored domains remain valid.
+class enumerator_domain_cache
+{
+  protected:
+    std::map<sort_expression, data_expression_vector> m_domains;
+    std::size_t m_size;
+    std::size_t m_max_size;
+
+  public:
+    enumerator_domain_cache()
+      : m_size(0), m_max_size(get_enumerator_domain_cache_size())
+    {}
+
+    /// \brief Returns the stored domain of s, or nullptr if it is not stored.
+    const data_expression_vector* find(const sort_expression& s) const
+    {
+      auto i = m_domains.find(s);
+      return i == m_domains.end() ? nullptr : &i->second;
+    }
+
+    /// \brief Stores domain as the domain of s, if it fits in the cache.
+    /// \return The stored domain if it fits, and domain otherwise.
+    const data_expression_vector& insert(const sort_expression& s, const data_expression_vector& domain)
+    {
+      if (m_size + domain.size() > m_max_size)
+      {
+        return domain;
+      }
+      auto i = m_domains.insert(std::make_pair(s, domain));
+      if (i.second)
+      {
+        m_size += domain.size();
+      }
+      return i.first->second;
+    }
+
+    /// \brief Returns the number of stored expressions.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    void clear()
+    {
+      m_domains.clear();
+      m_size = 0;
+    }
+};
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_ENUMERATOR_DOMAIN_CACHE_H
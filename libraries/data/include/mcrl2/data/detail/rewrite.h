@@ -11,12 +11,15 @@
 #ifndef __LIBREWRITE_H
 #define __LIBREWRITE_H
 
+#include <memory>
+#include <vector>
 #include "mcrl2/atermpp/aterm_int.h"
 #include "mcrl2/data/data_specification.h"
 #include "mcrl2/data/selection.h"
 #include "mcrl2/data/rewrite_strategy.h"
 #include "mcrl2/data/set_identifier_generator.h"
 #include "mcrl2/data/substitutions/mutable_indexed_substitution.h"
+#include "mcrl2/data/detail/enumerator_domain_cache.h"
 
 namespace mcrl2
 {
@@ -64,6 +67,16 @@ class Rewriter
 
     }
 
+    /** \brief Copy constructor, used by clone(). The rewriters that are used to eliminate
+     *         quantifiers in parallel are not shared with the copy.
+     **/
+    Rewriter(const Rewriter& other):
+          generator(other.generator),
+          data_equation_selector(other.data_equation_selector),
+          m_data_specification_for_enumeration(other.m_data_specification_for_enumeration),
+          m_enumerator_domain_cache(other.m_enumerator_domain_cache)
+    {}
+
     /** \brief Destructor. */
     virtual ~Rewriter()
     {
@@ -75,6 +88,16 @@ class Rewriter
       return generator;
     }
 
+    /**
+     * \brief Create a rewriter with the same rewrite rules and strategy, that does not
+     *        share any mutable state with this rewriter.
+     * \details The data specification is not preprocessed again, and a compiled rewriter
+     *          is not compiled again. If the term library is thread safe, the clone can be
+     *          used in another thread than this rewriter.
+     * \return A (pointer to a) new rewriter.
+     **/
+    virtual Rewriter* clone() = 0;
+
     /**
      * \brief Get rewriter strategy that is used.
      * \return Used rewriter strategy.
@@ -98,6 +121,17 @@ class Rewriter
      **/
     virtual data_expression_list rewrite_list(const data_expression_list& terms, substitution_type& sigma);
 
+    /**
+     * \brief Rewrite a sequence of mCRL2 data terms, all with the same substitution.
+     * \details Variables are replaced by their value under sigma without invoking the
+     *          rewriter, and a term that occurs more than once is rewritten only once.
+     * \param terms The terms to be rewritten.
+     * \param size The number of terms.
+     * \param result An array of at least size elements, in which the normal forms
+     *        of the terms are stored.
+     **/
+    virtual void rewrite_vector(const data_expression* terms, std::size_t size, data_expression* result, substitution_type& sigma);
+
     /** 
      * \brief Provide the rewriter with a () operator, such that it can also
      *        rewrite terms using this operator.
@@ -158,6 +192,59 @@ class Rewriter
   protected:
 
     const mcrl2::data::data_specification m_data_specification_for_enumeration;
+
+    // The domains of sorts that are used when quantifiers are eliminated by enumeration.
+    enumerator_domain_cache m_enumerator_domain_cache;
+
+    // Clones of this rewriter that enumerate quantifiers in other threads, if
+    // get_enumerator_thread_count() is larger than one. They are created when needed.
+    std::vector<std::shared_ptr<Rewriter> > m_enumeration_workers;
+
+    // Enumerates the solutions of the quantified variables vl in the rewritten body t with
+    // this rewriter and its enumeration workers, each in its own thread.
+    template <class EnumeratorListElement, class Filter, class IsFinal>
+    void parallel_quantifier_enumeration(const variable_list& vl,
+                                         const data_expression& t,
+                                         substitution_type& sigma,
+                                         IsFinal is_final,
+                                         std::vector<EnumeratorListElement>& solutions);
+
+    // Implements rewrite_vector, where rewrite_term(t) rewrites a single term t under sigma.
+    // Terms that are not variables are compared with the earlier terms that are not
+    // variables, which are few for the state vectors of a typical summand.
+    template <class RewriteTerm>
+    void rewrite_vector_with(const data_expression* terms,
+                             std::size_t size,
+                             data_expression* result,
+                             substitution_type& sigma,
+                             RewriteTerm rewrite_term)
+    {
+      std::vector<std::size_t> rewritten;
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        const data_expression& t = terms[i];
+        if (is_variable(t))
+        {
+          result[i] = sigma(atermpp::down_cast<variable>(t));
+          continue;
+        }
+        std::vector<std::size_t>::const_iterator j = rewritten.begin();
+        while (j != rewritten.end() && terms[*j] != t)
+        {
+          ++j;
+        }
+        if (j != rewritten.end())
+        {
+          result[i] = result[*j];
+        }
+        else
+        {
+          result[i] = rewrite_term(t);
+          rewritten.push_back(i);
+        }
+      }
+    }
+
     data_expression quantifier_enumeration(
          const data_expression& termInInnerFormat,
          substitution_type& sigma);
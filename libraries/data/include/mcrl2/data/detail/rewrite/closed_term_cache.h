@@ -0,0 +1,152 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite/closed_term_cache.h
+/// \brief A size bounded cache for the normal forms of closed data expressions.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_CLOSED_TERM_CACHE_H
+#define MCRL2_DATA_DETAIL_REWRITE_CLOSED_TERM_CACHE_H
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "mcrl2/data/data_expression.h"
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+// Stores the number of entries of the normal form cache of the jitty rewriter.
+// The value 0 means that no cache is used.
+template <class T> // note, T is only a dummy
+struct closed_term_cache_size
+{
+  static std::size_t size;
+};
+
+// Initialization
+template <class T>
+std::size_t closed_term_cache_size<T>::size = 0;
+
+inline
+void set_closed_term_cache_size(std::size_t size)
+{
+  closed_term_cache_size<std::size_t>::size = size;
+}
+
+inline
+std::size_t get_closed_term_cache_size()
+{
+  return closed_term_cache_size<std::size_t>::size;
+}
+
+/// \brief A direct mapped cache that maps data expressions to their normal forms.
+/// \details As terms are maximally shared, the position of a term in the cache is
+///          determined by its address. A term that is put in a position that is
+///          already occupied replaces the term that was there. The cache holds a
+///          reference to the terms in it, such that their addresses cannot be reused.
+///          It is up to the user to only store terms of which the normal form does not
+///          depend on a substitution, such as terms without variables.
+class closed_term_cache
+{
+  protected:
+    std::vector<std::pair<data_expression, data_expression> > m_entries;
+    std::size_t m_mask;
+    std::size_t m_hits;
+    std::size_t m_misses;
+
+  public:
+    /// \brief Constructor.
+    /// \param size The number of entries, which is rounded up to a power of two.
+    ///        If size is 0 the cache is disabled.
+    closed_term_cache(const std::size_t size=0)
+      : m_mask(0),
+        m_hits(0),
+        m_misses(0)
+    {
+      if (size>0)
+      {
+        std::size_t n=1;
+        while (n<size)
+        {
+          n=n<<1;
+        }
+        m_entries.resize(n);
+        m_mask=n-1;
+      }
+    }
+
+    /// \brief Returns true if the cache has at least one entry.
+    bool enabled() const
+    {
+      return !m_entries.empty();
+    }
+
+    /// \brief Returns a pointer to the normal form of t, or nullptr if t is not in the cache.
+    /// \pre The cache is enabled.
+    const data_expression* find(const data_expression& t)
+    {
+      assert(enabled());
+      const std::pair<data_expression, data_expression>& entry=m_entries[std::hash<atermpp::aterm>()(t) & m_mask];
+      if (entry.first==t)
+      {
+        m_hits++;
+        return &entry.second;
+      }
+      return nullptr;
+    }
+
+    /// \brief Stores normal_form as the normal form of t.
+    /// \details This is counted as a miss, as it is assumed that t has been looked up before.
+    /// \pre The cache is enabled.
+    void insert(const data_expression& t, const data_expression& normal_form)
+    {
+      assert(enabled());
+      std::pair<data_expression, data_expression>& entry=m_entries[std::hash<atermpp::aterm>()(t) & m_mask];
+      entry.first=t;
+      entry.second=normal_form;
+      m_misses++;
+    }
+
+    /// \brief Removes all terms from the cache. The statistics are kept.
+    void clear()
+    {
+      for (std::pair<data_expression, data_expression>& entry: m_entries)
+      {
+        entry=std::pair<data_expression, data_expression>();
+      }
+    }
+
+    /// \brief The number of entries of the cache.
+    std::size_t size() const
+    {
+      return m_entries.size();
+    }
+
+    /// \brief The number of times a term was found in the cache.
+    std::size_t hits() const
+    {
+      return m_hits;
+    }
+
+    /// \brief The number of times the normal form of a term had to be calculated and was stored.
+    std::size_t misses() const
+    {
+      return m_misses;
+    }
+};
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_CLOSED_TERM_CACHE_H
@@ -11,9 +11,16 @@
 #ifndef __REWR_JITTY_H
 #define __REWR_JITTY_H
 
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 #include "mcrl2/data/detail/rewrite.h"
 #include "mcrl2/data/data_specification.h"
 #include "mcrl2/data/detail/rewrite/strategy_rule.h"
+#include "mcrl2/data/detail/rewrite/closed_term_cache.h"
+#include "mcrl2/data/detail/rewrite/native_arithmetic.h"
+#include "mcrl2/data/detail/rewrite/rewrite_profile.h"
 
 namespace mcrl2
 {
@@ -22,24 +29,95 @@ namespace data
 namespace detail
 {
 
+/// \brief A step in the strategy of a function symbol in the jitty rewriter. It either
+///        rewrites an argument, or it tries a block of consecutive equations in order.
+/// \details The equations of a block are indexed on the head symbol of one of the arguments
+///          that are rewritten before the block is reached. Only the equations of which the
+///          left hand side has the head symbol of the rewritten argument at this position, or
+///          has no function symbol as head at this position, can match. Only these are tried.
+class jitty_strategy_step
+{
+  protected:
+    typedef std::unordered_map<function_symbol, std::vector<size_t>, std::hash<atermpp::aterm> > index_type;
+
+    size_t m_rewrite_index;                      // The argument to be rewritten, or npos for a block of equations.
+    std::vector<data_equation> m_equations;
+    size_t m_index_position;                     // The argument on which the equations are indexed, or npos.
+    index_type m_index;                          // The equations that can match, per head symbol of the argument.
+    std::vector<size_t> m_unindexed_equations;   // The equations that can match if the head symbol is not in the index.
+
+  public:
+    static const size_t npos=std::numeric_limits<size_t>::max();
+
+    /// \brief A step that rewrites the argument with index i.
+    jitty_strategy_step(const size_t i)
+     : m_rewrite_index(i),
+       m_index_position(npos)
+    {}
+
+    /// \brief A step that tries the given equations.
+    /// \param rewritten_arguments Indicates which arguments have been rewritten before this step.
+    jitty_strategy_step(const std::vector<data_equation>& equations, const std::vector<bool>& rewritten_arguments);
+
+    bool is_rewrite_index() const
+    {
+      return m_rewrite_index!=npos;
+    }
+
+    size_t rewrite_index() const
+    {
+      assert(is_rewrite_index());
+      return m_rewrite_index;
+    }
+
+    const data_equation& equation(const size_t i) const
+    {
+      return m_equations[i];
+    }
+
+    /// \brief The argument on which the equations are indexed, or npos if they are not indexed.
+    size_t index_position() const
+    {
+      return m_index_position;
+    }
+
+    /// \brief The indices of the equations that can match, in the order in which they must be tried.
+    /// \param argument The rewritten argument at the index position. It is ignored if the equations are
+    ///        not indexed.
+    const std::vector<size_t>& candidate_equations(const data_expression& argument) const;
+};
+
+typedef std::vector<jitty_strategy_step> jitty_strategy;
+
 class RewriterJitty: public Rewriter
 {
   public:
     typedef Rewriter::substitution_type substitution_type;
 
     RewriterJitty(const data_specification& data_spec, const used_data_equation_selector &);
+
+    /// \brief Copy constructor. The copy shares no mutable state with other.
+    RewriterJitty(const RewriterJitty& other);
+
     virtual ~RewriterJitty();
 
+    Rewriter* clone();
+
     rewrite_strategy getStrategy();
 
     data_expression rewrite(const data_expression &term, substitution_type &sigma);
 
+    void rewrite_vector(const data_expression* terms, std::size_t size, data_expression* result, substitution_type& sigma);
+
   private:
     size_t max_vars;
 
     std::map< function_symbol, data_equation_list > jitty_eqns;
-    std::vector<strategy> jitty_strat;
+    std::deque<jitty_strategy> jitty_strat; // A deque, as references to its elements remain valid when it grows.
     size_t MAX_LEN; 
+    closed_term_cache m_normal_forms; // The normal forms of closed terms, if enabled.
+    rewrite_profile* m_profile; // The profile in which statistics are collected, or nullptr.
+    native_arithmetic m_native_arithmetic; // Evaluates arithmetic on numeric constants.
     data_expression rewrite_aux(const data_expression& term, substitution_type& sigma);
     void build_strategies();
 
@@ -48,10 +126,18 @@ class RewriterJitty: public Rewriter
                       const data_expression& term,
                       substitution_type& sigma);
 
+    /* As rewrite_aux_function_symbol, but the normal form of term is looked up in
+       and stored in the normal form cache. */
+    data_expression rewrite_aux_function_symbol_cached(
+                      const function_symbol& op,
+                      const data_expression& term,
+                      substitution_type& sigma);
+
     /* Auxiliary function to take care that the array jitty_strat is sufficiently large
        to access element i */
     void make_jitty_strat_sufficiently_larger(const size_t i);
     strategy create_strategy(const data_equation_list& rules1);
+    jitty_strategy create_indexed_strategy(const strategy& strat);
     void rebuild_strategy();
 };
 
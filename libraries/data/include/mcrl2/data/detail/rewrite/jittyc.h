@@ -21,8 +21,12 @@
 
 #ifdef MCRL2_JITTYC_AVAILABLE
 
+#include <atomic>
+#include <map>
+#include <thread>
 #include <utility>
 #include <string>
+#include <vector>
 
 namespace mcrl2
 {
@@ -39,11 +43,17 @@ typedef std::vector < sort_expression_list> sort_list_vector;
 ///        in it will not be freed by the ATerm library, and can therefore be used
 ///        in the generated jittyc code.
 ///
+///        The generated code refers to the stored terms by their position in the
+///        array term_table, which is set by the generated library when it is loaded.
+///        As the generated code does not contain any addresses of terms, a library
+///        compiled by another process can be reused by the compiled library cache.
+///
 class normal_form_cache
 {
 private:
   RewriterJitty& m_rewriter;
-  std::set<data_expression> m_lookup;
+  std::vector<data_expression> m_terms;
+  std::map<data_expression, size_t> m_indices;
 public:
   normal_form_cache(RewriterJitty& rewriter)
     : m_rewriter(rewriter)
@@ -59,20 +69,54 @@ public:
   ///
   std::string insert(const data_expression& t)
   {
-    std::stringstream ss;
     RewriterJitty::substitution_type sigma;
-    auto pair = m_lookup.insert(m_rewriter(t, sigma));
-    ss << "*reinterpret_cast<const data_expression*>(" << (void*)&(*pair.first) << ")";
+    return insert_term(m_rewriter(t, sigma));
+  }
+
+  ///
+  /// \brief insert_term stores t itself, without normalising it.
+  /// \param t The term to store.
+  /// \return A C++ string that evaluates to the stored term t.
+  ///
+  std::string insert_term(const data_expression& t)
+  {
+    std::stringstream ss;
+    auto pair = m_indices.insert(std::make_pair(t, m_terms.size()));
+    if (pair.second)
+    {
+      m_terms.push_back(t);
+    }
+    ss << "term_table[" << pair.first->second << "]";
     return ss.str();
   }
 
+  ///
+  /// \brief terms returns the stored terms, in the order in which term_table refers
+  ///        to them.
+  ///
+  const std::vector<data_expression>& terms() const
+  {
+    return m_terms;
+  }
+
+  ///
+  /// \brief assign replaces the stored terms by those of other, such that the
+  ///        C++ strings obtained from other can be used with this cache.
+  ///
+  void assign(const normal_form_cache& other)
+  {
+    m_terms = other.m_terms;
+    m_indices = other.m_indices;
+  }
+
   ///
   /// \brief clear clears the cache. This operation invalidates all the C++ strings
   ///        obtained via the insert() method.
   ///
   void clear()
   {
-    m_lookup.clear();
+    m_terms.clear();
+    m_indices.clear();
   }
 };
 
@@ -81,13 +125,31 @@ class RewriterCompilingJitty: public Rewriter
   public:
     typedef Rewriter::substitution_type substitution_type;
 
-    RewriterCompilingJitty(const data_specification& DataSpec, const used_data_equation_selector &);
+    /// \brief Constructor.
+    /// \param compile_in_background If true, the rewriter is compiled in a separate thread,
+    ///        and terms are rewritten with the jitty rewriter until the compiled rewriter
+    ///        has been loaded. This is the strategy jittyt.
+    RewriterCompilingJitty(const data_specification& DataSpec, const used_data_equation_selector &, bool compile_in_background = false);
     virtual ~RewriterCompilingJitty();
 
+    /// \brief Returns a copy of this rewriter. The copy loads its own copy of the
+    ///        compiled rewriter, such that it does not share any state with this
+    ///        rewriter. The rewrite system is not compiled again.
+    Rewriter* clone();
+
     rewrite_strategy getStrategy();
 
+    /// \brief Returns true if terms are rewritten with the compiled rewriter. For the
+    ///        strategy jittyt this is false until the compiled rewriter has been loaded.
+    bool uses_compiled_rewriter() const
+    {
+      return so_rewr != NULL;
+    }
+
     data_expression rewrite(const data_expression &term, substitution_type &sigma);
 
+    void rewrite_vector(const data_expression* terms, std::size_t size, data_expression* result, substitution_type& sigma);
+
     substitution_type *global_sigma;
 
     // The data structures below are used to store the variable lists2
@@ -113,7 +175,29 @@ class RewriterCompilingJitty: public Rewriter
       return (rewriter_bound_variables[i]);
     }
 
+    // The terms to which the generated code refers. The generated library
+    // stores a pointer to these terms in its term_table when it is loaded.
+    const data_expression* generated_terms() const
+    {
+      return m_nf_cache.terms().data();
+    }
+
+    // Evaluates arithmetic on constants of sort Pos, Nat and Int natively, see native_arithmetic.h.
+    bool evaluate_natively(const function_symbol& f, const data_expression* arguments, data_expression& result)
+    {
+      return m_native_arithmetic.evaluate(f, arguments, result);
+    }
+
+    // The statistics to which the generated code refers when the rewriter is profiled.
+    rewrite_profile_statistics& profile_statistics(const size_t i)
+    {
+      return *m_profile_statistics[i];
+    }
+
   private:
+    // Constructor used by clone().
+    RewriterCompilingJitty(RewriterCompilingJitty& other);
+
     class ImplementTree;
     friend class ImplementTree;
     
@@ -124,9 +208,22 @@ class RewriterCompilingJitty: public Rewriter
     std::set<function_symbol> m_extra_symbols;
 
     normal_form_cache m_nf_cache;
+    native_arithmetic m_native_arithmetic;
+
+    // The profile in which statistics are collected, or nullptr, and the statistics
+    // to which the generated code refers by their index.
+    rewrite_profile* m_profile;
+    std::vector<rewrite_profile_statistics*> m_profile_statistics;
+    std::map<rewrite_profile_statistics*, size_t> m_profile_statistics_indices;
+    size_t profile_statistics_index(rewrite_profile_statistics& s);
 
     uncompiled_library *rewriter_so;
 
+    // A descriptor of the loaded library, which is used to copy the library when
+    // the rewriter is cloned, also after the file has been removed. It is -1 if
+    // no library has been loaded.
+    int m_library_descriptor;
+
     void (*so_rewr_cleanup)();
     data_expression(*so_rewr)(const data_expression&);
 
@@ -135,9 +232,27 @@ class RewriterCompilingJitty: public Rewriter
     bool opid_is_nf(const function_symbol &opid, size_t num_args);
     void calc_nfs_list(nfs_array &a, const application& args, variable_or_number_list nnfvars);
     bool calc_nfs(const data_expression& t, variable_or_number_list nnfvars);
+    // The generated source file, and the key under which the compiled library is
+    // stored in the compiled library cache (empty if the cache is not used).
+    std::string m_cpp_file;
+    std::string m_cache_key;
+
+    // State of a compilation in the background, see the constructor.
+    bool m_compile_in_background;
+    std::thread m_compile_thread;
+    std::atomic<bool> m_compilation_finished;
+    bool m_compilation_failed;
+    std::string m_compilation_error;
+
     void CleanupRewriteSystem();
     void BuildRewriteSystem();
+    bool GenerateRewriteSystem();
+    void CompileRewriteSystem();
+    void LoadRewriteSystem();
+    void StartBackgroundCompilation();
+    bool FinishBackgroundCompilation();
     void generate_code(const std::string& filename);
+    std::string compiled_library_key(const std::string& cpp_file, const std::string& compile_script);
     void generate_rewr_functions(std::ostream& s, const data::function_symbol& func, const data_equation_list& eqs);
     bool lift_rewrite_rule_to_right_arity(data_equation& e, const size_t requested_arity);
     sort_list_vector get_residual_sorts(const sort_expression& s, const size_t actual_arity, const size_t requested_arity);
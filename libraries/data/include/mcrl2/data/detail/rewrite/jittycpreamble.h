@@ -125,6 +125,7 @@ struct rewrite_functor
 // Declaration of global variables
 //
 static RewriterCompilingJitty *this_rewriter;
+static const data_expression* term_table;
 static rewriter_function functions_when_arguments_are_not_in_normal_form[ARITY_BOUND * INDEX_BOUND] = {};
 static rewriter_function functions_when_arguments_are_in_normal_form[ARITY_BOUND * INDEX_BOUND] = {};
 // static const application dummy_application;
@@ -347,6 +348,7 @@ bool init(rewriter_interface* i)
   i->rewrite_external = &rewrite;
   i->rewrite_cleanup = &rewrite_cleanup;
   this_rewriter = i->rewriter;
+  term_table = this_rewriter->generated_terms();
   set_the_precompiled_rewrite_functions_in_a_lookup_table();
   i->status = "rewriter loaded successfully.";
   return true;
@@ -0,0 +1,536 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite/native_arithmetic.h
+/// \brief Native evaluation of arithmetic on constants of sort Pos, Nat and Int.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_NATIVE_ARITHMETIC_H
+#define MCRL2_DATA_DETAIL_REWRITE_NATIVE_ARITHMETIC_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "mcrl2/data/int.h"
+#include "mcrl2/data/standard.h"
+#include "mcrl2/utilities/big_numbers.h"
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+/// \brief Evaluates arithmetic operations on constants of sort Pos, Nat and Int natively,
+///        instead of by applying the equations on their binary representation.
+/// \details Numbers are represented by the constructors \@c1 and \@cDub for Pos, \@c0 and
+///          \@cNat for Nat, and \@cInt and \@cNeg for Int. For instance x+1 with x a constant
+///          requires a number of rewrite steps that is linear in the number of bits of x.
+///          This class computes the result of +, -, *, div, mod, max, min, succ, pred, abs,
+///          \@monus and the comparisons on such constants in machine words, and falls back
+///          to big natural numbers if the arguments or the result do not fit in a word.
+///          The result is the normal form of the operation applied to the arguments.
+class native_arithmetic
+{
+  public:
+    enum operation_type
+    {
+      unknown, none,
+      plus, minus, negate, times, div, mod, maximum, minimum, succ, pred, abs, monus,
+      equal_to, not_equal_to, less, less_equal, greater, greater_equal
+    };
+
+  protected:
+    // The operations of the function symbols, indexed by the index of the function symbol.
+    std::vector<operation_type> m_operations;
+
+    typedef utilities::big_natural_number big_natural_number;
+
+    // The outcome of an evaluation. If arguments or intermediate results are too large
+    // for a machine word, the evaluation is repeated with big natural numbers.
+    enum evaluation_result { not_evaluated, too_large, evaluated };
+
+    static bool is_zero(std::size_t n)
+    {
+      return n == 0;
+    }
+
+    static bool is_zero(const big_natural_number& n)
+    {
+      return n.is_zero();
+    }
+
+    template <typename Natural>
+    struct number
+    {
+      bool negative;
+      Natural magnitude;
+
+      number()
+        : negative(false), magnitude(0)
+      {}
+
+      number(bool negative_, const Natural& magnitude_)
+        : negative(negative_ && !is_zero(magnitude_)), magnitude(magnitude_)
+      {}
+    };
+
+    // Operations on magnitudes. The operations on machine words return false if the
+    // result does not fit in a machine word.
+
+    static bool add(std::size_t n, std::size_t m, std::size_t& result)
+    {
+      if (n > std::numeric_limits<std::size_t>::max() - m)
+      {
+        return false;
+      }
+      result = n + m;
+      return true;
+    }
+
+    static bool add(const big_natural_number& n, const big_natural_number& m, big_natural_number& result)
+    {
+      result = n + m;
+      return true;
+    }
+
+    static bool multiply(std::size_t n, std::size_t m, std::size_t& result)
+    {
+      if (n != 0 && m > std::numeric_limits<std::size_t>::max() / n)
+      {
+        return false;
+      }
+      result = n * m;
+      return true;
+    }
+
+    static bool multiply(const big_natural_number& n, const big_natural_number& m, big_natural_number& result)
+    {
+      result = n * m;
+      return true;
+    }
+
+    // Returns the least significant bit of n, and divides n by two.
+    static bool shift_right(std::size_t& n)
+    {
+      const bool result = (n & 1) != 0;
+      n >>= 1;
+      return result;
+    }
+
+    static bool shift_right(big_natural_number& n)
+    {
+      return n.divide_by(2) != 0;
+    }
+
+    // Compares the signed numbers x and y, and returns -1, 0 or 1.
+    template <typename Natural>
+    static int compare(const number<Natural>& x, const number<Natural>& y)
+    {
+      if (x.negative != y.negative)
+      {
+        return x.negative ? -1 : 1;
+      }
+      const int c = (x.magnitude < y.magnitude ? -1 : (y.magnitude < x.magnitude ? 1 : 0));
+      return x.negative ? -c : c;
+    }
+
+    template <typename Natural>
+    static bool add(const number<Natural>& x, const number<Natural>& y, number<Natural>& result)
+    {
+      if (x.negative == y.negative)
+      {
+        Natural magnitude;
+        if (!add(x.magnitude, y.magnitude, magnitude))
+        {
+          return false;
+        }
+        result = number<Natural>(x.negative, magnitude);
+      }
+      else if (y.magnitude < x.magnitude)
+      {
+        result = number<Natural>(x.negative, x.magnitude - y.magnitude);
+      }
+      else
+      {
+        result = number<Natural>(y.negative, y.magnitude - x.magnitude);
+      }
+      return true;
+    }
+
+    // Calculates the quotient and the remainder of x divided by y, rounding down. The divisor y is positive.
+    template <typename Natural>
+    static void divide(const number<Natural>& x, const number<Natural>& y, number<Natural>& quotient, number<Natural>& remainder)
+    {
+      assert(!y.negative && !is_zero(y.magnitude));
+      Natural q = x.magnitude / y.magnitude;
+      Natural r = x.magnitude % y.magnitude;
+      if (x.negative && !is_zero(r))
+      {
+        // The quotient is at most the magnitude of x, so adding one cannot overflow.
+        add(q, Natural(1), q);
+        r = y.magnitude - r;
+      }
+      quotient = number<Natural>(x.negative, q);
+      remainder = number<Natural>(false, r);
+    }
+
+    // Applies the arithmetic operation op to x and y. Returns false if the result does not fit.
+    template <typename Natural>
+    static bool apply(operation_type op, const number<Natural>& x, const number<Natural>& y, number<Natural>& result)
+    {
+      number<Natural> remainder;
+      switch (op)
+      {
+        case plus: return add(x, y, result);
+        case minus: return add(x, number<Natural>(!y.negative, y.magnitude), result);
+        case negate: result = number<Natural>(!x.negative, x.magnitude); return true;
+        case times:
+        {
+          Natural magnitude;
+          if (!multiply(x.magnitude, y.magnitude, magnitude))
+          {
+            return false;
+          }
+          result = number<Natural>(x.negative != y.negative, magnitude);
+          return true;
+        }
+        case div: divide(x, y, result, remainder); return true;
+        case mod: divide(x, y, remainder, result); return true;
+        case maximum: result = (compare(x, y) < 0 ? y : x); return true;
+        case minimum: result = (compare(x, y) < 0 ? x : y); return true;
+        case succ: return add(x, number<Natural>(false, Natural(1)), result);
+        case pred: return add(x, number<Natural>(true, Natural(1)), result);
+        case abs: result = number<Natural>(false, x.magnitude); return true;
+        case monus:
+          if (compare(x, y) <= 0)
+          {
+            result = number<Natural>();
+            return true;
+          }
+          return add(x, number<Natural>(!y.negative, y.magnitude), result);
+        default: return false;
+      }
+    }
+
+    // Applies the comparison op to x and y.
+    template <typename Natural>
+    static bool compare(operation_type op, const number<Natural>& x, const number<Natural>& y)
+    {
+      const int c = compare(x, y);
+      switch (op)
+      {
+        case equal_to: return c == 0;
+        case not_equal_to: return c != 0;
+        case less: return c < 0;
+        case less_equal: return c <= 0;
+        case greater: return c > 0;
+        default: assert(op == greater_equal); return c >= 0;
+      }
+    }
+
+    // Converts the positive constant t to a number.
+    static evaluation_result positive_constant(const data_expression& t, std::size_t& result)
+    {
+      std::size_t value = 0;
+      std::size_t bit = 0;
+      const data_expression* p = &t;
+      while (sort_pos::is_cdub_application(*p))
+      {
+        const application& a = atermpp::down_cast<application>(*p);
+        if (a[0] == sort_bool::true_())
+        {
+          if (bit + 1 >= std::size_t(std::numeric_limits<std::size_t>::digits))
+          {
+            return too_large;
+          }
+          value |= std::size_t(1) << bit;
+        }
+        else if (a[0] != sort_bool::false_())
+        {
+          return not_evaluated;
+        }
+        ++bit;
+        p = &a[1];
+      }
+      if (!sort_pos::is_c1_function_symbol(*p))
+      {
+        return not_evaluated;
+      }
+      if (bit + 1 >= std::size_t(std::numeric_limits<std::size_t>::digits))
+      {
+        return too_large;
+      }
+      result = value | (std::size_t(1) << bit);
+      return evaluated;
+    }
+
+    static evaluation_result positive_constant(const data_expression& t, big_natural_number& result)
+    {
+      std::vector<bool> bits;
+      const data_expression* p = &t;
+      while (sort_pos::is_cdub_application(*p))
+      {
+        const application& a = atermpp::down_cast<application>(*p);
+        if (a[0] != sort_bool::true_() && a[0] != sort_bool::false_())
+        {
+          return not_evaluated;
+        }
+        bits.push_back(a[0] == sort_bool::true_());
+        p = &a[1];
+      }
+      if (!sort_pos::is_c1_function_symbol(*p))
+      {
+        return not_evaluated;
+      }
+      result = big_natural_number(1);
+      for (std::vector<bool>::const_reverse_iterator i = bits.rbegin(); i != bits.rend(); ++i)
+      {
+        result = result * big_natural_number(2) + big_natural_number(*i ? 1 : 0);
+      }
+      return evaluated;
+    }
+
+    // Converts a constant of sort Pos, Nat or Int to a number.
+    template <typename Natural>
+    static evaluation_result constant(const data_expression& t, number<Natural>& result)
+    {
+      if (sort_nat::is_c0_function_symbol(t))
+      {
+        result = number<Natural>();
+        return evaluated;
+      }
+      bool negative = false;
+      const data_expression* p = &t;
+      if (sort_int::is_cint_application(t))
+      {
+        p = &atermpp::down_cast<application>(t)[0];
+        if (sort_nat::is_c0_function_symbol(*p))
+        {
+          result = number<Natural>();
+          return evaluated;
+        }
+      }
+      else if (sort_int::is_cneg_application(t))
+      {
+        negative = true;
+        p = &atermpp::down_cast<application>(t)[0];
+      }
+      if (sort_nat::is_cnat_application(*p))
+      {
+        p = &atermpp::down_cast<application>(*p)[0];
+      }
+      Natural magnitude;
+      const evaluation_result r = positive_constant(*p, magnitude);
+      if (r == evaluated)
+      {
+        result = number<Natural>(negative, magnitude);
+      }
+      return r;
+    }
+
+    static data_expression positive_constant(std::size_t n)
+    {
+      assert(n > 0);
+      std::size_t mask = 1;
+      while (mask <= n / 2)
+      {
+        mask <<= 1;
+      }
+      data_expression result = sort_pos::c1();
+      for (mask >>= 1; mask != 0; mask >>= 1)
+      {
+        result = sort_pos::cdub((n & mask) != 0 ? sort_bool::true_() : sort_bool::false_(), result);
+      }
+      return result;
+    }
+
+    static data_expression positive_constant(big_natural_number n)
+    {
+      assert(!is_zero(n));
+      std::vector<bool> bits;
+      while (!is_zero(n))
+      {
+        bits.push_back(shift_right(n));
+      }
+      data_expression result = sort_pos::c1();
+      for (std::vector<bool>::const_reverse_iterator i = bits.rbegin() + 1; i != bits.rend(); ++i)
+      {
+        result = sort_pos::cdub(*i ? sort_bool::true_() : sort_bool::false_(), result);
+      }
+      return result;
+    }
+
+    // Converts x to a constant of sort s. Returns false if x is not an element of s.
+    template <typename Natural>
+    static bool constant(const number<Natural>& x, const sort_expression& s, data_expression& result)
+    {
+      if (s == sort_pos::pos())
+      {
+        if (x.negative || is_zero(x.magnitude))
+        {
+          return false;
+        }
+        result = positive_constant(x.magnitude);
+      }
+      else if (s == sort_nat::nat())
+      {
+        if (x.negative)
+        {
+          return false;
+        }
+        result = is_zero(x.magnitude) ? data_expression(sort_nat::c0()) : data_expression(sort_nat::cnat(positive_constant(x.magnitude)));
+      }
+      else
+      {
+        assert(s == sort_int::int_());
+        if (x.negative)
+        {
+          result = sort_int::cneg(positive_constant(x.magnitude));
+        }
+        else
+        {
+          result = sort_int::cint(is_zero(x.magnitude) ? data_expression(sort_nat::c0()) : data_expression(sort_nat::cnat(positive_constant(x.magnitude))));
+        }
+      }
+      return true;
+    }
+
+    template <typename Natural>
+    static evaluation_result evaluate(operation_type op, const function_sort& s, const data_expression* arguments, data_expression& result)
+    {
+      number<Natural> x;
+      number<Natural> y;
+      evaluation_result r = constant(arguments[0], x);
+      if (r == evaluated && s.domain().size() == 2)
+      {
+        r = constant(arguments[1], y);
+      }
+      if (r != evaluated)
+      {
+        return r;
+      }
+      if (op >= equal_to)
+      {
+        result = compare(op, x, y) ? sort_bool::true_() : sort_bool::false_();
+        return evaluated;
+      }
+      if ((op == div || op == mod) && (y.negative || is_zero(y.magnitude)))
+      {
+        return not_evaluated;
+      }
+      number<Natural> z;
+      if (!apply(op, x, y, z))
+      {
+        return too_large;
+      }
+      return constant(z, s.codomain(), result) ? evaluated : not_evaluated;
+    }
+
+    static bool is_number_sort(const sort_expression& s)
+    {
+      return s == sort_pos::pos() || s == sort_nat::nat() || s == sort_int::int_();
+    }
+
+    // Determines which operation f is, if any.
+    static operation_type classify(const function_symbol& f)
+    {
+      if (!is_function_sort(f.sort()))
+      {
+        return none;
+      }
+      const function_sort& s = atermpp::down_cast<function_sort>(f.sort());
+      const std::size_t arity = s.domain().size();
+      for (const sort_expression& d: s.domain())
+      {
+        if (!is_number_sort(d))
+        {
+          return none;
+        }
+      }
+      const core::identifier_string& name = f.name();
+      if (s.codomain() == sort_bool::bool_())
+      {
+        if (arity != 2)
+        {
+          return none;
+        }
+        if (name == detail::equal_symbol()) { return equal_to; }
+        if (name == detail::not_equal_symbol()) { return not_equal_to; }
+        if (name == detail::less_symbol()) { return less; }
+        if (name == detail::less_equal_symbol()) { return less_equal; }
+        if (name == detail::greater_symbol()) { return greater; }
+        if (name == detail::greater_equal_symbol()) { return greater_equal; }
+        return none;
+      }
+      if (!is_number_sort(s.codomain()))
+      {
+        return none;
+      }
+      if (arity == 1)
+      {
+        if (name == sort_int::negate_name()) { return negate; }
+        if (name == sort_nat::succ_name()) { return succ; }
+        if (name == sort_nat::pred_name()) { return pred; }
+        if (name == sort_int::abs_name()) { return abs; }
+        return none;
+      }
+      if (arity == 2)
+      {
+        if (name == sort_nat::plus_name()) { return plus; }
+        if (name == sort_int::minus_name()) { return minus; }
+        if (name == sort_nat::times_name()) { return times; }
+        if (name == sort_nat::div_name()) { return div; }
+        if (name == sort_nat::mod_name()) { return mod; }
+        if (name == sort_nat::maximum_name()) { return maximum; }
+        if (name == sort_nat::minimum_name()) { return minimum; }
+        if (name == sort_nat::monus_name()) { return monus; }
+      }
+      return none;
+    }
+
+  public:
+    /// \brief Returns the operation of function symbol f, or none if f is not an arithmetic
+    ///        operation on Pos, Nat and Int that can be evaluated natively.
+    operation_type operation(const function_symbol& f)
+    {
+      const std::size_t i = core::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(f);
+      if (i >= m_operations.size())
+      {
+        m_operations.resize(i + 1, unknown);
+      }
+      if (m_operations[i] == unknown)
+      {
+        m_operations[i] = classify(f);
+      }
+      return m_operations[i];
+    }
+
+    /// \brief Calculates the normal form of f applied to the given arguments, if f is an
+    ///        arithmetic operation and the arguments are constants.
+    /// \param arguments The arguments of f. Their number must be the arity of f.
+    /// \param result Is set to the normal form if it has been calculated.
+    /// \return Whether the normal form has been calculated.
+    bool evaluate(const function_symbol& f, const data_expression* arguments, data_expression& result)
+    {
+      const operation_type op = operation(f);
+      if (op == none)
+      {
+        return false;
+      }
+      const function_sort& s = atermpp::down_cast<function_sort>(f.sort());
+      const evaluation_result r = evaluate<std::size_t>(op, s, arguments, result);
+      return r == evaluated || (r == too_large && evaluate<big_natural_number>(op, s, arguments, result) == evaluated);
+    }
+};
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_NATIVE_ARITHMETIC_H
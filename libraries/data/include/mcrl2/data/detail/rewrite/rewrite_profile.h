@@ -0,0 +1,294 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite/rewrite_profile.h
+/// \brief Statistics on the use of data equations and function symbols by the rewriters.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_REWRITE_PROFILE_H
+#define MCRL2_DATA_DETAIL_REWRITE_REWRITE_PROFILE_H
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/data/data_equation.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+/// \brief The statistics of a single data equation or function symbol.
+struct rewrite_profile_statistics
+{
+  typedef std::chrono::steady_clock clock;
+
+  /// \brief For an equation the number of times it has been applied, for a function
+  ///        symbol the number of terms with this head symbol that have been rewritten.
+  std::size_t applications;
+
+  /// \brief For an equation the number of times its left hand side or its condition
+  ///        did not match. Not used for function symbols.
+  std::size_t failures;
+
+  /// \brief The time spent, including the time spent on rewriting subterms.
+  clock::duration time;
+
+  rewrite_profile_statistics()
+    : applications(0), failures(0), time(clock::duration::zero())
+  {}
+};
+
+/// \brief Measures the time between its construction and its destruction, and adds it
+///        to the given statistics. If no statistics are given, nothing is measured.
+class rewrite_profile_timer
+{
+  protected:
+    rewrite_profile_statistics* m_statistics;
+    rewrite_profile_statistics::clock::time_point m_start;
+
+  public:
+    rewrite_profile_timer(rewrite_profile_statistics* statistics)
+      : m_statistics(statistics)
+    {
+      if (m_statistics != nullptr)
+      {
+        m_start = rewrite_profile_statistics::clock::now();
+      }
+    }
+
+    ~rewrite_profile_timer()
+    {
+      if (m_statistics != nullptr)
+      {
+        m_statistics->time += rewrite_profile_statistics::clock::now() - m_start;
+      }
+    }
+};
+
+/// \brief Collects statistics on the data equations and function symbols used by the
+///        rewriters, and writes them to a file when the last rewriter that uses the
+///        profile is destroyed.
+/// \details The report in the file is sorted on time, such that the equations that
+///          dominate rewriting come first. The same statistics are written as comma
+///          separated values to the file with the additional extension .csv.
+///          The statistics are kept in deques, such that references to them remain
+///          valid when new equations or function symbols are added.
+class rewrite_profile
+{
+  protected:
+    typedef std::unordered_map<atermpp::aterm, std::size_t, std::hash<atermpp::aterm> > index_map;
+
+    std::string m_filename;
+    std::size_t m_users;
+
+    std::deque<data_equation> m_equations;
+    std::deque<rewrite_profile_statistics> m_equation_statistics;
+    index_map m_equation_indices;
+
+    std::deque<function_symbol> m_symbols;
+    std::deque<rewrite_profile_statistics> m_symbol_statistics;
+    index_map m_symbol_indices;
+
+    template <typename Term>
+    static std::size_t index(const Term& t, std::deque<Term>& terms, std::deque<rewrite_profile_statistics>& statistics, index_map& indices)
+    {
+      auto i = indices.insert(std::make_pair(t, terms.size()));
+      if (i.second)
+      {
+        terms.push_back(t);
+        statistics.push_back(rewrite_profile_statistics());
+      }
+      return i.first->second;
+    }
+
+    static double milliseconds(const rewrite_profile_statistics& s)
+    {
+      return std::chrono::duration<double, std::milli>(s.time).count();
+    }
+
+    // Returns the positions of the given statistics, ordered by decreasing time and
+    // decreasing number of applications.
+    static std::vector<std::size_t> sorted(const std::deque<rewrite_profile_statistics>& statistics)
+    {
+      std::vector<std::size_t> result;
+      for (std::size_t i = 0; i < statistics.size(); ++i)
+      {
+        if (statistics[i].applications > 0 || statistics[i].failures > 0)
+        {
+          result.push_back(i);
+        }
+      }
+      std::stable_sort(result.begin(), result.end(), [&statistics](std::size_t i, std::size_t j)
+        {
+          return statistics[i].time > statistics[j].time ||
+                 (statistics[i].time == statistics[j].time && statistics[i].applications > statistics[j].applications);
+        });
+      return result;
+    }
+
+    static std::string csv_string(const std::string& s)
+    {
+      std::string result = "\"";
+      for (char c: s)
+      {
+        result += (c == '"' ? "\"\"" : std::string(1, c));
+      }
+      return result + "\"";
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param filename The file to which the report is written.
+    rewrite_profile(const std::string& filename)
+      : m_filename(filename), m_users(0)
+    {}
+
+    /// \brief Returns the index of the statistics of equation e.
+    std::size_t equation_index(const data_equation& e)
+    {
+      return index(e, m_equations, m_equation_statistics, m_equation_indices);
+    }
+
+    /// \brief Returns the index of the statistics of function symbol f.
+    std::size_t symbol_index(const function_symbol& f)
+    {
+      return index(f, m_symbols, m_symbol_statistics, m_symbol_indices);
+    }
+
+    rewrite_profile_statistics& equation(std::size_t i)
+    {
+      return m_equation_statistics[i];
+    }
+
+    rewrite_profile_statistics& equation(const data_equation& e)
+    {
+      return m_equation_statistics[equation_index(e)];
+    }
+
+    rewrite_profile_statistics& symbol(std::size_t i)
+    {
+      return m_symbol_statistics[i];
+    }
+
+    rewrite_profile_statistics& symbol(const function_symbol& f)
+    {
+      return m_symbol_statistics[symbol_index(f)];
+    }
+
+    /// \brief Registers a rewriter that uses this profile.
+    void attach()
+    {
+      m_users++;
+    }
+
+    /// \brief Unregisters a rewriter. If it was the last one, the report is written.
+    void detach()
+    {
+      assert(m_users > 0);
+      if (--m_users == 0)
+      {
+        write();
+      }
+    }
+
+    /// \brief Writes a human readable report, sorted on time.
+    void write_report(std::ostream& out) const
+    {
+      out << "Data equations, sorted on time (including the time to rewrite the condition and right hand side).\n";
+      out << std::setw(12) << "time (ms)" << std::setw(14) << "applications" << std::setw(14) << "failures" << "  equation\n";
+      for (std::size_t i: sorted(m_equation_statistics))
+      {
+        const rewrite_profile_statistics& s = m_equation_statistics[i];
+        out << std::setw(12) << std::fixed << std::setprecision(3) << milliseconds(s)
+            << std::setw(14) << s.applications << std::setw(14) << s.failures << "  " << m_equations[i] << "\n";
+      }
+      out << "\nFunction symbols, sorted on time (including the time to rewrite subterms).\n";
+      out << std::setw(12) << "time (ms)" << std::setw(14) << "rewrites" << "  function symbol\n";
+      for (std::size_t i: sorted(m_symbol_statistics))
+      {
+        const rewrite_profile_statistics& s = m_symbol_statistics[i];
+        out << std::setw(12) << std::fixed << std::setprecision(3) << milliseconds(s)
+            << std::setw(14) << s.applications << "  " << m_symbols[i] << ": " << m_symbols[i].sort() << "\n";
+      }
+    }
+
+    /// \brief Writes the statistics as comma separated values, sorted on time.
+    void write_csv(std::ostream& out) const
+    {
+      out << "kind,name,applications,failures,time_ms\n";
+      for (std::size_t i: sorted(m_equation_statistics))
+      {
+        const rewrite_profile_statistics& s = m_equation_statistics[i];
+        out << "equation," << csv_string(data::pp(m_equations[i])) << "," << s.applications << "," << s.failures << "," << milliseconds(s) << "\n";
+      }
+      for (std::size_t i: sorted(m_symbol_statistics))
+      {
+        const rewrite_profile_statistics& s = m_symbol_statistics[i];
+        out << "function_symbol," << csv_string(data::pp(m_symbols[i]) + ": " + data::pp(m_symbols[i].sort())) << "," << s.applications << ",0," << milliseconds(s) << "\n";
+      }
+    }
+
+    /// \brief Writes the report and the comma separated values to their files.
+    void write() const
+    {
+      std::ofstream report(m_filename);
+      std::ofstream csv(m_filename + ".csv");
+      if (!report || !csv)
+      {
+        mCRL2log(log::error) << "Could not write the rewrite profile to " << m_filename << "." << std::endl;
+        return;
+      }
+      write_report(report);
+      write_csv(csv);
+      mCRL2log(log::verbose) << "Wrote the rewrite profile to " << m_filename << " and " << m_filename << ".csv." << std::endl;
+    }
+};
+
+// Stores the profile that is used by all rewriters, if profiling is enabled.
+template <class T> // note, T is only a dummy
+struct rewrite_profile_instance
+{
+  static rewrite_profile* profile;
+};
+
+// Initialization
+template <class T>
+rewrite_profile* rewrite_profile_instance<T>::profile = nullptr;
+
+/// \brief Lets all rewriters that are created from now on collect statistics in a
+///        profile, which is written to filename when the last of them is destroyed.
+inline
+void enable_rewrite_profile(const std::string& filename)
+{
+  rewrite_profile_instance<std::size_t>::profile = new rewrite_profile(filename);
+}
+
+/// \brief Returns the profile in which the rewriters collect statistics, or nullptr
+///        if profiling is not enabled.
+inline
+rewrite_profile* get_rewrite_profile()
+{
+  return rewrite_profile_instance<std::size_t>::profile;
+}
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_REWRITE_PROFILE_H
@@ -34,12 +34,17 @@ class RewriterProver: public Rewriter
     RewriterProver(const data_specification& data_spec, mcrl2::data::rewriter::strategy strat, const used_data_equation_selector& equations_selector);
     virtual ~RewriterProver();
 
+    Rewriter* clone();
+
     rewrite_strategy getStrategy();
 
     data_expression rewrite(
          const data_expression &Term,
          substitution_type &sigma);
 
+  protected:
+    // Constructor for a clone, that uses the given rewriter.
+    RewriterProver(const data_specification& data_spec, const used_data_equation_selector& equations_selector, const std::shared_ptr<detail::Rewriter>& rewriter);
 };
 
 }
@@ -47,6 +47,7 @@ std::vector<data::rewrite_strategy> initialise_test_rewrite_strategies(const boo
   {
     result.push_back(data::jitty_compiling_prover);
   }
+  result.push_back(data::jitty_tiered);
 #endif // MCRL2_JITTYC_AVAILABLE
 #endif // MCRL2_TEST_JITTYC
 
@@ -26,6 +26,7 @@
 #include "mcrl2/data/rewriter.h"
 #include "mcrl2/data/substitutions/enumerator_substitution.h"
 #include "mcrl2/data/substitutions/mutable_indexed_substitution.h"
+#include "mcrl2/data/detail/enumerator_domain_cache.h"
 #include "mcrl2/data/detail/enumerator_variable_limit.h"
 #include "mcrl2/utilities/math.h"
 
@@ -378,6 +379,10 @@ class enumerator_algorithm
     /// \brief throw_exceptions If true, an exception is thrown when the enumeration is aborted.
     bool m_throw_exceptions;
 
+    /// \brief The domains of the sorts that have been enumerated, see set_domain_cache.
+    mutable detail::enumerator_domain_cache m_own_domain_cache;
+    detail::enumerator_domain_cache* m_domain_cache;
+
     std::string print(const data::variable& x) const
     {
       std::ostringstream out;
@@ -478,9 +483,19 @@ class enumerator_algorithm
                          std::size_t max_count = (std::numeric_limits<std::size_t>::max)(),
                          bool throw_exceptions = false
                        )
-      : R(R_), dataspec(dataspec_), datar(datar_), id_generator(id_generator_), m_max_count(max_count), m_throw_exceptions(throw_exceptions)
+      : R(R_), dataspec(dataspec_), datar(datar_), id_generator(id_generator_), m_max_count(max_count), m_throw_exceptions(throw_exceptions),
+        m_domain_cache(&m_own_domain_cache)
     {}
 
+    /// \brief Lets the enumerator use the given cache for the domains of sorts, instead of
+    /// its own cache. This allows enumerators that only exist for a short time to share
+    /// the domains they computed. The cache must only be shared between enumerators for
+    /// the same data specification.
+    void set_domain_cache(detail::enumerator_domain_cache& cache)
+    {
+      m_domain_cache = &cache;
+    }
+
   private:
     // enumerator_algorithm(const enumerator_algorithm<Rewriter, DataRewriter>&) = delete;
     enumerator_algorithm(const enumerator_algorithm<Rewriter, DataRewriter, IdentifierGenerator>&)
@@ -512,16 +527,25 @@ class enumerator_algorithm
         const function_sort& function = atermpp::down_cast<function_sort>(sort);
         if (dataspec.is_certainly_finite(function))
         {
-          data_expression_vector function_sorts;
-          variable_list function_parameter_list;
-          bool result = detail::compute_finite_function_sorts(function, id_generator, dataspec, datar, function_sorts, function_parameter_list);
-
-          if (!result)
+          data_expression_vector computed_function_sorts;
+          const data_expression_vector* function_sorts = m_domain_cache->find(sort);
+          if (function_sorts == nullptr)
           {
-            cannot_enumerate(p, "Sort " + data::pp(sort) + " has too many elements to enumerate.");
+            variable_list function_parameter_list;
+            bool result = detail::compute_finite_function_sorts(function, id_generator, dataspec, datar, computed_function_sorts, function_parameter_list);
+
+            if (!result)
+            {
+              cannot_enumerate(p, "Sort " + data::pp(sort) + " has too many elements to enumerate.");
+              function_sorts = &computed_function_sorts;
+            }
+            else
+            {
+              function_sorts = &m_domain_cache->insert(sort, computed_function_sorts);
+            }
           }
           const data_expression old_substituted_value = sigma(v1);
-          for (const data_expression& f: function_sorts)
+          for (const data_expression& f: *function_sorts)
           {
             sigma[v1] = f;
             add_element(P, sigma, accept, vtail, phi, p, v1, f);
@@ -557,15 +581,24 @@ class enumerator_algorithm
         const container_sort& fset = atermpp::down_cast<container_sort>(sort);
         if (dataspec.is_certainly_finite(fset.element_sort()))
         {
-          data_expression_vector set_elements;
-          bool result = detail::compute_finite_set_elements(fset, dataspec, datar, sigma, set_elements);
-
-          if (!result)
+          data_expression_vector computed_set_elements;
+          const data_expression_vector* set_elements = m_domain_cache->find(sort);
+          if (set_elements == nullptr)
           {
-            cannot_enumerate(p, "Finite set sort " + data::pp(sort) + " has too many elements to enumerate.");
+            bool result = detail::compute_finite_set_elements(fset, dataspec, datar, sigma, computed_set_elements);
+
+            if (!result)
+            {
+              cannot_enumerate(p, "Finite set sort " + data::pp(sort) + " has too many elements to enumerate.");
+              set_elements = &computed_set_elements;
+            }
+            else
+            {
+              set_elements = &m_domain_cache->insert(sort, computed_set_elements);
+            }
           }
           const data_expression old_substituted_value = sigma(v1);
-          for (const data_expression& set_element: set_elements)
+          for (const data_expression& set_element: *set_elements)
           {
             sigma[v1] = set_element;
             add_element(P, sigma, accept, vtail, phi, p, v1, set_element);
@@ -593,7 +626,20 @@ class enumerator_algorithm
         auto const& C = dataspec.constructors(sort);
         if (!C.empty())
         {
-          for (auto i = C.begin(); i != C.end(); ++i)
+          // The normal forms of the constructors without arguments.
+          data_expression_vector computed_constants;
+          const data_expression_vector* constants = m_domain_cache->find(sort);
+          if (constants == nullptr)
+          {
+            for (auto const& constructor: C)
+            {
+              // TODO: We want to apply datar without the substitution sigma, but that is currently an inefficient operation of data::rewriter.
+              computed_constants.push_back(data::is_function_sort(constructor.sort()) ? data_expression() : datar(constructor, sigma));
+            }
+            constants = &m_domain_cache->insert(sort, computed_constants);
+          }
+          auto constant = constants->begin();
+          for (auto i = C.begin(); i != C.end(); ++i, ++constant)
           {
             auto const& constructor = *i;
             if (data::is_function_sort(constructor.sort()))
@@ -608,8 +654,7 @@ class enumerator_algorithm
             }
             else
             {
-              // TODO: We want to apply datar without the substitution sigma, but that is currently an inefficient operation of data::rewriter.
-              auto const e1 = datar(constructor, sigma);
+              auto const& e1 = *constant;
               sigma[v1] = e1;
               add_element(P, sigma, accept, vtail, phi, p, v1, e1);
               sigma[v1] = v1;
@@ -0,0 +1,286 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/parallel_enumerator.h
+/// \brief Enumeration of the todo list of an enumerator with several threads.
+
+#ifndef MCRL2_DATA_PARALLEL_ENUMERATOR_H
+#define MCRL2_DATA_PARALLEL_ENUMERATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+#include <thread>
+#endif
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+
+namespace data
+{
+
+namespace detail
+{
+
+// Stores the number of threads that is used to eliminate quantifiers by enumeration.
+template <class T> // note, T is only a dummy
+struct enumerator_thread_count
+{
+  static std::size_t count;
+};
+
+// Initialization
+template <class T>
+std::size_t enumerator_thread_count<T>::count = 1;
+
+inline
+void set_enumerator_thread_count(std::size_t count)
+{
+  enumerator_thread_count<std::size_t>::count = (count == 0 ? 1 : count);
+}
+
+/// \brief Returns the number of threads that is used to eliminate quantifiers by enumeration.
+/// \details Threads are only used if the term library is thread safe, otherwise 1 is returned.
+inline
+std::size_t get_enumerator_thread_count()
+{
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+  return enumerator_thread_count<std::size_t>::count;
+#else
+  return 1;
+#endif
+}
+
+/// \brief Returns true if the calling thread takes part in a parallel enumeration. Enumerations
+///        that are nested in a parallel enumeration are done sequentially.
+inline
+bool& parallel_enumeration_active()
+{
+  static thread_local bool active = false;
+  return active;
+}
+
+// Marks the calling thread as taking part in a parallel enumeration during its lifetime.
+struct parallel_enumeration_guard
+{
+  bool m_active;
+
+  parallel_enumeration_guard()
+    : m_active(parallel_enumeration_active())
+  {
+    parallel_enumeration_active() = true;
+  }
+
+  ~parallel_enumeration_guard()
+  {
+    parallel_enumeration_active() = m_active;
+  }
+};
+
+/// \brief Returns true if an enumeration by the calling thread should use parallel_enumerate.
+inline
+bool use_parallel_enumeration()
+{
+  return get_enumerator_thread_count() > 1 && !parallel_enumeration_active();
+}
+
+} // namespace detail
+
+/// \brief Computes the solutions of the todo list P of an enumerator, using the enumerators E
+///        in parallel.
+/// \details First P is expanded breadth first by E[0], as the sequential algorithm does, until
+///          it contains chunk_factor elements per enumerator. Then each remaining element of P
+///          is enumerated completely by one of the enumerators, each in its own thread.
+///          The enumerators must be independent: E[k] must use its own rewriter and
+///          substitution, and sigma[k] must be the substitution that is used by E[k].
+///          The solutions are stored in a deterministic order. If a solution is found for which
+///          is_final holds, like true for an existential quantifier, the enumeration is stopped
+///          and this solution is the last one that is appended. The max_count limit of E[0]
+///          applies to the total number of elements that are expanded by all enumerators.
+///          Threads are only created if the term library is thread safe, otherwise the
+///          enumerators are used one after the other. If phase 1 completes the enumeration, no
+///          threads are created at all.
+/// \param E The enumerators; for every enumerator a thread is used.
+/// \param sigma The substitutions of the enumerators.
+/// \param P The todo list of the enumeration. It is empty afterwards.
+/// \param accept Elements p for which accept(p) is false are discarded.
+/// \param is_final A predicate on expressions of solutions that stops the enumeration.
+/// \param solutions The solutions that are found are appended to solutions.
+/// \return False if the enumeration was aborted since it did not complete within
+///         max_count iterations, and true otherwise.
+template <typename Enumerator, typename MutableSubstitution, typename EnumeratorListElement, typename Filter, typename IsFinal>
+bool parallel_enumerate(const std::vector<const Enumerator*>& E,
+                        const std::vector<MutableSubstitution*>& sigma,
+                        std::deque<EnumeratorListElement>& P,
+                        Filter accept,
+                        IsFinal is_final,
+                        std::vector<EnumeratorListElement>& solutions,
+                        std::size_t chunk_factor = 8
+                       )
+{
+  assert(!E.empty() && E.size() == sigma.size());
+  detail::parallel_enumeration_guard guard;
+  const std::size_t max_count = E.front()->max_count();
+  std::atomic<std::size_t> count(0);
+  std::atomic<bool> aborted(false);
+
+  // Phase 1: expand P breadth first, until there is enough work for all enumerators.
+  const std::size_t chunk_size = chunk_factor * E.size();
+  while (!P.empty() && P.size() < chunk_size)
+  {
+    if (P.front().is_solution())
+    {
+      solutions.push_back(P.front());
+      P.pop_front();
+      if (is_final(solutions.back().expression()))
+      {
+        P.clear();
+        return true;
+      }
+    }
+    else if (count++ >= max_count)
+    {
+      aborted = true;
+      break;
+    }
+    else
+    {
+      E.front()->enumerate_front(P, *sigma.front(), accept);
+    }
+  }
+
+  // Small enumerations, such as those of a quantifier over Bool, are completed in phase 1,
+  // and then no threads are started.
+  if (P.empty() && !aborted)
+  {
+    return true;
+  }
+
+  // Phase 2: enumerate the remaining elements of P completely, each by one enumerator. No more
+  // enumerators are used than there are elements.
+  const std::vector<EnumeratorListElement> todo(P.begin(), P.end());
+  const std::size_t enumerator_count = aborted ? 0 : std::min(E.size(), todo.size());
+  P.clear();
+  std::vector<std::vector<EnumeratorListElement> > results(todo.size());
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> stop(aborted.load());
+  std::mutex final_mutex;
+  std::size_t final_index = todo.size();
+  std::exception_ptr error;
+
+  auto enumerate = [&](std::size_t k)
+  {
+    detail::parallel_enumeration_guard guard;
+    try
+    {
+      std::deque<EnumeratorListElement> Q;
+      for (std::size_t i = next++; i < todo.size() && !stop; i = next++)
+      {
+        Q.clear();
+        Q.push_back(todo[i]);
+        while (!Q.empty() && !stop)
+        {
+          if (Q.front().is_solution())
+          {
+            if (is_final(Q.front().expression()))
+            {
+              std::lock_guard<std::mutex> lock(final_mutex);
+              if (i < final_index)
+              {
+                final_index = i;
+                results[i].assign(1, Q.front());
+              }
+              stop = true;
+              break;
+            }
+            results[i].push_back(Q.front());
+            Q.pop_front();
+          }
+          else if (count++ >= max_count)
+          {
+            aborted = true;
+            stop = true;
+          }
+          else
+          {
+            E[k]->enumerate_front(Q, *sigma[k], accept);
+          }
+        }
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(final_mutex);
+      if (!error)
+      {
+        error = std::current_exception();
+      }
+      stop = true;
+    }
+  };
+
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+  std::vector<std::thread> threads;
+  for (std::size_t k = 1; k < enumerator_count; ++k)
+  {
+    threads.emplace_back(enumerate, k);
+  }
+  if (enumerator_count > 0)
+  {
+    enumerate(0);
+  }
+  for (std::thread& t: threads)
+  {
+    t.join();
+  }
+#else
+  for (std::size_t k = 0; k < enumerator_count; ++k)
+  {
+    enumerate(k);
+  }
+#endif
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+  if (final_index < todo.size())
+  {
+    solutions.push_back(results[final_index].front());
+    return true;
+  }
+  for (const std::vector<EnumeratorListElement>& result: results)
+  {
+    solutions.insert(solutions.end(), result.begin(), result.end());
+  }
+  if (aborted)
+  {
+    if (E.front()->throw_exceptions())
+    {
+      std::ostringstream out;
+      out << "enumeration was aborted, since it did not complete within " << max_count << " iterations";
+      throw mcrl2::runtime_error(out.str());
+    }
+    return false;
+  }
+  return true;
+}
+
+} // namespace data
+
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_PARALLEL_ENUMERATOR_H
@@ -551,6 +551,30 @@ T substitute_sorts(const T& x,
   return core::make_update_apply_builder<data::sort_expression_builder>(sigma).apply(x);
 }
 
+/// \brief Applies the substitution sigma to x, like replace_variables, but each distinct
+/// data expression in x is traversed only once. This is much faster for data expressions
+/// with a lot of sharing, at the cost of a cache with an entry per distinct subexpression.
+/// The substitution is applied to bound variables as well.
+template <typename T, typename Substitution>
+void memoized_replace_variables(T& x,
+                                const Substitution& sigma,
+                                typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                               )
+{
+  core::make_memoizing_update_apply_builder<data::data_expression_builder, data::data_expression>(sigma).update(x);
+}
+
+/// \brief Applies the substitution sigma to x, like replace_variables, but each distinct
+/// data expression in x is traversed only once.
+template <typename T, typename Substitution>
+T memoized_replace_variables(const T& x,
+                             const Substitution& sigma,
+                             typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                            )
+{
+  return core::make_memoizing_update_apply_builder<data::data_expression_builder, data::data_expression>(sigma).apply(x);
+}
+
 } // namespace data
 
 } // namespace mcrl2
@@ -17,7 +17,8 @@ enum rewrite_strategy
 #ifdef MCRL2_JITTYC_AVAILABLE
   jitty_compiling,            /** \brief Compiling JITty */
   jitty_prover,               /** \brief JITty + Prover */
-  jitty_compiling_prover      /** \brief Compiling JITty + Prover*/
+  jitty_compiling_prover,     /** \brief Compiling JITty + Prover*/
+  jitty_tiered                /** \brief JITty until Compiling JITty is available */
 #else
   jitty_prover                /** \brief JITty + Prover */
 #endif
@@ -37,6 +38,8 @@ rewrite_strategy parse_rewrite_strategy(const std::string& s)
     return jitty_compiling;
   else if (s == "jittycp")
     return jitty_compiling_prover;
+  else if (s == "jittyt")
+    return jitty_tiered;
 #endif //MCRL2_JITTYC_AVAILABLE
 
   throw mcrl2::runtime_error("unknown rewrite strategy " + s);
@@ -72,6 +75,7 @@ inline std::string pp(const rewrite_strategy s)
     case jitty_prover: return "jittyp";
 #ifdef MCRL2_JITTYC_AVAILABLE
     case jitty_compiling_prover: return "jittycp";
+    case jitty_tiered: return "jittyt";
 #endif
     default: throw mcrl2::runtime_error("unknown rewrite_strategy");
   }
@@ -96,6 +100,7 @@ inline std::string description(const rewrite_strategy s)
     case jitty_prover: return "jitty rewriting with prover";
 #ifdef MCRL2_JITTYC_AVAILABLE
     case jitty_compiling_prover: return "compiled jitty rewriting with prover";
+    case jitty_tiered: return "jitty rewriting until the compiled jitty rewriter is available";
 #endif
     default: throw mcrl2::runtime_error("unknown rewrite_strategy");
   }
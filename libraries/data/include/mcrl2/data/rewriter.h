@@ -18,6 +18,7 @@
 #include <sstream>
 
 #include "mcrl2/utilities/exception.h"
+#include "mcrl2/data/assignment.h"
 #include "mcrl2/data/expression_traits.h"
 #include "mcrl2/data/detail/rewrite.h"
 #include "mcrl2/data/data_specification.h"
@@ -104,6 +105,12 @@ class rewriter: public basic_rewriter<data_expression>
       basic_rewriter<data_expression>(r)
     { }
 
+    /// \brief Constructor.
+    /// \param[in] r A rewriter.
+    rewriter(const std::shared_ptr<detail::Rewriter>& r) :
+      basic_rewriter<data_expression>(r)
+    { }
+
     /// \brief Constructor.
     /// \param[in] d A data specification
     /// \param[in] s A rewriter strategy.
@@ -121,6 +128,16 @@ class rewriter: public basic_rewriter<data_expression>
     {
     }
 
+    /// \brief Returns a rewriter with the same rewrite rules and strategy, that does not share
+    ///        any mutable state with this rewriter.
+    /// \details The data specification is not preprocessed again, and a compiled rewriter is
+    ///          not compiled again. If the term library is thread safe, the clone can be used
+    ///          in another thread than this rewriter, e.g., one clone per worker thread.
+    rewriter clone() const
+    {
+      return rewriter(std::shared_ptr<detail::Rewriter>(m_rewriter->clone()));
+    }
+
     /// \brief Default specification used if no specification is specified at construction
     static data_specification& default_specification()
     {
@@ -190,6 +207,56 @@ class rewriter: public basic_rewriter<data_expression>
       return m_rewriter->rewrite(d,sigma);
 #endif
     }
+
+    /// \brief Rewrites the data expressions terms[0], ..., terms[size-1], all with the
+    /// substitution sigma, and stores their normal forms in result[0], ..., result[size-1].
+    /// \details This is cheaper than rewriting the expressions one by one, as the
+    /// substitution is set up only once, variables are looked up in sigma directly,
+    /// and expressions that occur more than once are rewritten once.
+    /// \param[in] terms An array of data expressions.
+    /// \param[in] size The number of data expressions.
+    /// \param[out] result An array of at least size data expressions.
+    /// \param[in] sigma A substitution function.
+    void operator()(const data_expression* terms, std::size_t size, data_expression* result, substitution_type& sigma) const
+    {
+      m_rewriter->rewrite_vector(terms, size, result, sigma);
+    }
+
+    /// \brief Rewrites a vector of data expressions, all with the substitution sigma.
+    /// \param[in] v A vector of data expressions.
+    /// \param[in] sigma A substitution function.
+    /// \return The normal forms of the elements of v.
+    data_expression_vector operator()(const data_expression_vector& v, substitution_type& sigma) const
+    {
+      data_expression_vector result(v.size());
+      m_rewriter->rewrite_vector(v.data(), v.size(), result.data(), sigma);
+      return result;
+    }
+
+    /// \brief Rewrites the right hand sides of a list of assignments, all with the
+    /// substitution sigma.
+    /// \param[in] l A list of assignments.
+    /// \param[in] sigma A substitution function.
+    /// \return The assignments with their right hand sides in normal form.
+    assignment_list operator()(const assignment_list& l, substitution_type& sigma) const
+    {
+      data_expression_vector rhs;
+      rhs.reserve(l.size());
+      for (const assignment& a: l)
+      {
+        rhs.push_back(a.rhs());
+      }
+      data_expression_vector result(rhs.size());
+      m_rewriter->rewrite_vector(rhs.data(), rhs.size(), result.data(), sigma);
+      std::vector<assignment> assignments;
+      assignments.reserve(result.size());
+      data_expression_vector::const_iterator r = result.begin();
+      for (const assignment& a: l)
+      {
+        assignments.push_back(assignment(a.lhs(), *r++));
+      }
+      return assignment_list(assignments.begin(), assignments.end());
+    }
 };
 
 } // namespace data
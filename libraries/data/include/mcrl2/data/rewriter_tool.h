@@ -16,6 +16,9 @@
 #include "mcrl2/data/rewriter.h"
 #include "mcrl2/utilities/command_line_interface.h"
 #include "mcrl2/data/detail/enumerator_variable_limit.h"
+#include "mcrl2/data/detail/rewrite/closed_term_cache.h"
+#include "mcrl2/data/detail/rewrite/rewrite_profile.h"
+#include "mcrl2/data/parallel_enumerator.h"
 
 namespace mcrl2
 {
@@ -46,6 +49,7 @@ class rewriter_tool: public Tool
             .add_value(data::jitty, true)
 #ifdef MCRL2_JITTYC_AVAILABLE
             .add_value(data::jitty_compiling)
+            .add_value(data::jitty_tiered)
 #endif
             .add_value(data::jitty_prover),
         "use rewrite strategy NAME:"
@@ -58,6 +62,25 @@ class rewriter_tool: public Tool
         'Q'
       );
 
+      desc.add_option(
+        "rewrite-cache", utilities::make_mandatory_argument("NUM"),
+        "let the jitty rewriter cache the normal forms of closed terms in a table with NUM entries. "
+        "This pays off if the same terms are rewritten often, as in state space generation. "
+        "(Default NUM=0, i.e., no cache.)"
+      );
+
+      desc.add_option(
+        "rewrite-profile", utilities::make_file_argument("FILE"),
+        "count how often the data equations and function symbols are used by the rewriter and "
+        "measure the time spent on them. A report sorted on time is written to FILE, and the "
+        "same statistics are written as comma separated values to FILE.csv. This slows down rewriting."
+      );
+
+      desc.add_option(
+        "enumeration-threads", utilities::make_mandatory_argument("NUM"),
+        "eliminate quantifiers over finite sorts by enumeration with NUM threads. This requires "
+        "a toolset that is built with thread-safe terms. (Default NUM=1.)"
+      );
     }
 
     /// \brief Parse non-standard options
@@ -72,6 +95,26 @@ class rewriter_tool: public Tool
         //Set enumerator limit for quantifier enumeration
         data::detail::set_enumerator_variable_limit(parser.option_argument_as< size_t >("qlimit"));
       }
+
+      if(parser.options.count("rewrite-cache"))
+      {
+        data::detail::set_closed_term_cache_size(parser.option_argument_as< size_t >("rewrite-cache"));
+      }
+
+      if(parser.options.count("rewrite-profile"))
+      {
+        data::detail::enable_rewrite_profile(parser.option_argument("rewrite-profile"));
+      }
+
+      if(parser.options.count("enumeration-threads"))
+      {
+        const size_t threads = parser.option_argument_as< size_t >("enumeration-threads");
+        data::detail::set_enumerator_thread_count(threads);
+        if (threads > data::detail::get_enumerator_thread_count())
+        {
+          mCRL2log(log::warning) << "The terms are not thread safe in this build of the toolset; quantifiers are enumerated with one thread." << std::endl;
+        }
+      }
     }
 
   public:
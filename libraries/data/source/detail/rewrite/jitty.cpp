@@ -14,6 +14,7 @@
 #define NAME std::string("rewr_jitty")
 
 #include <algorithm>
+#include <iterator>
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
@@ -340,6 +341,124 @@ strategy RewriterJitty::create_strategy(const data_equation_list& rules1)
   return strategy(strat.begin(),strat.end());
 }
 
+const size_t jitty_strategy_step::npos;
+
+jitty_strategy_step::jitty_strategy_step(const std::vector<data_equation>& equations, const std::vector<bool>& rewritten_arguments)
+  : m_rewrite_index(npos),
+    m_equations(equations),
+    m_index_position(npos)
+{
+  // The head symbol of the argument with index i of the left hand side of equation j, if it exists.
+  const auto head_of_argument=[this](const size_t j, const size_t i, function_symbol& head) -> bool
+  {
+    const data_expression& lhs=m_equations[j].lhs();
+    if (is_function_symbol(lhs) || i>=recursive_number_of_args(lhs))
+    {
+      return false;
+    }
+    return head_is_function_symbol(get_argument_of_higher_order_term(atermpp::down_cast<application>(lhs),i),head);
+  };
+
+  // Index the equations on the rewritten argument for which most left hand sides have a head symbol.
+  size_t best_count=0;
+  for (size_t i=0; i<rewritten_arguments.size(); ++i)
+  {
+    if (rewritten_arguments[i])
+    {
+      size_t count=0;
+      function_symbol head;
+      for (size_t j=0; j<m_equations.size(); ++j)
+      {
+        if (head_of_argument(j,i,head))
+        {
+          count++;
+        }
+      }
+      if (count>best_count)
+      {
+        best_count=count;
+        m_index_position=i;
+      }
+    }
+  }
+
+  // An index only pays off if it can rule out more than one equation.
+  if (best_count<2)
+  {
+    m_index_position=npos;
+  }
+
+  for (size_t j=0; j<m_equations.size(); ++j)
+  {
+    function_symbol head;
+    if (m_index_position!=npos && head_of_argument(j,m_index_position,head))
+    {
+      m_index[head].push_back(j);
+    }
+    else
+    {
+      m_unindexed_equations.push_back(j);
+    }
+  }
+
+  // Equations without a head symbol at the index position can match any argument. Add them,
+  // such that the equations for each head symbol are tried in the order of the strategy.
+  for (index_type::value_type& p: m_index)
+  {
+    std::vector<size_t> equations;
+    std::merge(p.second.begin(),p.second.end(),m_unindexed_equations.begin(),m_unindexed_equations.end(),std::back_inserter(equations));
+    p.second.swap(equations);
+  }
+}
+
+const std::vector<size_t>& jitty_strategy_step::candidate_equations(const data_expression& argument) const
+{
+  function_symbol head;
+  if (m_index_position!=npos && head_is_function_symbol(argument,head))
+  {
+    const index_type::const_iterator i=m_index.find(head);
+    if (i!=m_index.end())
+    {
+      return i->second;
+    }
+  }
+  return m_unindexed_equations;
+}
+
+jitty_strategy RewriterJitty::create_indexed_strategy(const strategy& strat)
+{
+  jitty_strategy result;
+  std::vector<bool> rewritten_arguments;
+  std::vector<data_equation> equations;
+  for (const strategy_rule& rule: strat)
+  {
+    if (rule.is_rewrite_index())
+    {
+      if (!equations.empty())
+      {
+        result.push_back(jitty_strategy_step(equations,rewritten_arguments));
+        equations.clear();
+      }
+      const size_t i=rule.rewrite_index();
+      result.push_back(jitty_strategy_step(i));
+      if (i>=rewritten_arguments.size())
+      {
+        rewritten_arguments.resize(i+1,false);
+      }
+      rewritten_arguments[i]=true;
+    }
+    else
+    {
+      equations.push_back(rule.equation());
+    }
+  }
+  if (!equations.empty())
+  {
+    result.push_back(jitty_strategy_step(equations,rewritten_arguments));
+  }
+  return result;
+}
+
 void RewriterJitty::make_jitty_strat_sufficiently_larger(const size_t i)
 {
   if (i>=jitty_strat.size())
@@ -355,7 +474,7 @@ void RewriterJitty::rebuild_strategy()
   {
     const size_t i=core::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(l->first);
     make_jitty_strat_sufficiently_larger(i);
-    jitty_strat[i] = create_strategy(reverse(l->second));
+    jitty_strat[i] = create_indexed_strategy(create_strategy(reverse(l->second)));
   }
 
 }
@@ -363,8 +482,14 @@ void RewriterJitty::rebuild_strategy()
 RewriterJitty::RewriterJitty(
            const data_specification& data_spec,
            const mcrl2::data::used_data_equation_selector& equation_selector):
-        Rewriter(data_spec,equation_selector)
+        Rewriter(data_spec,equation_selector),
+        m_normal_forms(get_closed_term_cache_size()),
+        m_profile(get_rewrite_profile())
 {
+  if (m_profile!=nullptr)
+  {
+    m_profile->attach();
+  }
   MAX_LEN=0;
   max_vars = 0;
 
@@ -403,8 +528,38 @@ RewriterJitty::RewriterJitty(
   rebuild_strategy();
 }
 
+RewriterJitty::RewriterJitty(const RewriterJitty& other):
+        Rewriter(other),
+        max_vars(other.max_vars),
+        jitty_eqns(other.jitty_eqns),
+        jitty_strat(other.jitty_strat),
+        MAX_LEN(other.MAX_LEN),
+        m_normal_forms(other.m_normal_forms),
+        m_profile(other.m_profile),
+        m_native_arithmetic(other.m_native_arithmetic)
+{
+  if (m_profile!=nullptr)
+  {
+    m_profile->attach();
+  }
+}
+
+Rewriter* RewriterJitty::clone()
+{
+  return new RewriterJitty(*this);
+}
+
 RewriterJitty::~RewriterJitty()
 {
+  if (m_normal_forms.enabled() && m_normal_forms.hits()+m_normal_forms.misses()>0)
+  {
+    mCRL2log(verbose) << "The normal form cache of the jitty rewriter with " << m_normal_forms.size() << " entries had "
+                      << m_normal_forms.hits() << " hits and " << m_normal_forms.misses() << " misses." << std::endl;
+  }
+  if (m_profile!=nullptr)
+  {
+    m_profile->detach();
+  }
 }
 
 static data_expression subst_values(
@@ -671,6 +826,10 @@ data_expression RewriterJitty::rewrite_aux(
 
   if (detail::head_is_function_symbol(term,head) && head!=this_term_is_in_normal_form())
   {
+    if (m_normal_forms.enabled())
+    {
+      return rewrite_aux_function_symbol_cached(head,term,sigma);
+    }
     return rewrite_aux_function_symbol(head,term,sigma);
   }
 
@@ -718,6 +877,13 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
 {
   // The first term is function symbol; apply the necessary rewrite rules using a jitty strategy.
 
+  rewrite_profile_statistics* symbol_statistics=(m_profile==nullptr?nullptr:&m_profile->symbol(op));
+  if (symbol_statistics!=nullptr)
+  {
+    symbol_statistics->applications++;
+  }
+  rewrite_profile_timer symbol_timer(symbol_statistics);
+
   const size_t arity=(is_function_symbol(term)?0:detail::recursive_number_of_args(term));
 
   data_expression* rewritten = MCRL2_SPECIFIC_STACK_ALLOCATOR(data_expression, arity);
@@ -734,18 +900,26 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
     make_jitty_strat_sufficiently_larger(op_value);
   }
 
-  const strategy strat=jitty_strat[op_value];
+  // Arithmetic on constants of sort Pos, Nat and Int is evaluated natively, as soon as the
+  // strategy has rewritten all arguments. Equations that do not need all arguments, such as
+  // 0*n=0, are applied by the strategy before that, without rewriting the other arguments.
+  const bool is_native_operation=(arity>0 && m_native_arithmetic.operation(op)!=native_arithmetic::none &&
+                                  atermpp::down_cast<application>(term).head()==op);
+  size_t native_arguments_rewritten=0;
+
+  const jitty_strategy& strat=jitty_strat[op_value];
   if (!strat.empty())
   {
     unprotected_variable* vars=MCRL2_SPECIFIC_STACK_ALLOCATOR(unprotected_variable,max_vars);
     unprotected_data_expression* terms = MCRL2_SPECIFIC_STACK_ALLOCATOR(unprotected_data_expression,max_vars);
     bool* variable_is_in_normal_form = MCRL2_SPECIFIC_STACK_ALLOCATOR(bool,max_vars);
     size_t no_assignments=0;
-    for (const strategy_rule& rule: strat)
+    bool arity_exceeded=false;
+    for (const jitty_strategy_step& step: strat)
     {
-      if (rule.is_rewrite_index())
+      if (step.is_rewrite_index())
       {
-        const size_t i = rule.rewrite_index();
+        const size_t i = step.rewrite_index();
         if (i < arity)
         {
           assert(!rewritten_defined[i]||i==0);
@@ -753,6 +927,15 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
           {
             new (&rewritten[i]) data_expression(rewrite_aux(detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(term),i),sigma));
             rewritten_defined[i]=true;
+            data_expression result;
+            if (is_native_operation && ++native_arguments_rewritten==arity && m_native_arithmetic.evaluate(op,rewritten,result))
+            {
+              for (size_t j=0; j<arity; ++j)
+              {
+                rewritten[j].~data_expression();
+              }
+              return result;
+            }
           }
           assert(rewritten[i].defined());
         }
@@ -763,93 +946,115 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
       }
       else
       {
-        const data_equation rule1=rule.equation();
-        const data_expression& lhs=rule1.lhs();
-        size_t rule_arity = (is_function_symbol(lhs)?0:detail::recursive_number_of_args(lhs));
-
-        if (rule_arity > arity)
+        // Only try the equations that can match the head symbol of the indexed argument.
+        assert(step.index_position()==jitty_strategy_step::npos || rewritten_defined[step.index_position()]);
+        const std::vector<size_t>& candidate_equations=
+                 step.candidate_equations(step.index_position()==jitty_strategy_step::npos?term:rewritten[step.index_position()]);
+        for (const size_t candidate: candidate_equations)
         {
-          break;
-        }
-
-        assert(no_assignments==0);
+          const data_equation& rule1=step.equation(candidate);
+          const data_expression& lhs=rule1.lhs();
+          size_t rule_arity = (is_function_symbol(lhs)?0:detail::recursive_number_of_args(lhs));
 
-        bool matches = true;
-        for (size_t i=0; i<rule_arity; i++)
-        {
-          assert(i<arity);
-          if (!match_jitty(rewritten_defined[i]?rewritten[i]:detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(term),i),
-                           detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(lhs),i),
-                           vars,terms,variable_is_in_normal_form,no_assignments,rewritten_defined[i]))
+          if (rule_arity > arity)
           {
-            matches = false;
+            arity_exceeded=true;
             break;
           }
-        }
-        if (matches)
-        {
-          if (rule1.condition()==sort_bool::true_() || rewrite_aux(
-                   subst_values(vars,terms,variable_is_in_normal_form,no_assignments,rule1.condition(),generator),sigma)==sort_bool::true_())
-          {
-            const data_expression& rhs=rule1.rhs();
 
-            if (arity == rule_arity)
+          assert(no_assignments==0);
+
+          bool matches = true;
+          for (size_t i=0; i<rule_arity; i++)
+          {
+            assert(i<arity);
+            if (!match_jitty(rewritten_defined[i]?rewritten[i]:detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(term),i),
+                             detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(lhs),i),
+                             vars,terms,variable_is_in_normal_form,no_assignments,rewritten_defined[i]))
             {
-              const data_expression result=rewrite_aux(subst_values(vars,terms,variable_is_in_normal_form,no_assignments,rhs,generator),sigma);
-              for (size_t i=0; i<arity; i++)
+              matches = false;
+              break;
+            }
+          }
+          rewrite_profile_statistics* equation_statistics=(m_profile==nullptr?nullptr:&m_profile->equation(rule1));
+          if (matches)
+          {
+            rewrite_profile_timer equation_timer(equation_statistics);
+            if (rule1.condition()==sort_bool::true_() || rewrite_aux(
+                     subst_values(vars,terms,variable_is_in_normal_form,no_assignments,rule1.condition(),generator),sigma)==sort_bool::true_())
+            {
+              if (equation_statistics!=nullptr)
+              {
+                equation_statistics->applications++;
+              }
+              const data_expression& rhs=rule1.rhs();
+
+              if (arity == rule_arity)
               {
-                if (rewritten_defined[i])
+                const data_expression result=rewrite_aux(subst_values(vars,terms,variable_is_in_normal_form,no_assignments,rhs,generator),sigma);
+                for (size_t i=0; i<arity; i++)
                 {
-                  rewritten[i].~data_expression();
+                  if (rewritten_defined[i])
+                  {
+                    rewritten[i].~data_expression();
+                  }
                 }
+                return result;
               }
-              return result;
-            }
-            else
-            {
+              else
+              {
 
-              assert(arity>rule_arity);
-              // There are more arguments than those that have been rewritten.
-              // Get those, put them in rewritten.
+                assert(arity>rule_arity);
+                // There are more arguments than those that have been rewritten.
+                // Get those, put them in rewritten.
 
-              data_expression result=subst_values(vars,terms,variable_is_in_normal_form,no_assignments,rhs,generator);
+                data_expression result=subst_values(vars,terms,variable_is_in_normal_form,no_assignments,rhs,generator);
 
-              for(size_t i=rule_arity; i<arity; ++i)
-              {
-                if (rewritten_defined[i])
+                for(size_t i=rule_arity; i<arity; ++i)
                 {
-                  rewritten[i]=detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(term),i);
+                  if (rewritten_defined[i])
+                  {
+                    rewritten[i]=detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(term),i);
+                  }
+                  else
+                  {
+                    new (&rewritten[i]) data_expression(detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(term),i));
+                    rewritten_defined[i]=true;
+                  }
                 }
-                else
+                size_t i = rule_arity;
+                sort_expression sort = detail::residual_sort(op.sort(),i);
+                while (is_function_sort(sort) && (i < arity))
                 {
-                  new (&rewritten[i]) data_expression(detail::get_argument_of_higher_order_term(atermpp::down_cast<application>(term),i));
-                  rewritten_defined[i]=true;
+                  const function_sort& fsort =  atermpp::down_cast<function_sort>(sort);
+                  const size_t end=i+fsort.domain().size();
+                  assert(end-1<arity);
+                  result = application(result,&rewritten[0]+i,&rewritten[0]+end);
+                  i=end;
+                  sort = fsort.codomain();
                 }
-              }
-              size_t i = rule_arity;
-              sort_expression sort = detail::residual_sort(op.sort(),i);
-              while (is_function_sort(sort) && (i < arity))
-              {
-                const function_sort& fsort =  atermpp::down_cast<function_sort>(sort);
-                const size_t end=i+fsort.domain().size();
-                assert(end-1<arity);
-                result = application(result,&rewritten[0]+i,&rewritten[0]+end);
-                i=end;
-                sort = fsort.codomain();
-              }
 
-              for (size_t i=0; i<arity; ++i)
-              {
-                if (rewritten_defined[i])
+                for (size_t i=0; i<arity; ++i)
                 {
-                  rewritten[i].~data_expression();
+                  if (rewritten_defined[i])
+                  {
+                    rewritten[i].~data_expression();
+                  }
                 }
+                return rewrite_aux(result,sigma);
               }
-              return rewrite_aux(result,sigma);
             }
           }
+          if (equation_statistics!=nullptr)
+          {
+            equation_statistics->failures++;
+          }
+          no_assignments=0;
+        }
+        if (arity_exceeded)
+        {
+          break;
         }
-        no_assignments=0;
       }
     }
   }
@@ -886,6 +1091,61 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
   return result;
 }
 
+// The normal form of a term is only cached if the term does not contain variables or binders,
+// as only then its normal form does not depend on the substitution. To bound the time spent
+// on this check, terms with more function symbols than the number below are not cached.
+static const size_t MAX_SIZE_OF_CACHED_TERM=128;
+
+static bool is_small_closed_term(const data_expression& t, size_t& budget)
+{
+  if (budget==0)
+  {
+    return false;
+  }
+  budget--;
+  if (is_function_symbol(t))
+  {
+    return true;
+  }
+  if (is_application(t))
+  {
+    const application& ta=atermpp::down_cast<application>(t);
+    if (!is_small_closed_term(ta.head(),budget))
+    {
+      return false;
+    }
+    for (const data_expression& u: ta)
+    {
+      if (!is_small_closed_term(u,budget))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  // t is a variable, an abstraction or a where clause.
+  return false;
+}
+
+data_expression RewriterJitty::rewrite_aux_function_symbol_cached(
+                      const function_symbol& op,
+                      const data_expression& term,
+                      substitution_type& sigma)
+{
+  const data_expression* normal_form=m_normal_forms.find(term);
+  if (normal_form!=nullptr)
+  {
+    return *normal_form;
+  }
+  const data_expression result=rewrite_aux_function_symbol(op,term,sigma);
+  size_t budget=MAX_SIZE_OF_CACHED_TERM;
+  if (is_small_closed_term(term,budget))
+  {
+    m_normal_forms.insert(term,result);
+  }
+  return result;
+}
+
 data_expression RewriterJitty::rewrite(
      const data_expression& term,
      substitution_type& sigma)
@@ -898,6 +1158,21 @@ data_expression RewriterJitty::rewrite(
   return t;
 }
 
+void RewriterJitty::rewrite_vector(
+     const data_expression* terms,
+     std::size_t size,
+     data_expression* result,
+     substitution_type& sigma)
+{
+  rewrite_vector_with(terms, size, result, sigma, [&](const data_expression& t)
+    {
+#ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
+      data::detail::increment_rewrite_count();
+#endif
+      return rewrite_aux(t, sigma);
+    });
+}
+
 rewrite_strategy RewriterJitty::getStrategy()
 {
   return jitty;
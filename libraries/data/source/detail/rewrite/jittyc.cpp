@@ -23,10 +23,18 @@
 #include <unistd.h>
 #include <cerrno>
 #include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <iomanip>
 #include <cassert>
 #include <sstream>
 #include <fstream>
 #include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/time.h>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
 #include "mcrl2/utilities/file_utility.h"
 #include "mcrl2/utilities/detail/memory_utility.h"
 #include "mcrl2/utilities/basename.h"
@@ -749,6 +757,21 @@ size_t RewriterCompilingJitty::binding_variable_list_index(const variable_list&
   return index_for_vl;
 }
 
+// This function assigns a unique index to the statistics s in the rewrite profile,
+// such that the generated code can refer to them.
+size_t RewriterCompilingJitty::profile_statistics_index(rewrite_profile_statistics& s)
+{
+  const std::map<rewrite_profile_statistics*, size_t>::const_iterator i=m_profile_statistics_indices.find(&s);
+  if (i!=m_profile_statistics_indices.end())
+  {
+    return i->second;
+  }
+  const size_t index_for_s=m_profile_statistics.size();
+  m_profile_statistics_indices[&s]=index_for_s;
+  m_profile_statistics.push_back(&s);
+  return index_for_s;
+}
+
 // Put the sorts with indices between actual arity and requested arity in a vector.
 sort_list_vector RewriterCompilingJitty::get_residual_sorts(const sort_expression& s1, size_t actual_arity, size_t requested_arity)
 {
@@ -1003,6 +1026,12 @@ class RewriterCompilingJitty::ImplementTree
   padding m_padding;
   variable_or_number_list m_nnfvars;
 
+  // When the rewriter is profiled, the equations of the function that is being generated,
+  // indexed by the shape of their condition and right hand side, see equation_shape.
+  std::map<atermpp::aterm, data_equation> m_profiled_equations;
+  size_t m_profile_counter;
+  data_expression m_condition; // The condition of the equation of the R node that is being generated.
+
   ///
   /// \brief opid_is_nf establishes whether a function symbol is always in normal form.
   ///        this is the case when there are no rewrite rules for the symbol.
@@ -1571,6 +1600,126 @@ class RewriterCompilingJitty::ImplementTree
     }
   }
 
+  /*
+   * Profiling helper methods
+   *
+   */
+
+  // Renames the variables in t to v0, v1, ... in the order of their first occurrence.
+  static atermpp::aterm rename_variables_in_order(const atermpp::aterm& t, std::map<atermpp::aterm, atermpp::aterm>& renaming)
+  {
+    if (t.type_is_int())
+    {
+      return t;
+    }
+    if (t.type_is_list())
+    {
+      std::vector<atermpp::aterm> elements;
+      for (const atermpp::aterm& e: atermpp::down_cast<atermpp::aterm_list>(t))
+      {
+        elements.push_back(rename_variables_in_order(e, renaming));
+      }
+      return atermpp::aterm_list(elements.begin(), elements.end());
+    }
+    const atermpp::aterm_appl& a = atermpp::down_cast<atermpp::aterm_appl>(t);
+    if (is_variable(a))
+    {
+      std::map<atermpp::aterm, atermpp::aterm>::const_iterator i = renaming.find(a);
+      if (i != renaming.end())
+      {
+        return i->second;
+      }
+      const variable v("v" + std::to_string(renaming.size()), atermpp::down_cast<variable>(a).sort());
+      renaming[a] = v;
+      return v;
+    }
+    std::vector<atermpp::aterm> arguments;
+    for (const atermpp::aterm& b: a)
+    {
+      arguments.push_back(rename_variables_in_order(b, renaming));
+    }
+    return atermpp::aterm_appl(a.function(), arguments.begin(), arguments.end());
+  }
+
+  // The match trees rename the variables of the equations. The equation from which a
+  // condition and a right hand side in a match tree stem is found by comparing them
+  // with the variables renamed in the order of their first occurrence. Equations that
+  // cannot be distinguished in this way share their statistics.
+  static atermpp::aterm equation_shape(const data_expression& condition, const data_expression& rhs)
+  {
+    std::map<atermpp::aterm, atermpp::aterm> renaming;
+    const atermpp::aterm c = rename_variables_in_order(condition, renaming);
+    return atermpp::aterm_list({ c, rename_variables_in_order(rhs, renaming) });
+  }
+
+  void find_profiled_equations(const data::function_symbol& func, size_t arity)
+  {
+    m_profiled_equations.clear();
+    if (m_rewriter.m_profile == nullptr)
+    {
+      return;
+    }
+    for (const data_equation& e: m_rewriter.jittyc_eqns[func])
+    {
+      data_equation lifted_e = e;
+      if (recursive_number_of_args(e.lhs()) <= arity && m_rewriter.lift_rewrite_rule_to_right_arity(lifted_e, arity))
+      {
+        m_profiled_equations.insert(std::make_pair(equation_shape(lifted_e.condition(), lifted_e.rhs()), e));
+      }
+    }
+  }
+
+  // Returns the index of the statistics of the equation with the given condition and right
+  // hand side, or std::size_t(-1) if the rewriter is not profiled.
+  size_t profiled_equation_index(std::ostream& m_stream, const data_expression& condition, const data_expression& rhs)
+  {
+    const std::map<atermpp::aterm, data_equation>::const_iterator i = m_profiled_equations.find(equation_shape(condition, rhs));
+    if (i == m_profiled_equations.end())
+    {
+      return std::size_t(-1);
+    }
+    const size_t index = m_rewriter.profile_statistics_index(m_rewriter.m_profile->equation(i->second));
+    m_stream << m_padding << "// profile [" << index << "] " << i->second << "\n";
+    return index;
+  }
+
+  // Generates code that counts the application of the equation with the given condition and
+  // right hand side, and measures the time to rewrite the right hand side.
+  void profile_equation_application(std::ostream& m_stream, const data_expression& condition, const data_expression& rhs)
+  {
+    const size_t index = profiled_equation_index(m_stream, condition, rhs);
+    if (index != std::size_t(-1))
+    {
+      m_stream << m_padding << "rewrite_profile_statistics& profile_statistics" << m_profile_counter << " = this_rewriter->profile_statistics(" << index << ");\n"
+               << m_padding << "profile_statistics" << m_profile_counter << ".applications++;\n"
+               << m_padding << "rewrite_profile_timer profile_timer" << m_profile_counter << "(&profile_statistics" << m_profile_counter << ");\n";
+      m_profile_counter++;
+    }
+  }
+
+  // Generates code that counts that the condition of the equation with the given condition
+  // and right hand side did not hold.
+  void profile_equation_failure(std::ostream& m_stream, const data_expression& condition, const data_expression& rhs)
+  {
+    const size_t index = profiled_equation_index(m_stream, condition, rhs);
+    if (index != std::size_t(-1))
+    {
+      m_stream << m_padding << "this_rewriter->profile_statistics(" << index << ").failures++;\n";
+    }
+  }
+
+  // Generates code that counts the rewriting of a term with head symbol func, and measures its time.
+  void profile_function_symbol(std::ostream& m_stream, const data::function_symbol& func)
+  {
+    if (m_rewriter.m_profile != nullptr)
+    {
+      const size_t index = m_rewriter.profile_statistics_index(m_rewriter.m_profile->symbol(func));
+      m_stream << m_padding << "rewrite_profile_statistics& profile_statistics = this_rewriter->profile_statistics(" << index << "); // " << func << "\n"
+               << m_padding << "profile_statistics.applications++;\n"
+               << m_padding << "rewrite_profile_timer profile_timer(&profile_statistics);\n";
+    }
+  }
+
   /*
    * implement_tree helper methods
    *
@@ -1779,7 +1928,7 @@ class RewriterCompilingJitty::ImplementTree
              std::stack<std::string>& auxiliary_code_fragments)
   {
     bool reset_current_data_parameters=false;
-    const void* func = (void*)(atermpp::detail::address(tree.function()));
+    const std::string func = "uint_address(" + m_rewriter.m_nf_cache.insert_term(tree.function()) + ")";
     m_stream << m_padding;
     brackets.bracket_nesting_level++;
     if (level == 0)
@@ -1900,7 +2049,9 @@ class RewriterCompilingJitty::ImplementTree
 
     brackets.bracket_nesting_level++;
     m_padding.indent();
+    m_condition = tree.condition();
     implement_tree(m_stream, tree.true_tree(), cur_arg, parent, level, cnt, arity, opid, brackets, auxiliary_code_fragments);
+    m_condition = sort_bool::true_();
     m_padding.unindent();
 
     m_stream << m_padding
@@ -1909,6 +2060,10 @@ class RewriterCompilingJitty::ImplementTree
              << "{\n";
 
     m_padding.indent();
+    if (m_rewriter.m_profile != nullptr && tree.true_tree().isR())
+    {
+      profile_equation_failure(m_stream, tree.condition(), match_tree_R(tree.true_tree()).result());
+    }
     implement_tree(m_stream, tree.false_tree(), cur_arg, parent, level, cnt, arity, opid, brackets, auxiliary_code_fragments);
     m_padding.unindent();
 
@@ -1928,6 +2083,10 @@ class RewriterCompilingJitty::ImplementTree
       cur_arg = m_stack[2 * level - 1];
     }
     
+    if (m_rewriter.m_profile != nullptr)
+    {
+      profile_equation_application(m_stream, m_condition, tree.result());
+    }
     m_stream << m_padding << "return ";
     stringstream result_type_string;
     calc_inner_term(m_stream, tree.result(), cur_arg + 1, m_nnfvars, true, result_type_string);
@@ -1945,16 +2104,27 @@ class RewriterCompilingJitty::ImplementTree
              << "if (";
     calc_inner_term(m_stream, tree.condition(), 0, variable_or_number_list(), true, result_type_string);
     m_stream << " == sort_bool::true_()) // C\n" << m_padding
-             << "{\n" << m_padding
-             << "  return ";
+             << "{\n";
+    m_padding.indent();
+    if (m_rewriter.m_profile != nullptr)
+    {
+      profile_equation_application(m_stream, tree.condition(), match_tree_R(tree.true_tree()).result());
+    }
+    m_stream << m_padding
+             << "return ";
     brackets.bracket_nesting_level++;
     calc_inner_term(m_stream, match_tree_R(tree.true_tree()).result(), 0, m_nnfvars, true, result_type_string);
     brackets.bracket_nesting_level--;
+    m_padding.unindent();
     m_stream << ";\n" << m_padding
              << "}\n" << m_padding
              << "else\n" << m_padding
-             << "{\n" << m_padding;
+             << "{\n";
     m_padding.indent();
+    if (m_rewriter.m_profile != nullptr)
+    {
+      profile_equation_failure(m_stream, tree.condition(), match_tree_R(tree.true_tree()).result());
+    }
     return tree.false_tree();
   }
 
@@ -1964,6 +2134,10 @@ class RewriterCompilingJitty::ImplementTree
              size_t arity)
   {
     stringstream result_type_string;
+    if (m_rewriter.m_profile != nullptr)
+    {
+      profile_equation_application(m_stream, sort_bool::true_(), tree.result());
+    }
     if (arity == 0)
     {
       m_stream << m_padding
@@ -1984,7 +2158,7 @@ class RewriterCompilingJitty::ImplementTree
 
 public:
   ImplementTree(RewriterCompilingJitty& rewr, function_symbol_vector& function_symbols)
-    : m_rewriter(rewr), m_padding(2)
+    : m_rewriter(rewr), m_padding(2), m_profile_counter(0), m_condition(sort_bool::true_())
   {
     for (function_symbol_vector::const_iterator it = function_symbols.begin(); it != function_symbols.end(); ++it)
     {
@@ -2060,6 +2234,8 @@ public:
   {
     bool added_new_parameters_in_brackets=false;
     m_used=nfs_array(arity); // This vector maintains which arguments are in normal form.
+    const bool native_operation=is_native_operation(opid, arity);
+    size_t rewritten_arguments=0;
     while (!strat.empty())
     {
       m_stream << m_padding << "// " << strat.front() <<  "\n";
@@ -2070,6 +2246,11 @@ public:
         {
           m_stream << m_padding << "const data_expression arg" << arg << " = local_rewrite(arg_not_nf" << arg << ");\n";
           m_used[arg] = true;
+          if (native_operation && ++rewritten_arguments == arity)
+          {
+            // Equations that do not need all arguments, such as 0*n=0, have been tried before.
+            implement_native_operation(m_stream, opid, arity);
+          }
           if (!added_new_parameters_in_brackets)
           {
             added_new_parameters_in_brackets=true;
@@ -2245,10 +2426,8 @@ public:
     }
     else
     {
-      stringstream ss;
-      ss << "data_expression((const atermpp::detail::_aterm*)" << (void*)atermpp::detail::address(opid) << ")";
       size_t used_arguments = 0;
-      m_stream << rewr_function_finish_term(arity, ss.str(), down_cast<function_sort>(opid.sort()), used_arguments) << ";\n";
+      m_stream << rewr_function_finish_term(arity, m_rewriter.m_nf_cache.insert_term(opid), down_cast<function_sort>(opid.sort()), used_arguments) << ";\n";
       assert(used_arguments == arity);
     } 
   }
@@ -2287,6 +2466,34 @@ public:
     brackets.current_data_parameters.push(parameters.str());
   }
 
+  // Returns whether func applied to arity arguments is an arithmetic operation that is
+  // evaluated natively when its arguments are numeric constants.
+  bool is_native_operation(const data::function_symbol& func, size_t arity)
+  {
+    return arity > 0 &&
+           m_rewriter.m_native_arithmetic.operation(func) != native_arithmetic::none &&
+           atermpp::down_cast<function_sort>(func.sort()).domain().size() == arity;
+  }
+
+  // Generates code that evaluates func natively if its arguments, which the strategy has
+  // rewritten to the normal forms arg0, ..., argn, are numeric constants.
+  void implement_native_operation(std::ostream& m_stream, const data::function_symbol& func, size_t arity)
+  {
+    m_stream << m_padding << "{\n" << m_padding
+             << "  const data_expression native_arguments[] = { ";
+    for (size_t i = 0; i < arity; ++i)
+    {
+      m_stream << (i == 0 ? "" : ", ") << "arg" << i;
+    }
+    m_stream << " };\n" << m_padding
+             << "  data_expression native_result;\n" << m_padding
+             << "  if (this_rewriter->evaluate_natively(down_cast<function_symbol>(" << m_rewriter.m_nf_cache.insert_term(func) << "), native_arguments, native_result))\n" << m_padding
+             << "  {\n" << m_padding
+             << "    return native_result;\n" << m_padding
+             << "  }\n" << m_padding
+             << "}\n";
+  }
+
   void rewr_function_implementation(
              std::ostream& m_stream, 
              const data::function_symbol& func, 
@@ -2302,6 +2509,8 @@ public:
     rewr_function_signature(m_stream, index, arity, brackets);
     m_stream << "\n" << m_padding << "{\n";
     m_padding.indent();
+    profile_function_symbol(m_stream, func);
+    find_profiled_equations(func, arity);
     implement_strategy(m_stream, strategy, arity, func, brackets, auxiliary_code_fragments);
     m_padding.unindent();
     m_stream << m_padding << "}\n\n";
@@ -2416,11 +2625,35 @@ public:
 
 void RewriterCompilingJitty::CleanupRewriteSystem()
 {
+  if (m_compile_thread.joinable())
+  {
+    // Abandon the compilation in the background, and remove its files.
+    rewriter_so->cancel();
+    m_compile_thread.join();
+    try
+    {
+      rewriter_so->cleanup();
+    }
+    catch (std::runtime_error&)
+    {
+    }
+    rewriter_so->leave_files();
+    // Also remove the files that the default compile script may not yet have reported.
+    std::remove(m_cpp_file.c_str());
+    std::remove((m_cpp_file + ".o").c_str());
+    std::remove((m_cpp_file + ".log").c_str());
+    std::remove((m_cpp_file + ".bin").c_str());
+  }
   m_nf_cache.clear();
   if (so_rewr_cleanup != NULL)
   {
     so_rewr_cleanup();
   }
+  if (m_library_descriptor != -1)
+  {
+    close(m_library_descriptor);
+    m_library_descriptor = -1;
+  }
   if (rewriter_so != NULL)
   {
     delete rewriter_so;
@@ -2589,7 +2822,293 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
   cpp_file.close();
 }
 
+///
+/// \brief The compiled_library_cache class stores compiled rewriter libraries in the
+///        directory given by the environment variable MCRL2_COMPILECACHE, such that
+///        later tool invocations with the same rewrite system do not need to invoke
+///        the compile script again. An entry is addressed by a hash of its key, which
+///        consists of the generated code and everything it refers to. The key itself
+///        is stored next to the library, such that hash collisions are detected.
+///        At most MCRL2_COMPILECACHE_SIZE (default 32) libraries are kept; the least
+///        recently used ones are removed first. A lock file serialises the accesses of
+///        concurrently running tools to the cache directory.
+///
+class compiled_library_cache
+{
+  private:
+    std::string m_directory;
+    size_t m_max_entries;
+    int m_lock;
+
+    std::string entry_filename(const std::string& hash, const std::string& extension) const
+    {
+      return m_directory + "jittyc_" + hash + extension;
+    }
+
+    void lock()
+    {
+      m_lock = open((m_directory + "jittyc.lock").c_str(), O_RDWR | O_CREAT, 0666);
+      if (m_lock >= 0 && flock(m_lock, LOCK_EX) != 0)
+      {
+        close(m_lock);
+        m_lock = -1;
+      }
+    }
+
+    void unlock()
+    {
+      if (m_lock >= 0)
+      {
+        flock(m_lock, LOCK_UN);
+        close(m_lock);
+        m_lock = -1;
+      }
+    }
+
+    static bool copy_file(const std::string& source, const std::string& target)
+    {
+      std::ifstream in(source, std::ios::binary);
+      std::ofstream out(target, std::ios::binary);
+      if (!in || !out)
+      {
+        return false;
+      }
+      out << in.rdbuf();
+      out.close();
+      return !out.fail();
+    }
+
+    // Writes contents to filename, such that other processes never observe a
+    // partially written file.
+    static bool write_file_atomically(const std::string& filename, const std::string& contents, const std::string& source = std::string())
+    {
+      std::stringstream tmp;
+      tmp << filename << "." << getpid() << ".tmp";
+      bool written;
+      if (source.empty())
+      {
+        std::ofstream out(tmp.str(), std::ios::binary);
+        out << contents;
+        out.close();
+        written = !out.fail();
+      }
+      else
+      {
+        written = copy_file(source, tmp.str());
+      }
+      if (!written || std::rename(tmp.str().c_str(), filename.c_str()) != 0)
+      {
+        std::remove(tmp.str().c_str());
+        return false;
+      }
+      return true;
+    }
+
+    // Removes the least recently used libraries, except the one with hash keep,
+    // until at most m_max_entries remain.
+    void evict(const std::string& keep)
+    {
+      DIR* dir = opendir(m_directory.c_str());
+      if (dir == NULL)
+      {
+        return;
+      }
+      std::vector<std::pair<time_t, std::string> > entries;
+      while (dirent* e = readdir(dir))
+      {
+        const std::string name(e->d_name);
+        if (name.compare(0, 7, "jittyc_") == 0 && name.size() > 3 && name.compare(name.size() - 3, 3, ".so") == 0)
+        {
+          struct stat info;
+          if (stat((m_directory + name).c_str(), &info) == 0)
+          {
+            const std::string hash = name.substr(7, name.size() - 10);
+            if (hash != keep)
+            {
+              entries.push_back(std::make_pair(info.st_mtime, hash));
+            }
+          }
+        }
+      }
+      closedir(dir);
+
+      if (entries.size() < m_max_entries)
+      {
+        return;
+      }
+      std::sort(entries.begin(), entries.end());
+      for (size_t i = 0; i <= entries.size() - m_max_entries; ++i)
+      {
+        mCRL2log(debug) << "removing compiled rewriter " << entries[i].second << " from the cache." << std::endl;
+        std::remove(entry_filename(entries[i].second, ".so").c_str());
+        std::remove(entry_filename(entries[i].second, ".key").c_str());
+      }
+    }
+
+  public:
+    compiled_library_cache()
+      : m_max_entries(32), m_lock(-1)
+    {
+      const char* env_dir = std::getenv("MCRL2_COMPILECACHE");
+      if (env_dir != NULL && *env_dir != '\0')
+      {
+        m_directory = env_dir;
+        if (*m_directory.rbegin() != '/')
+        {
+          m_directory.append("/");
+        }
+      }
+      const char* env_size = std::getenv("MCRL2_COMPILECACHE_SIZE");
+      if (env_size != NULL)
+      {
+        m_max_entries = std::max(std::strtoul(env_size, NULL, 10), 1ul);
+      }
+    }
+
+    ~compiled_library_cache()
+    {
+      unlock();
+    }
+
+    /// \brief Reads the contents of a file.
+    static bool read_file(const std::string& filename, std::string& contents)
+    {
+      std::ifstream in(filename, std::ios::binary);
+      if (!in)
+      {
+        return false;
+      }
+      std::stringstream ss;
+      ss << in.rdbuf();
+      contents = ss.str();
+      return true;
+    }
+
+    bool enabled() const
+    {
+      return !m_directory.empty();
+    }
+
+    /// \brief Returns a hash of key, that is used to name its entry in the cache.
+    static std::string hash(const std::string& key)
+    {
+      // 64-bit FNV-1a.
+      uint64_t h = 14695981039346656037ull;
+      for (std::string::const_iterator i = key.begin(); i != key.end(); ++i)
+      {
+        h = (h ^ static_cast<unsigned char>(*i)) * 1099511628211ull;
+      }
+      std::stringstream ss;
+      ss << std::hex << std::setw(16) << std::setfill('0') << h;
+      return ss.str();
+    }
+
+    /// \brief Copies the library stored under key to target.
+    /// \return Whether the cache contained a library for key.
+    bool find(const std::string& key, const std::string& target)
+    {
+      const std::string h = hash(key);
+      std::string stored_key;
+      lock();
+      bool found = mcrl2::utilities::file_exists(entry_filename(h, ".so")) &&
+                   read_file(entry_filename(h, ".key"), stored_key) &&
+                   stored_key == key &&
+                   copy_file(entry_filename(h, ".so"), target);
+      if (found)
+      {
+        // Mark the entry as recently used.
+        utimes(entry_filename(h, ".so").c_str(), NULL);
+      }
+      unlock();
+      return found;
+    }
+
+    /// \brief Stores a copy of the library under key.
+    void insert(const std::string& key, const std::string& library)
+    {
+      const std::string h = hash(key);
+      lock();
+      if (!write_file_atomically(entry_filename(h, ".key"), key) ||
+          !write_file_atomically(entry_filename(h, ".so"), std::string(), library))
+      {
+        mCRL2log(warning) << "could not store the compiled rewriter in " << m_directory << "." << std::endl;
+      }
+      evict(h);
+      unlock();
+    }
+};
+
+// Identifies the build of the toolset that contains the rewriter. The generated code depends on the
+// mCRL2 headers and libraries of that build, which can change without a change of the version.
+// The file that contains this function gets a new size or modification time with every build.
+static std::string toolset_build_identifier()
+{
+  std::stringstream result;
+  result << __DATE__ << " " << __TIME__;
+  Dl_info info;
+  struct stat status;
+  if (dladdr(reinterpret_cast<void*>(&toolset_build_identifier), &info) != 0 && info.dli_fname != nullptr &&
+      stat(info.dli_fname, &status) == 0)
+  {
+    result << " " << info.dli_fname << " " << status.st_size << " " << status.st_mtime;
+  }
+  return result.str();
+}
+
+std::string RewriterCompilingJitty::compiled_library_key(const std::string& cpp_file, const std::string& compile_script)
+{
+  std::stringstream key;
+  key << "toolset: " << mcrl2::utilities::get_toolset_version() << "\n";
+  key << "build: " << toolset_build_identifier() << "\n";
+  key << "script: " << compile_script << "\n";
+  const char* env_cxx = std::getenv("CXX");
+  key << "compiler: " << (env_cxx == NULL ? "" : env_cxx) << "\n";
+
+  std::string contents;
+  if (compiled_library_cache::read_file(compile_script, contents))
+  {
+    key << contents << "\n";
+  }
+
+  // The generated code refers to the following terms by their index. The function
+  // symbols with precompiled rewrite functions are described in the code itself.
+  for (const data_expression& t: m_nf_cache.terms())
+  {
+    key << atermpp::aterm(t) << "\n";
+  }
+  for (const variable& v: rewriter_bound_variables)
+  {
+    key << atermpp::aterm(v) << "\n";
+  }
+  for (const variable_list& l: rewriter_binding_variable_lists)
+  {
+    key << atermpp::aterm(l) << "\n";
+  }
+
+  if (!compiled_library_cache::read_file(cpp_file, contents))
+  {
+    return std::string();
+  }
+  key << contents;
+  return key.str();
+}
+
 void RewriterCompilingJitty::BuildRewriteSystem()
+{
+  if (!GenerateRewriteSystem())
+  {
+    mCRL2log(verbose) << "compiling " << m_cpp_file << "..." << std::endl;
+    CompileRewriteSystem();
+  }
+  LoadRewriteSystem();
+}
+
+///
+/// \brief GenerateRewriteSystem generates the C++ code for the rewrite system.
+/// \return True if a compiled library for this code was found in the cache, in
+///         which case the library does not have to be compiled.
+///
+bool RewriterCompilingJitty::GenerateRewriteSystem()
 {
   CleanupRewriteSystem();
 
@@ -2626,14 +3145,35 @@ void RewriterCompilingJitty::BuildRewriteSystem()
     jittyc_eqns[get_function_symbol_of_head(it->lhs())].push_front(*it);
   }
 
-  std::string cpp_file = generate_cpp_filename(reinterpret_cast<size_t>(this));
-  generate_code(cpp_file);
+  m_cpp_file = generate_cpp_filename(reinterpret_cast<size_t>(this));
+  generate_code(m_cpp_file);
 
-  mCRL2log(verbose) << "compiling " << cpp_file << "..." << std::endl;
+  compiled_library_cache cache;
+  m_cache_key.clear();
+  if (cache.enabled())
+  {
+    m_cache_key = compiled_library_key(m_cpp_file, compile_script);
+  }
 
+  if (!m_cache_key.empty() && cache.find(m_cache_key, m_cpp_file + ".bin"))
+  {
+    mCRL2log(verbose) << "using the compiled rewriter " << compiled_library_cache::hash(m_cache_key) << " from the cache." << std::endl;
+    std::remove(m_cpp_file.c_str());
+    rewriter_so->use_compiled(m_cpp_file + ".bin");
+    return true;
+  }
+  return false;
+}
+
+///
+/// \brief CompileRewriteSystem compiles the generated code. As it does not
+///        access any terms, it can be run in a separate thread.
+///
+void RewriterCompilingJitty::CompileRewriteSystem()
+{
   try
   {
-    rewriter_so->compile(cpp_file);
+    rewriter_so->compile(m_cpp_file);
   }
   catch(std::runtime_error& e)
   {
@@ -2641,6 +3181,15 @@ void RewriterCompilingJitty::BuildRewriteSystem()
     throw mcrl2::runtime_error(std::string("Could not compile rewriter: ") + e.what());
   }
 
+  if (!m_cache_key.empty())
+  {
+    compiled_library_cache cache;
+    cache.insert(m_cache_key, rewriter_so->filename());
+  }
+}
+
+void RewriterCompilingJitty::LoadRewriteSystem()
+{
   mCRL2log(verbose) << "loading rewriter..." << std::endl;
 
   bool (*init)(rewriter_interface*);
@@ -2657,6 +3206,10 @@ void RewriterCompilingJitty::BuildRewriteSystem()
 #endif
   }
 
+  // Keep the library open, such that it can still be copied by clone() after the
+  // file has been removed.
+  m_library_descriptor = open(rewriter_so->filename().c_str(), O_RDONLY);
+
 #ifdef NDEBUG // In non debug mode clear compiled files directly after loading.
   try
   {
@@ -2680,15 +3233,164 @@ void RewriterCompilingJitty::BuildRewriteSystem()
   mCRL2log(verbose) << interface.status << std::endl;
 }
 
+void RewriterCompilingJitty::StartBackgroundCompilation()
+{
+  m_compilation_finished = false;
+  m_compilation_failed = false;
+  m_compilation_error.clear();
+  if (GenerateRewriteSystem())
+  {
+    m_compilation_finished = true;
+    return;
+  }
+  mCRL2log(verbose) << "compiling " << m_cpp_file << " in the background..." << std::endl;
+  m_compile_thread = std::thread([this]()
+  {
+    try
+    {
+      CompileRewriteSystem();
+    }
+    catch (mcrl2::runtime_error& e)
+    {
+      m_compilation_error = e.what();
+    }
+    m_compilation_finished = true;
+  });
+}
+
+///
+/// \brief FinishBackgroundCompilation loads the rewriter after its compilation in
+///        the background has finished.
+/// \return True if the compiled rewriter has been loaded; false if it could not
+///         be compiled or loaded, in which case the jitty rewriter remains in use.
+///
+bool RewriterCompilingJitty::FinishBackgroundCompilation()
+{
+  if (m_compilation_failed)
+  {
+    return false;
+  }
+  if (m_compile_thread.joinable())
+  {
+    m_compile_thread.join();
+  }
+  try
+  {
+    if (!m_compilation_error.empty())
+    {
+      throw mcrl2::runtime_error(m_compilation_error);
+    }
+    LoadRewriteSystem();
+  }
+  catch (mcrl2::runtime_error& e)
+  {
+    mCRL2log(warning) << e.what() << "; continuing with the jitty rewriter." << std::endl;
+    m_compilation_failed = true;
+    return false;
+  }
+  mCRL2log(verbose) << "switched from the jitty rewriter to the compiled rewriter." << std::endl;
+  return true;
+}
+
+///
+/// \brief copy_library copies the contents of the open file descriptor to the file
+///        filename.
+///
+static void copy_library(int descriptor, const std::string& filename)
+{
+  std::ofstream out(filename, std::ios::binary);
+  char buffer[65536];
+  off_t offset = 0;
+  ssize_t n;
+  while ((n = pread(descriptor, buffer, sizeof(buffer), offset)) > 0)
+  {
+    out.write(buffer, n);
+    offset += n;
+  }
+  out.close();
+  if (n < 0 || !out)
+  {
+    std::remove(filename.c_str());
+    throw mcrl2::runtime_error("Could not copy the compiled rewriter to " + filename + ".");
+  }
+}
+
+RewriterCompilingJitty::RewriterCompilingJitty(RewriterCompilingJitty& other)
+  : Rewriter(other),
+    jitty_rewriter(other.jitty_rewriter),
+    rewrite_rules(other.rewrite_rules),
+    made_files(other.made_files),
+    jittyc_eqns(other.jittyc_eqns),
+    m_extra_symbols(other.m_extra_symbols),
+    m_nf_cache(jitty_rewriter),
+    m_native_arithmetic(other.m_native_arithmetic),
+    m_profile(other.m_profile),
+    m_profile_statistics(other.m_profile_statistics),
+    m_profile_statistics_indices(other.m_profile_statistics_indices),
+    m_compile_in_background(other.m_compile_in_background),
+    m_compilation_finished(true),
+    m_compilation_failed(false)
+{
+  so_rewr_cleanup = NULL;
+  so_rewr = NULL;
+  rewriter_so = NULL;
+  m_library_descriptor = -1;
+  if (m_profile != nullptr)
+  {
+    m_profile->attach();
+  }
+
+  // A rewriter that is still compiled in the background is cloned after its compilation.
+  if (other.so_rewr == NULL && !other.m_compilation_failed)
+  {
+    other.FinishBackgroundCompilation();
+  }
+  if (other.so_rewr == NULL)
+  {
+    m_compilation_failed = true;
+    return;
+  }
+
+  rewriter_binding_variable_lists = other.rewriter_binding_variable_lists;
+  variable_list_indices1 = other.variable_list_indices1;
+  rewriter_bound_variables = other.rewriter_bound_variables;
+  variable_indices0 = other.variable_indices0;
+  m_nf_cache.assign(other.m_nf_cache);
+
+  // The generated library stores its rewriter in a global variable. Therefore a copy of
+  // the library is loaded, which the dynamic loader regards as a different library.
+  m_cpp_file = generate_cpp_filename(reinterpret_cast<size_t>(this));
+  copy_library(other.m_library_descriptor, m_cpp_file + ".bin");
+  rewriter_so = new uncompiled_library(other.rewriter_so->compile_script());
+  rewriter_so->use_compiled(m_cpp_file + ".bin");
+  LoadRewriteSystem();
+}
+
+Rewriter* RewriterCompilingJitty::clone()
+{
+  return new RewriterCompilingJitty(*this);
+}
+
 RewriterCompilingJitty::RewriterCompilingJitty(
                           const data_specification& data_spec,
-                          const used_data_equation_selector& equation_selector)
+                          const used_data_equation_selector& equation_selector,
+                          bool compile_in_background)
   : Rewriter(data_spec,equation_selector),
     jitty_rewriter(data_spec,equation_selector),
-    m_nf_cache(jitty_rewriter)
+    m_nf_cache(jitty_rewriter),
+    m_profile(get_rewrite_profile()),
+    m_compile_in_background(compile_in_background),
+    m_compilation_finished(false),
+    m_compilation_failed(false)
 {
   so_rewr_cleanup = NULL;
+  so_rewr = NULL;
   rewriter_so = NULL;
+  m_library_descriptor = -1;
+  if (m_profile != nullptr)
+  {
+    m_profile->attach();
+  }
 
   made_files = false;
   rewrite_rules.clear();
@@ -2715,12 +3417,23 @@ RewriterCompilingJitty::RewriterCompilingJitty(
     }
   }
 
-  BuildRewriteSystem();
+  if (m_compile_in_background)
+  {
+    StartBackgroundCompilation();
+  }
+  else
+  {
+    BuildRewriteSystem();
+  }
 }
 
 RewriterCompilingJitty::~RewriterCompilingJitty()
 {
   CleanupRewriteSystem();
+  if (m_profile != nullptr)
+  {
+    m_profile->detach();
+  }
 }
 
 data_expression RewriterCompilingJitty::rewrite(
@@ -2730,6 +3443,15 @@ data_expression RewriterCompilingJitty::rewrite(
 #ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
   data::detail::increment_rewrite_count();
 #endif
+  if (so_rewr == NULL)
+  {
+    // The rewriter is compiled in the background. Use the jitty rewriter until
+    // the compilation has finished.
+    if (!m_compilation_finished || !FinishBackgroundCompilation())
+    {
+      return jitty_rewriter.rewrite(term, sigma);
+    }
+  }
   // Save global sigma and restore it afterwards, as rewriting might be recursive with different
   // substitutions, due to the enumerator.
   substitution_type *saved_sigma=global_sigma;
@@ -2739,9 +3461,36 @@ data_expression RewriterCompilingJitty::rewrite(
   return result;
 }
 
+void RewriterCompilingJitty::rewrite_vector(
+     const data_expression* terms,
+     std::size_t size,
+     data_expression* result,
+     substitution_type& sigma)
+{
+  if (so_rewr == NULL)
+  {
+    if (!m_compilation_finished || !FinishBackgroundCompilation())
+    {
+      jitty_rewriter.rewrite_vector(terms, size, result, sigma);
+      return;
+    }
+  }
+  // The substitution is installed once for the whole sequence.
+  substitution_type *saved_sigma=global_sigma;
+  global_sigma=&sigma;
+  rewrite_vector_with(terms, size, result, sigma, [&](const data_expression& t)
+    {
+#ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
+      data::detail::increment_rewrite_count();
+#endif
+      return so_rewr(t);
+    });
+  global_sigma=saved_sigma;
+}
+
 rewrite_strategy RewriterCompilingJitty::getStrategy()
 {
-  return jitty_compiling;
+  return m_compile_in_background ? jitty_tiered : jitty_compiling;
 }
 
 }
@@ -26,9 +26,11 @@
 #endif
 
 #include "mcrl2/data/detail/rewrite/with_prover.h"
+#include "mcrl2/data/detail/rewrite/rewrite_profile.h"
 
 #include "mcrl2/data/detail/rewriter_wrapper.h"
 #include "mcrl2/data/enumerator.h"
+#include "mcrl2/data/parallel_enumerator.h"
 #include "mcrl2/data/substitutions/mutable_map_substitution.h"
 
 using namespace mcrl2::core;
@@ -98,6 +100,15 @@ data_expression_list Rewriter::rewrite_list(
   return data_expression_list(terms.begin(),terms.end(),r);
 }
 
+void Rewriter::rewrite_vector(
+     const data_expression* terms,
+     std::size_t size,
+     data_expression* result,
+     substitution_type& sigma)
+{
+  rewrite_vector_with(terms, size, result, sigma, [&](const data_expression& t) { return rewrite(t, sigma); });
+}
+
 data_expression Rewriter::rewrite_where(
                       const where_clause& term,
                       substitution_type& sigma)
@@ -290,6 +301,51 @@ data_expression Rewriter::rewrite_lambda_application(
   return rewrite(application(result, args.begin(), args.end()),sigma);
 }
 
+template <class EnumeratorListElement, class Filter, class IsFinal>
+void Rewriter::parallel_quantifier_enumeration(
+      const variable_list& vl,
+      const data_expression& t,
+      substitution_type& sigma,
+      IsFinal is_final,
+      std::vector<EnumeratorListElement>& solutions)
+{
+  typedef enumerator_algorithm_with_iterator<rewriter_wrapper, EnumeratorListElement, Filter, rewriter_wrapper, rewriter_wrapper::substitution_type> enumerator_type;
+
+  const size_t thread_count = get_enumerator_thread_count();
+  while (m_enumeration_workers.size() + 1 < thread_count)
+  {
+    m_enumeration_workers.push_back(std::shared_ptr<Rewriter>(clone()));
+  }
+
+  // The enumerators keep references to the wrapped rewriters, hence the reserve.
+  std::vector<rewriter_wrapper> wrapped_rewriters;
+  wrapped_rewriters.reserve(thread_count);
+  std::deque<enumerator_type> enumerators;
+  std::deque<substitution_type> worker_sigmas;
+  std::vector<const enumerator_type*> E;
+  std::vector<substitution_type*> sigmas;
+  for (size_t k = 0; k < thread_count; ++k)
+  {
+    Rewriter* r = (k == 0 ? this : m_enumeration_workers[k - 1].get());
+    wrapped_rewriters.emplace_back(r);
+    enumerators.emplace_back(wrapped_rewriters.back(), m_data_specification_for_enumeration, wrapped_rewriters.back(), npos(), true);
+    enumerators.back().set_domain_cache(r->m_enumerator_domain_cache);
+    E.push_back(&enumerators.back());
+    if (k == 0)
+    {
+      sigmas.push_back(&sigma);
+    }
+    else
+    {
+      worker_sigmas.push_back(sigma);
+      sigmas.push_back(&worker_sigmas.back());
+    }
+  }
+
+  std::deque<EnumeratorListElement> P(1, EnumeratorListElement(vl, t));
+  parallel_enumerate(E, sigmas, P, Filter(), is_final, solutions);
+}
+
 data_expression Rewriter::existential_quantifier_enumeration(
      const abstraction& t,
      substitution_type& sigma)
@@ -353,6 +409,26 @@ data_expression Rewriter::existential_quantifier_enumeration(
     return t3; // No quantified variables are bound.
   }
 
+  if (sorts_are_finite && use_parallel_enumeration() && get_rewrite_profile() == nullptr)
+  {
+    std::vector<enumerator_list_element<> > solutions;
+    parallel_quantifier_enumeration<enumerator_list_element<>, data::is_not_false>(vl_new_l, t3, sigma,
+                 [](const data_expression& x) { return x == sort_bool::true_(); }, solutions);
+    data_expression partial_result=sort_bool::false_();
+    for (const enumerator_list_element<>& sol: solutions)
+    {
+      if (partial_result==sort_bool::false_())
+      {
+        partial_result=sol.expression();
+      }
+      else if (partial_result!=sort_bool::true_())
+      {
+        partial_result=application(sort_bool::or_(), partial_result,sol.expression());
+      }
+    }
+    return partial_result;
+  }
+
   /* Find A solution*/
   rewriter_wrapper wrapped_rewriter(this);
   const bool throw_exceptions = true;
@@ -360,6 +436,7 @@ data_expression Rewriter::existential_quantifier_enumeration(
 
   typedef enumerator_algorithm_with_iterator<rewriter_wrapper, enumerator_list_element<>, data::is_not_false, rewriter_wrapper, rewriter_wrapper::substitution_type> enumerator_type;
   enumerator_type enumerator(wrapped_rewriter, m_data_specification_for_enumeration, wrapped_rewriter, max_count, throw_exceptions);
+  enumerator.set_domain_cache(m_enumerator_domain_cache);
 
   /* Create a list to store solutions */
   data_expression partial_result=sort_bool::false_();
@@ -456,6 +533,26 @@ data_expression Rewriter::universal_quantifier_enumeration(
     return t3; // No quantified variables occur in the rewritten body.
   }
 
+  if (sorts_are_finite && use_parallel_enumeration() && get_rewrite_profile() == nullptr)
+  {
+    std::vector<enumerator_list_element<> > solutions;
+    parallel_quantifier_enumeration<enumerator_list_element<>, data::is_not_true>(vl_new_l, t3, sigma,
+                 [](const data_expression& x) { return x == sort_bool::false_(); }, solutions);
+    data_expression partial_result=sort_bool::true_();
+    for (const enumerator_list_element<>& sol: solutions)
+    {
+      if (partial_result==sort_bool::true_())
+      {
+        partial_result=sol.expression();
+      }
+      else if (partial_result!=sort_bool::false_())
+      {
+        partial_result=application(sort_bool::and_(), partial_result, sol.expression());
+      }
+    }
+    return partial_result;
+  }
+
   /* Find A solution*/
   rewriter_wrapper wrapped_rewriter(this);
   const bool throw_exceptions = true;
@@ -463,6 +560,7 @@ data_expression Rewriter::universal_quantifier_enumeration(
 
   typedef enumerator_algorithm_with_iterator<rewriter_wrapper, enumerator_list_element<>, data::is_not_true, rewriter_wrapper, rewriter_wrapper::substitution_type> enumerator_type;
   enumerator_type enumerator(wrapped_rewriter, m_data_specification_for_enumeration, wrapped_rewriter, max_count, throw_exceptions);
+  enumerator.set_domain_cache(m_enumerator_domain_cache);
 
   /* Create lists to store solutions */
   data_expression partial_result=sort_bool::true_();
@@ -510,6 +608,8 @@ Rewriter* createRewriter(
 #ifdef MCRL2_JITTYC_AVAILABLE
     case jitty_compiling:
       return new RewriterCompilingJitty(DataSpec,equations_selector);
+    case jitty_tiered:
+      return new RewriterCompilingJitty(DataSpec,equations_selector,true);
 #endif
     case jitty_prover:
       return new RewriterProver(DataSpec,jitty,equations_selector);
@@ -37,6 +37,20 @@ RewriterProver::RewriterProver(const data_specification& data_spec,
   rewr_obj = prover_obj->get_rewriter();
 }
 
+RewriterProver::RewriterProver(const data_specification& data_spec,
+                               const used_data_equation_selector& equations_selector,
+                               const std::shared_ptr<detail::Rewriter>& rewriter):
+  Rewriter(data_spec, equations_selector)
+{
+  prover_obj = new BDD_Prover(data_spec, rewriter);
+  rewr_obj = prover_obj->get_rewriter();
+}
+
+Rewriter* RewriterProver::clone()
+{
+  return new RewriterProver(m_data_specification_for_enumeration, data_equation_selector, std::shared_ptr<detail::Rewriter>(rewr_obj->clone()));
+}
+
 RewriterProver::~RewriterProver()
 {
   delete prover_obj;
@@ -6,6 +6,8 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#include <algorithm>
+#include <limits>
 #include <set>
 #include <sstream>
 #include <stack>
@@ -22,6 +24,7 @@
 #include "mcrl2/data/expression_traits.h"
 #include "mcrl2/data/enumerator.h"
 #include "mcrl2/data/optimized_boolean_operators.h"
+#include "mcrl2/data/parallel_enumerator.h"
 #include "mcrl2/data/detail/concepts.h"
 #include "mcrl2/data/detail/print_utility.h"
 #include "mcrl2/data/standard_utility.h"
@@ -424,6 +427,132 @@ BOOST_AUTO_TEST_CASE(cannot_enumerate_real_with_substitution)
   BOOST_CHECK(false);
 }
 
+// Enumerates the solutions of phi for the variables, and returns them as strings.
+template <typename Enumerator>
+std::vector<std::string> enumerate_solutions(const Enumerator& enumerator, const rewriter& rewr, const variable_list& variables, const data_expression& phi)
+{
+  typedef enumerator_list_element_with_substitution<> enumerator_element;
+  std::vector<std::string> result;
+  mutable_indexed_substitution<> sigma;
+  std::deque<enumerator_element> enumerator_deque(1, enumerator_element(variables, phi));
+  for (auto i = enumerator.begin(sigma, enumerator_deque); i != enumerator.end() ; ++i)
+  {
+    mutable_map_substitution<> rho;
+    i->add_assignments(variables, rho, rewr);
+    result.push_back(data::pp(rho));
+  }
+  return result;
+}
+
+// The domains of sorts are cached by the enumerator. Enumerating with the cached
+// domains must give the same solutions, in the same order, as without a cache.
+BOOST_AUTO_TEST_CASE(domain_cache_test)
+{
+  typedef enumerator_algorithm_with_iterator<> enumerator_type;
+
+  data_specification dataspec = parse_data_specification("sort D = struct d1 | d2 | d3;");
+  dataspec.add_context_sort(sort_fset::fset(sort_bool::bool_()));
+  dataspec.add_context_sort(function_sort({ sort_bool::bool_() }, basic_sort("D")));
+  const variable_list variables = parse_variable_list("f: Bool -> D; s: FSet(Bool); d: D; e: D;", dataspec);
+  const data_expression phi = parse_data_expression("f(true) != d && (true in s || d == e)", variables, dataspec);
+  rewriter rewr(dataspec);
+
+  detail::set_enumerator_domain_cache_size(0);
+  enumerator_type uncached_enumerator(rewr, dataspec, rewr);
+  detail::set_enumerator_domain_cache_size(65536);
+  const std::vector<std::string> expected = enumerate_solutions(uncached_enumerator, rewr, variables, phi);
+  BOOST_CHECK_EQUAL(expected.size(), 144u);
+
+  enumerator_type enumerator(rewr, dataspec, rewr);
+  BOOST_CHECK(enumerate_solutions(enumerator, rewr, variables, phi) == expected);
+  BOOST_CHECK(enumerate_solutions(enumerator, rewr, variables, phi) == expected);
+
+  detail::enumerator_domain_cache cache;
+  enumerator_type other_enumerator(rewr, dataspec, rewr);
+  other_enumerator.set_domain_cache(cache);
+  BOOST_CHECK(enumerate_solutions(other_enumerator, rewr, variables, phi) == expected);
+  BOOST_CHECK(cache.find(sort_fset::fset(sort_bool::bool_())) != nullptr);
+  BOOST_CHECK(cache.find(function_sort({ sort_bool::bool_() }, basic_sort("D")))->size() == 9);
+}
+
+// Enumerates the solutions of phi for the variables with parallel_enumerate, using thread_count
+// enumerators, and returns them as strings.
+template <typename IsFinal>
+std::vector<std::string> parallel_enumerate_solutions(std::size_t thread_count, const data_specification& dataspec, const rewriter& rewr, const variable_list& variables, const data_expression& phi, IsFinal is_final, std::size_t max_count = (std::numeric_limits<std::size_t>::max)(), bool* complete = nullptr)
+{
+  typedef enumerator_list_element_with_substitution<> enumerator_element;
+  typedef enumerator_algorithm<> enumerator_type;
+
+  // The enumerators keep references to their rewriters and identifier generators.
+  std::deque<rewriter> rewriters;
+  std::deque<enumerator_identifier_generator> id_generators;
+  std::deque<mutable_indexed_substitution<> > sigmas;
+  std::deque<enumerator_type> enumerators;
+  std::vector<const enumerator_type*> E;
+  std::vector<mutable_indexed_substitution<>*> sigma;
+  for (std::size_t k = 0; k < thread_count; ++k)
+  {
+    rewriters.push_back(rewr.clone());
+    id_generators.emplace_back();
+    sigmas.emplace_back();
+    enumerators.emplace_back(rewriters.back(), dataspec, rewriters.back(), id_generators.back(), max_count, false);
+    E.push_back(&enumerators.back());
+    sigma.push_back(&sigmas.back());
+  }
+
+  std::deque<enumerator_element> P(1, enumerator_element(variables, phi));
+  std::vector<enumerator_element> solutions;
+  bool result = parallel_enumerate(E, sigma, P, is_not_false(), is_final, solutions, 2);
+  if (complete != nullptr)
+  {
+    *complete = result;
+  }
+  BOOST_CHECK(P.empty());
+
+  std::vector<std::string> solution_strings;
+  for (const enumerator_element& p: solutions)
+  {
+    mutable_map_substitution<> rho;
+    p.add_assignments(variables, rho, rewr);
+    solution_strings.push_back(data::pp(rho));
+  }
+  return solution_strings;
+}
+
+BOOST_AUTO_TEST_CASE(parallel_enumerate_test)
+{
+  data_specification dataspec = parse_data_specification("sort D = struct d1 | d2 | d3;");
+  dataspec.add_context_sort(sort_fset::fset(sort_bool::bool_()));
+  dataspec.add_context_sort(function_sort({ sort_bool::bool_() }, basic_sort("D")));
+  const variable_list variables = parse_variable_list("f: Bool -> D; s: FSet(Bool); d: D; e: D;", dataspec);
+  const data_expression phi = parse_data_expression("f(true) != d && (true in s || d == e)", variables, dataspec);
+  rewriter rewr(dataspec);
+  auto never = [](const data_expression&) { return false; };
+
+  enumerator_algorithm_with_iterator<> enumerator(rewr, dataspec, rewr);
+  std::vector<std::string> expected = enumerate_solutions(enumerator, rewr, variables, phi);
+  std::sort(expected.begin(), expected.end());
+
+  for (std::size_t thread_count: { 1, 3, 4 })
+  {
+    std::vector<std::string> solutions = parallel_enumerate_solutions(thread_count, dataspec, rewr, variables, phi, never);
+    BOOST_CHECK(parallel_enumerate_solutions(thread_count, dataspec, rewr, variables, phi, never) == solutions);
+    std::sort(solutions.begin(), solutions.end());
+    BOOST_CHECK(solutions == expected);
+  }
+
+  // The enumeration stops at the first solution that is final.
+  std::vector<std::string> solutions = parallel_enumerate_solutions(4, dataspec, rewr, variables, phi, [](const data_expression& x) { return x == sort_bool::true_(); });
+  BOOST_CHECK(!solutions.empty() && solutions.size() < expected.size());
+
+  // The maximal number of iterations applies to all enumerators together.
+  bool complete = true;
+  parallel_enumerate_solutions(4, dataspec, rewr, variables, phi, never, 10, &complete);
+  BOOST_CHECK(!complete);
+  parallel_enumerate_solutions(4, dataspec, rewr, variables, phi, never, 100000, &complete);
+  BOOST_CHECK(complete);
+}
+
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 {
   return nullptr;
@@ -312,6 +312,35 @@ void test_ticket_1209()
   BOOST_CHECK(result == expected_result);
 }
 
+// A data expression of depth 100 in which each level uses the level below it twice,
+// so it has 2^100 paths but only about 100 distinct subexpressions.
+void test_memoized_replace_variables()
+{
+  using namespace mcrl2::data::sort_bool;
+
+  variable b("b", bool_());
+  variable c("c", bool_());
+  data_expression x = b;
+  data_expression y = c;
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    x = and_(x, or_(x, false_()));
+    y = and_(y, or_(y, false_()));
+  }
+  mutable_map_substitution<> sigma;
+  sigma[b] = c;
+  BOOST_CHECK(data::memoized_replace_variables(x, sigma) == y);
+
+  // the same result as replace_variables on a small expression with binders
+  std::vector<variable> variables = { b };
+  data_expression z = parse_data_expression("forall d: Bool. d => b && b", variables);
+  BOOST_CHECK(data::memoized_replace_variables(z, sigma) == data::replace_variables(z, sigma));
+
+  data_expression_vector v = { x, b };
+  data::memoized_replace_variables(v, sigma);
+  BOOST_CHECK(v == data_expression_vector({ y, c }));
+}
+
 int test_main(int argc, char** argv)
 {
   test_assignment_list();
@@ -321,6 +350,7 @@ int test_main(int argc, char** argv)
   test_replace_variables_capture_avoiding();
   test_replace_free_variables();
   test_ticket_1209();
+  test_memoized_replace_variables();
 
   return 0;
 }
@@ -9,6 +9,9 @@
 /// \file rewriter_test.cpp
 /// \brief Add your file description here.
 
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -18,15 +21,31 @@
 #include "mcrl2/data/find.h"
 #include "mcrl2/data/parse.h"
 #include "mcrl2/data/rewriter.h"
+#include "mcrl2/data/standard_numbers_utility.h"
 #include "mcrl2/data/function_sort.h"
 #include "mcrl2/data/detail/data_functional.h"
 #include "mcrl2/data/detail/parse_substitution.h"
 #include "mcrl2/data/detail/test_rewriters.h"
 #include "mcrl2/data/detail/one_point_rule_preprocessor.h"
+#include "mcrl2/data/detail/rewrite/closed_term_cache.h"
+#include "mcrl2/data/detail/rewrite/rewrite_profile.h"
+#include "mcrl2/data/parallel_enumerator.h"
 #include "mcrl2/data/rewriters/simplify_rewriter.h"
 #include "mcrl2/data/print.h"
 #include "mcrl2/utilities/text_utility.h"
 
+#ifdef MCRL2_JITTYC_AVAILABLE
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include "mcrl2/data/detail/rewrite/jittyc.h"
+#endif
+
 using namespace mcrl2;
 using namespace mcrl2::core;
 using namespace mcrl2::data;
@@ -196,6 +215,521 @@ void simplify_rewriter_test()
   test_rewriters(N(R), N(I), "forall b:Bool. !!b", "forall b:Bool. b");
 }
 
+// The normal forms of closed terms are cached, but the cache may not
+// be used for terms of which the normal form depends on the substitution.
+void closed_term_cache_test()
+{
+  std::string DATA_SPEC1 =
+    "sort D = struct d1 | d2 | d3;\n"
+    "map f: D -> D;\n"
+    "eqn f(d1) = d2;\n"
+    "    f(d2) = d3;\n"
+    "    f(d3) = d1;\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+
+  data::detail::set_closed_term_cache_size(1000);
+  data::rewriter R(data_spec, jitty);
+  data::detail::set_closed_term_cache_size(0);
+
+  const std::vector<variable> x { variable("x", basic_sort("D")) };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    for (const std::string& value: { "d1", "d2", "d3" })
+    {
+      data::rewriter::substitution_type sigma;
+      sigma[x.front()] = parse_data_expression(value, data_spec);
+      BOOST_CHECK(R(parse_data_expression("f(f(d1))", x, data_spec), sigma) == parse_data_expression("d3", data_spec));
+      BOOST_CHECK(R(parse_data_expression("f(f(f(d1))) == d1 && 2 + 3 == 5", x, data_spec), sigma) == sort_bool::true_());
+      BOOST_CHECK(R(parse_data_expression("f(f(f(x)))", x, data_spec), sigma) == sigma(x.front()));
+      BOOST_CHECK(R(parse_data_expression("(lambda x: D. f(x))(d1)", x, data_spec), sigma) == parse_data_expression("d2", data_spec));
+    }
+  }
+}
+
+// Functions with many equations are rewritten using an index on the head symbols of
+// their arguments. Equations that do not have a head symbol at the indexed argument
+// must still be tried, in the order of the strategy.
+void indexed_strategy_test()
+{
+  std::string DATA_SPEC1 =
+    "sort D = struct c1 | c2 | c3 | c4?is_c4 | c5 | e(D);\n"
+    "map g: D # Nat -> Nat;\n"
+    "    h: D # D -> Nat;\n"
+    "var d, d1: D;\n"
+    "    n: Nat;\n"
+    "eqn g(c1, n) = 1;\n"
+    "    g(c2, n) = 2;\n"
+    "    g(c3, n) = 3;\n"
+    "    n > 5 -> g(c5, n) = 100;\n"
+    "    n <= 5 -> g(c5, n) = 5;\n"
+    "    g(e(d), n) = g(d, n) + 10;\n"
+    "    h(c1, d) = 1;\n"
+    "    h(c2, d) = 2;\n"
+    "    is_c4(d) -> h(d, c1) = 4;\n"
+    "    h(c3, c3) = 3;\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+  data::rewriter R(data_spec, jitty);
+  const std::vector<variable> x { variable("x", basic_sort("D")) };
+
+  const std::vector<std::pair<std::string, std::string> > cases =
+  {
+    { "g(c1, 7)", "1" },
+    { "g(c3, 0)", "3" },
+    { "g(c5, 7)", "100" },
+    { "g(c5, 2)", "5" },
+    { "g(e(e(c2)), 2)", "22" },
+    { "g(c4, 2)", "g(c4, 2)" },
+    { "g(x, 2)", "g(x, 2)" },
+    { "h(c2, c5)", "2" },
+    { "h(c4, c1)", "4" },
+    { "h(c4, c2)", "h(c4, c2)" },
+    { "h(c3, c3)", "3" },
+    { "h(x, c1)", "h(x, c1)" }
+  };
+  for (const std::pair<std::string, std::string>& c: cases)
+  {
+    // The expected normal form is not rewritten, such that a term that must remain stuck
+    // is compared with itself. The numbers are all of sort Nat.
+    const data_expression result = R(parse_data_expression(c.first, x, data_spec));
+    const data_expression expected = std::isdigit(c.second[0]) ? sort_nat::nat(c.second) : parse_data_expression(c.second, x, data_spec);
+    BOOST_CHECK(result == expected);
+    if (result != expected)
+    {
+      std::cout << "--- failed test --- " << c.first << " rewrites to " << result << " instead of " << expected << std::endl;
+    }
+  }
+}
+
+// The rewriter counts the applications of equations when a rewrite profile is enabled.
+void rewrite_profile_test()
+{
+  std::string DATA_SPEC1 =
+    "sort D = struct d1 | d2 | d3;\n"
+    "map f: D -> D;\n"
+    "    g: Nat -> Nat;\n"
+    "var n: Nat;\n"
+    "eqn f(d1) = d2;\n"
+    "    f(d2) = d3;\n"
+    "    f(d3) = d1;\n"
+    "    n > 5 -> g(n) = 1;\n"
+    "    n <= 5 -> g(n) = 0;\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+
+  const std::string filename = "rewriter_test_profile.txt";
+  rewrite_profile profile(filename);
+  rewrite_profile_instance<std::size_t>::profile = &profile;
+  {
+    data::rewriter R(data_spec, jitty);
+    BOOST_CHECK(R(parse_data_expression("f(f(f(d1)))", data_spec)) == parse_data_expression("d1", data_spec));
+    BOOST_CHECK(R(parse_data_expression("g(2)", data_spec)) == parse_data_expression("0", data_spec));
+  }
+  rewrite_profile_instance<std::size_t>::profile = nullptr;
+
+  std::size_t f_applications = 0;
+  std::size_t g_applications = 0;
+  for (const data_equation& e: data_spec.equations())
+  {
+    const data_expression& lhs = e.lhs();
+    if (is_application(lhs) && atermpp::down_cast<application>(lhs).head() == function_symbol("f", make_function_sort(basic_sort("D"), basic_sort("D"))))
+    {
+      BOOST_CHECK(profile.equation(e).applications == 1);
+      f_applications += profile.equation(e).applications;
+    }
+    else if (is_application(lhs) && atermpp::down_cast<application>(lhs).head() == function_symbol("g", make_function_sort(sort_nat::nat(), sort_nat::nat())))
+    {
+      g_applications += profile.equation(e).applications;
+    }
+  }
+  BOOST_CHECK(f_applications == 3);
+  BOOST_CHECK(g_applications == 1);
+  BOOST_CHECK(profile.symbol(function_symbol("f", make_function_sort(basic_sort("D"), basic_sort("D")))).applications >= 3);
+
+  std::stringstream csv;
+  profile.write_csv(csv);
+  BOOST_CHECK(csv.str().find("kind,name,applications,failures,time_ms\n") == 0);
+  std::remove(filename.c_str());
+  std::remove((filename + ".csv").c_str());
+}
+
+// Arithmetic on constants of sort Pos, Nat and Int is evaluated natively. The
+// results must be the same as those obtained with the equations.
+void native_arithmetic_test()
+{
+  data_specification data_spec;
+  data_spec.add_context_sort(sort_int::int_());
+  data::rewriter R(data_spec, jitty);
+
+  std::vector<std::string> cases =
+  {
+    "18446744073709551615 + 1 == 18446744073709551616",
+    "2 * 9223372036854775807 == 18446744073709551614",
+    "18446744073709551616 - 18446744073709551617 == -1",
+    "(-18446744073709551617) div 2 == -9223372036854775809",
+    "(-18446744073709551617) mod 2 == 1",
+    "18446744073709551617 mod 10 == 7",
+    "max(18446744073709551616, 3) == 18446744073709551616",
+    "18446744073709551616 > 18446744073709551615",
+    "pred(0) == -1",
+    "succ(-1) == 0",
+    "abs(-7) == 7",
+    "-(-7) == 7",
+    "Int2Nat(10) - 12 == -2"
+  };
+  for (long x = -9; x <= 9; ++x)
+  {
+    for (long y = -9; y <= 9; ++y)
+    {
+      const std::string sx = "(" + std::to_string(x) + ")";
+      const std::string sy = "(" + std::to_string(y) + ")";
+      cases.push_back(sx + " + " + sy + " == " + std::to_string(x + y));
+      cases.push_back(sx + " - " + sy + " == " + std::to_string(x - y));
+      cases.push_back(sx + " * " + sy + " == " + std::to_string(x * y));
+      cases.push_back("max(" + sx + ", " + sy + ") == " + std::to_string(std::max(x, y)));
+      cases.push_back("min(" + sx + ", " + sy + ") == " + std::to_string(std::min(x, y)));
+      cases.push_back(std::string(x < y ? "" : "!") + "(" + sx + " < " + sy + ")");
+      cases.push_back(std::string(x <= y ? "" : "!") + "(" + sx + " <= " + sy + ")");
+      cases.push_back(std::string(x != y ? "" : "!") + "(" + sx + " != " + sy + ")");
+      if (y > 0)
+      {
+        const long quotient = (x >= 0 || x % y == 0) ? x / y : x / y - 1;
+        cases.push_back(sx + " div " + sy + " == " + std::to_string(quotient));
+        cases.push_back(sx + " mod " + sy + " == " + std::to_string(x - quotient * y));
+      }
+    }
+  }
+  for (const std::string& c: cases)
+  {
+    const data_expression result = R(parse_data_expression(c, data_spec));
+    BOOST_CHECK(result == sort_bool::true_());
+    if (result != sort_bool::true_())
+    {
+      std::cout << "--- failed test --- " << c << " rewrites to " << result << std::endl;
+    }
+  }
+
+  // Terms that are not constants are rewritten with the equations.
+  const std::vector<variable> n { variable("n", sort_nat::nat()) };
+  BOOST_CHECK(R(parse_data_expression("n + 0", n, data_spec)) == n.front());
+}
+
+// Equations such as 0*n=0 do not need all arguments of an operation that is evaluated
+// natively. These arguments are not rewritten, which matters as rewriting f(0) does not terminate.
+void native_arithmetic_lazy_test()
+{
+  data_specification data_spec = parse_data_specification(
+    "map f: Nat -> Nat;\n"
+    "var n: Nat;\n"
+    "eqn f(n) = f(n + 1);\n"
+  );
+
+  std::vector<rewrite_strategy> strategies { jitty };
+#ifdef MCRL2_JITTYC_AVAILABLE
+  strategies.push_back(jitty_compiling);
+#endif
+  for (rewrite_strategy strategy: strategies)
+  {
+    data::rewriter R(data_spec, strategy);
+    BOOST_CHECK(R(parse_data_expression("0 * f(0)", data_spec)) == parse_data_expression("0", data_spec));
+    BOOST_CHECK(R(parse_data_expression("2 * 3 + 1", data_spec)) == parse_data_expression("7", data_spec));
+  }
+}
+
+// A clone of a rewriter rewrites in the same way, and remains usable after the
+// original rewriter has been destroyed.
+void clone_test()
+{
+  std::string DATA_SPEC1 =
+    "sort D = struct d1 | d2 | d3;\n"
+    "map f: D -> D;\n"
+    "eqn f(d1) = d2;\n"
+    "    f(d2) = d3;\n"
+    "    f(d3) = d1;\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+  const std::vector<variable> x { variable("x", basic_sort("D")) };
+
+  std::vector<rewrite_strategy> strategies { jitty, jitty_prover };
+#ifdef MCRL2_JITTYC_AVAILABLE
+  // A clone of jittyc loads its own copy of the compiled library.
+  strategies.push_back(jitty_compiling);
+#endif
+  for (rewrite_strategy strategy: strategies)
+  {
+    std::unique_ptr<data::rewriter> R(new data::rewriter(data_spec, strategy));
+    data::rewriter clone = R->clone();
+
+    data::rewriter::substitution_type sigma;
+    sigma[x.front()] = parse_data_expression("d2", data_spec);
+    for (const char* s: { "f(f(x))", "f(f(f(x))) == x", "x == d1 || f(x) == d3", "if(f(x) == d1, 2, 3 + 4)" })
+    {
+      const data_expression t = parse_data_expression(s, x, data_spec);
+      BOOST_CHECK((*R)(t, sigma) == clone(t, sigma));
+    }
+
+    R.reset();
+    BOOST_CHECK(clone(parse_data_expression("f(f(x))", x, data_spec), sigma) == parse_data_expression("d1", data_spec));
+    BOOST_CHECK(clone(parse_data_expression("3 + 4", data_spec)) == parse_data_expression("7", data_spec));
+  }
+}
+
+// Rewriting a vector of terms with one substitution gives the same normal forms as
+// rewriting the terms one by one, also for variables and for terms that occur twice.
+void rewrite_vector_test()
+{
+  std::string DATA_SPEC1 =
+    "sort D = struct d1 | d2 | d3;\n"
+    "map f: D -> D;\n"
+    "eqn f(d1) = d2;\n"
+    "    f(d2) = d3;\n"
+    "    f(d3) = d1;\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+  const std::vector<variable> x { variable("x", basic_sort("D")), variable("y", basic_sort("D")) };
+
+  data::rewriter R(data_spec, jitty);
+  data::rewriter::substitution_type sigma;
+  sigma[x[0]] = parse_data_expression("d2", data_spec);
+
+  data_expression_vector terms;
+  for (const char* s: { "x", "f(x)", "y", "f(f(x))", "f(x)", "x == d2", "f(y)", "x" })
+  {
+    terms.push_back(parse_data_expression(s, x, data_spec));
+  }
+  const data_expression_vector result = R(terms, sigma);
+  BOOST_CHECK(result.size() == terms.size());
+  for (std::size_t i = 0; i < terms.size(); ++i)
+  {
+    BOOST_CHECK(result[i] == R(terms[i], sigma));
+  }
+
+  const assignment_list assignments { assignment(x[0], terms[3]), assignment(x[1], terms[1]) };
+  const assignment_list rewritten = R(assignments, sigma);
+  BOOST_CHECK(rewritten == assignment_list({ assignment(x[0], parse_data_expression("d1", data_spec)), assignment(x[1], parse_data_expression("d3", data_spec)) }));
+}
+
+// Quantifiers over finite sorts are eliminated in the same way if the enumeration is
+// done with several threads.
+void parallel_quantifier_test()
+{
+  std::string DATA_SPEC1 =
+    "sort D = struct d1 | d2 | d3 | d4;\n"
+    "map f: D -> D;\n"
+    "eqn f(d1) = d2;\n"
+    "    f(d2) = d3;\n"
+    "    f(d3) = d4;\n"
+    "    f(d4) = d1;\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+  const std::vector<variable> x { variable("x", basic_sort("D")) };
+  const std::vector<const char*> expressions {
+    "exists d, e, g: D, b: Bool. f(d) == e && f(e) == g && g == d1 && b",
+    "exists d, e, g: D, b: Bool. f(f(d)) == e && e == g && !b && g == f(d)",
+    "forall d, e, g: D, b: Bool. f(d) != e || f(e) != g || b || d != d4",
+    "forall d, e, g: D, b: Bool. f(d) == e || e == g || b || d == g || f(g) == d",
+    "exists d, e, g: D. f(d) == x && f(e) == g && d != e",
+    "forall d, e, g: D. f(d) != x || e == g || (forall h: D. h == d || f(h) != e)"
+  };
+
+  for (rewrite_strategy strategy: { jitty, jitty_prover })
+  {
+    data::rewriter R(data_spec, strategy);
+    for (const char* s: expressions)
+    {
+      const data_expression t = parse_data_expression(s, x, data_spec);
+      set_enumerator_thread_count(1);
+      const data_expression expected = R(t);
+      set_enumerator_thread_count(4);
+      const data_expression result = R(t);
+      set_enumerator_thread_count(1);
+
+      // For the open terms the solutions can be combined in another order.
+      for (const char* d: { "d1", "d2", "d3", "d4" })
+      {
+        data::rewriter::substitution_type sigma;
+        sigma[x.front()] = parse_data_expression(d, data_spec);
+        BOOST_CHECK(R(result, sigma) == R(expected, sigma));
+      }
+      if (find_free_variables(t).empty())
+      {
+        BOOST_CHECK(result == expected);
+      }
+    }
+  }
+}
+
+#ifdef MCRL2_JITTYC_AVAILABLE
+// Returns the hashes of the compiled rewriters in the cache directory, with the times at
+// which they were used last.
+static std::map<std::string, time_t> compiled_library_cache_entries(const std::string& directory)
+{
+  std::map<std::string, time_t> result;
+  DIR* dir = opendir(directory.c_str());
+  BOOST_CHECK(dir != NULL);
+  while (dir != NULL)
+  {
+    dirent* e = readdir(dir);
+    if (e == NULL)
+    {
+      closedir(dir);
+      break;
+    }
+    const std::string name(e->d_name);
+    struct stat info;
+    if (name.compare(0, 7, "jittyc_") == 0 && name.size() > 10 && name.compare(name.size() - 3, 3, ".so") == 0 &&
+        stat((directory + "/" + name).c_str(), &info) == 0)
+    {
+      result[name.substr(7, name.size() - 10)] = info.st_mtime;
+    }
+  }
+  return result;
+}
+
+static void set_compiled_library_cache_time(const std::string& directory, const std::string& hash, const time_t time)
+{
+  const struct utimbuf times = { time, time };
+  BOOST_CHECK(utime((directory + "/jittyc_" + hash + ".so").c_str(), &times) == 0);
+}
+
+// With jittyt, terms are rewritten with the jitty rewriter while the compiled rewriter is
+// compiled in the background. The normal forms do not change when the rewriter switches, and a
+// rewriter that is destroyed during the compilation does not wait for it.
+void tiered_rewriter_test()
+{
+  std::string DATA_SPEC1 =
+    "sort D = struct d1 | d2 | d3;\n"
+    "map f: D -> D;\n"
+    "    g: Nat -> Nat;\n"
+    "var n: Nat;\n"
+    "eqn f(d1) = d2;\n"
+    "    f(d2) = d3;\n"
+    "    f(d3) = d1;\n"
+    "    g(0) = 0;\n"
+    "    n > 0 -> g(n) = g(Int2Nat(n - 1)) + n;\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+  const std::vector<variable> x { variable("x", basic_sort("D")) };
+  data::rewriter::substitution_type sigma;
+  sigma[x.front()] = parse_data_expression("d3", data_spec);
+  std::vector<data_expression> terms;
+  for (const char* s: { "f(f(x))", "f(f(f(x))) == x", "x == d1 || f(x) == d3", "g(10)", "if(f(x) == d1, g(3), 4)" })
+  {
+    terms.push_back(parse_data_expression(s, x, data_spec));
+  }
+
+  // The compilation is abandoned, instead of awaited, when the rewriter is destroyed.
+  {
+    std::unique_ptr<data::rewriter> R(new data::rewriter(data_spec, jitty_tiered));
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    R.reset();
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    BOOST_CHECK(duration.count() < 5.0);
+  }
+
+  std::shared_ptr<data::detail::RewriterCompilingJitty> tiered(new data::detail::RewriterCompilingJitty(data_spec, used_data_equation_selector(data_spec), true));
+  data::rewriter R(tiered);
+  std::vector<data_expression> normal_forms;
+  for (const data_expression& t: terms)
+  {
+    normal_forms.push_back(R(t, sigma));
+  }
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  while (!tiered->uses_compiled_rewriter() && std::chrono::steady_clock::now() - start < std::chrono::minutes(10))
+  {
+    for (size_t i = 0; i < terms.size(); ++i)
+    {
+      BOOST_CHECK(R(terms[i], sigma) == normal_forms[i]);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  BOOST_CHECK(tiered->uses_compiled_rewriter());
+  for (size_t i = 0; i < terms.size(); ++i)
+  {
+    BOOST_CHECK(R(terms[i], sigma) == normal_forms[i]);
+  }
+}
+
+// A compiled rewriter is stored in the directory MCRL2_COMPILECACHE, and is used again by a
+// rewriter for the same specification. At most MCRL2_COMPILECACHE_SIZE compiled rewriters are
+// kept, and the one that was used least recently is removed first.
+void compiled_library_cache_test()
+{
+  char directory[] = "/tmp/rewriter_test_cache_XXXXXX";
+  BOOST_CHECK(mkdtemp(directory) != NULL);
+  setenv("MCRL2_COMPILECACHE", directory, 1);
+  setenv("MCRL2_COMPILECACHE_SIZE", "2", 1);
+
+  std::string DATA_SPEC =
+    "sort D = struct d1 | d2 | d3;\n"
+    "map f: D -> D;\n"
+    "eqn f(d1) = d2;\n"
+    "    f(d2) = d3;\n"
+    ;
+  const data_specification data_spec1 = parse_data_specification(DATA_SPEC + "    f(d3) = d1;\n");
+  const data_specification data_spec2 = parse_data_specification(DATA_SPEC + "    f(d3) = d2;\n");
+  const data_specification data_spec3 = parse_data_specification(DATA_SPEC + "    f(d3) = d3;\n");
+  const std::vector<std::string> terms { "f(d1)", "f(f(f(d3)))", "f(d2) == d3", "if(f(d3) == d1, 2, 3 + 4)" };
+
+  std::vector<data_expression> normal_forms;
+  {
+    data::rewriter R(data_spec1, jitty_compiling);
+    for (const std::string& t: terms)
+    {
+      normal_forms.push_back(R(parse_data_expression(t, data_spec1)));
+    }
+  }
+  std::map<std::string, time_t> entries = compiled_library_cache_entries(directory);
+  BOOST_CHECK(entries.size() == 1);
+  const std::string first = entries.empty() ? std::string() : entries.begin()->first;
+
+  // The second rewriter uses the cached library, which marks it as used now.
+  set_compiled_library_cache_time(directory, first, 0);
+  {
+    data::rewriter R(data_spec1, jitty_compiling);
+    for (size_t i = 0; i < terms.size(); ++i)
+    {
+      BOOST_CHECK(R(parse_data_expression(terms[i], data_spec1)) == normal_forms[i]);
+    }
+  }
+  entries = compiled_library_cache_entries(directory);
+  BOOST_CHECK(entries.size() == 1);
+  BOOST_CHECK(entries[first] > 0);
+
+  // A different specification gets an entry of its own.
+  set_compiled_library_cache_time(directory, first, 1);
+  {
+    data::rewriter R(data_spec2, jitty_compiling);
+    BOOST_CHECK(R(parse_data_expression("f(f(d3))", data_spec2)) == parse_data_expression("d3", data_spec2));
+  }
+  entries = compiled_library_cache_entries(directory);
+  BOOST_CHECK(entries.size() == 2);
+  BOOST_CHECK(entries.count(first) == 1);
+
+  // The third entry does not fit, and the first one was used least recently.
+  {
+    data::rewriter R(data_spec3, jitty_compiling);
+    BOOST_CHECK(R(parse_data_expression("f(d3)", data_spec3)) == parse_data_expression("d3", data_spec3));
+  }
+  entries = compiled_library_cache_entries(directory);
+  BOOST_CHECK(entries.size() == 2);
+  BOOST_CHECK(entries.count(first) == 0);
+
+  unsetenv("MCRL2_COMPILECACHE");
+  unsetenv("MCRL2_COMPILECACHE_SIZE");
+  if (DIR* dir = opendir(directory))
+  {
+    while (dirent* e = readdir(dir))
+    {
+      std::remove((std::string(directory) + "/" + e->d_name).c_str());
+    }
+    closedir(dir);
+  }
+  rmdir(directory);
+}
+#endif
+
 int test_main(int argc, char** argv)
 {
   test1();
@@ -204,6 +738,18 @@ int test_main(int argc, char** argv)
   test5();
   one_point_rule_preprocessor_test();
   simplify_rewriter_test();
+  closed_term_cache_test();
+  indexed_strategy_test();
+  rewrite_profile_test();
+  native_arithmetic_test();
+  native_arithmetic_lazy_test();
+  clone_test();
+  rewrite_vector_test();
+  parallel_quantifier_test();
+#ifdef MCRL2_JITTYC_AVAILABLE
+  tiered_rewriter_test();
+  compiled_library_cache_test();
+#endif
 
   return 0;
 }
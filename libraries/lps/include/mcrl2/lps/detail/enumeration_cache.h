@@ -0,0 +1,222 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/detail/enumeration_cache.h
+/// \brief A cache with a bounded size for the solutions of the conditions of summands,
+///        as used by the next state generator.
+
+#ifndef MCRL2_LPS_DETAIL_ENUMERATION_CACHE_H
+#define MCRL2_LPS_DETAIL_ENUMERATION_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/data/data_expression.h"
+
+namespace mcrl2
+{
+namespace lps
+{
+namespace detail
+{
+
+/// \brief Stores for every summand the solutions of the enumeration of its condition, for the
+///        values of the process parameters that occur in the condition.
+/// \details The memory that the cache uses is estimated, and it is kept below a budget. If a new
+///          entry does not fit, entries are evicted with the CLOCK algorithm: the entries form a
+///          circle, and a hand passes over them. An entry that was used since the hand passed it
+///          last time is skipped, and otherwise it is evicted. This approximates evicting the least
+///          recently used entry. The solutions of an entry are shared with the iterators of the
+///          next state generator that use them, such that an entry can be evicted while in use.
+class enumeration_cache
+{
+  public:
+    typedef atermpp::term_appl<data::data_expression> key_type;
+    typedef std::list<data::data_expression_list> solutions_type;
+    typedef std::shared_ptr<const solutions_type> solutions_pointer;
+
+    /// \brief The default budget of 256 MB.
+    static const std::size_t default_budget = 256UL * 1024UL * 1024UL;
+
+    /// \brief The use of the cache by one summand.
+    struct statistics
+    {
+      std::size_t hits = 0;
+      std::size_t misses = 0;
+      std::size_t evictions = 0;
+      std::size_t entries = 0;
+      std::size_t bytes = 0;
+    };
+
+  protected:
+    typedef std::pair<std::size_t, key_type> summand_key;
+
+    struct summand_key_hash
+    {
+      std::size_t operator()(const summand_key& k) const
+      {
+        return std::hash<key_type>()(k.second) * 31 + k.first;
+      }
+    };
+
+    struct entry
+    {
+      std::size_t summand;
+      key_type key;
+      solutions_pointer solutions; // An entry without solutions is free.
+      std::size_t bytes;
+      bool referenced;
+    };
+
+    std::size_t m_budget;
+    std::size_t m_bytes;
+    std::vector<entry> m_entries;
+    std::vector<std::size_t> m_free_entries;
+    std::unordered_map<summand_key, std::size_t, summand_key_hash> m_index;
+    std::size_t m_hand;
+    std::vector<statistics> m_statistics;
+
+    // An estimate of the number of bytes of an entry. Of the terms only the nodes of the lists
+    // of solutions are counted, as the values in the solutions are mostly shared.
+    static std::size_t estimate_bytes(const key_type& key, const solutions_type& solutions)
+    {
+      std::size_t result = sizeof(entry) + sizeof(summand_key) + 4 * sizeof(void*) + (key.size() + 2) * sizeof(void*);
+      for (const data::data_expression_list& l: solutions)
+      {
+        result += sizeof(data::data_expression_list) + 2 * sizeof(void*) + l.size() * 4 * sizeof(void*);
+      }
+      return result;
+    }
+
+    void evict()
+    {
+      while (true)
+      {
+        m_hand = (m_hand + 1) % m_entries.size();
+        entry& e = m_entries[m_hand];
+        if (!e.solutions)
+        {
+          continue;
+        }
+        if (e.referenced)
+        {
+          e.referenced = false;
+          continue;
+        }
+        statistics& s = m_statistics[e.summand];
+        s.evictions++;
+        s.entries--;
+        s.bytes -= e.bytes;
+        m_bytes -= e.bytes;
+        m_index.erase(summand_key(e.summand, e.key));
+        e.key = key_type();
+        e.solutions.reset();
+        m_free_entries.push_back(m_hand);
+        return;
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param summand_count The number of summands.
+    /// \param budget The maximal number of bytes of the entries.
+    enumeration_cache(const std::size_t summand_count = 0, const std::size_t budget = default_budget)
+      : m_budget(budget),
+        m_bytes(0),
+        m_hand(0),
+        m_statistics(summand_count)
+    {}
+
+    /// \brief Returns the solutions of the condition of the summand for the key, or an empty
+    ///        pointer if they are not in the cache.
+    solutions_pointer find(const std::size_t summand, const key_type& key)
+    {
+      auto i = m_index.find(summand_key(summand, key));
+      if (i == m_index.end())
+      {
+        m_statistics[summand].misses++;
+        return solutions_pointer();
+      }
+      m_statistics[summand].hits++;
+      entry& e = m_entries[i->second];
+      e.referenced = true;
+      return e.solutions;
+    }
+
+    /// \brief Adds the solutions of the condition of the summand for the key, if they fit in the budget.
+    void insert(const std::size_t summand, const key_type& key, solutions_type&& solutions)
+    {
+      const std::size_t bytes = estimate_bytes(key, solutions);
+      if (bytes > m_budget || m_index.count(summand_key(summand, key)) > 0)
+      {
+        return;
+      }
+      while (m_bytes + bytes > m_budget)
+      {
+        evict();
+      }
+
+      std::size_t position;
+      if (m_free_entries.empty())
+      {
+        position = m_entries.size();
+        m_entries.push_back(entry());
+      }
+      else
+      {
+        position = m_free_entries.back();
+        m_free_entries.pop_back();
+      }
+      entry& e = m_entries[position];
+      e.summand = summand;
+      e.key = key;
+      e.solutions = std::make_shared<const solutions_type>(std::move(solutions));
+      e.bytes = bytes;
+      e.referenced = false;
+      m_index[summand_key(summand, key)] = position;
+
+      statistics& s = m_statistics[summand];
+      s.entries++;
+      s.bytes += bytes;
+      m_bytes += bytes;
+    }
+
+    /// \brief Returns the use of the cache by the summand.
+    const statistics& summand_statistics(const std::size_t summand) const
+    {
+      return m_statistics[summand];
+    }
+
+    /// \brief Returns the number of summands.
+    std::size_t summand_count() const
+    {
+      return m_statistics.size();
+    }
+
+    /// \brief Returns the estimated number of bytes of the entries.
+    std::size_t bytes() const
+    {
+      return m_bytes;
+    }
+
+    /// \brief Returns the maximal number of bytes of the entries.
+    std::size_t budget() const
+    {
+      return m_budget;
+    }
+};
+
+} // namespace detail
+} // namespace lps
+} // namespace mcrl2
+
+#endif // MCRL2_LPS_DETAIL_ENUMERATION_CACHE_H
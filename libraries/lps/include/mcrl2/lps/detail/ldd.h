@@ -0,0 +1,546 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/detail/ldd.h
+/// \brief List decision diagrams, for the symbolic representation of sets of vectors of numbers.
+
+#ifndef MCRL2_LPS_DETAIL_LDD_H
+#define MCRL2_LPS_DETAIL_LDD_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mcrl2
+{
+namespace lps
+{
+namespace detail
+{
+
+/// \brief A list decision diagram is identified by the index of its root node in an ldd_manager.
+typedef std::size_t ldd;
+
+/// \brief Stores list decision diagrams (LDDs), which represent sets of vectors of numbers
+///        of equal length.
+/// \details An LDD is either false (the empty set), true (the set with the empty vector), or
+///          a node with a value, a down and a right LDD. The node represents the vectors of
+///          down prefixed with the value, together with the vectors of right. The values along
+///          the right links increase. Nodes are shared through a unique table, such that two
+///          LDDs are equal if and only if they represent the same set. The nodes are never
+///          removed, the caches of the operations can be cleared with clear_caches.
+///          See J.C. van de Pol and M. Weber, Symbolic reachability for process algebras with
+///          recursive data types, ICTAC 2008.
+class ldd_manager
+{
+  public:
+    /// \brief The kind of a level of a relation, see relational_product.
+    enum relation_kind
+    {
+      copy,      // The value is not changed, and the relation has no level for it.
+      read,      // The value is read but not changed; the relation has one level with the value.
+      write,     // The value is not read but changed; the relation has one level with the new value.
+      read_write // The value is read and changed; the relation has a level with the old and one with the new value.
+    };
+
+  protected:
+    struct node
+    {
+      std::size_t value;
+      ldd down;
+      ldd right;
+
+      node(std::size_t value_, ldd down_, ldd right_)
+        : value(value_), down(down_), right(right_)
+      {}
+
+      bool operator==(const node& other) const
+      {
+        return value == other.value && down == other.down && right == other.right;
+      }
+    };
+
+    struct node_hash
+    {
+      std::size_t operator()(const node& n) const
+      {
+        std::size_t seed = std::hash<std::size_t>()(n.value);
+        seed ^= std::hash<std::size_t>()(n.down) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= std::hash<std::size_t>()(n.right) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+      }
+    };
+
+    struct pair_hash
+    {
+      std::size_t operator()(const std::pair<ldd, ldd>& p) const
+      {
+        std::size_t seed = std::hash<std::size_t>()(p.first);
+        seed ^= std::hash<std::size_t>()(p.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+      }
+    };
+
+    typedef std::unordered_map<std::pair<ldd, ldd>, ldd, pair_hash> binary_cache;
+    typedef std::vector<std::pair<std::size_t, ldd> > node_list;
+
+    std::vector<node> m_nodes;
+    std::unordered_map<node, ldd, node_hash> m_unique_table;
+    binary_cache m_union_cache;
+    binary_cache m_minus_cache;
+    std::unordered_map<ldd, double> m_count_cache;
+
+    // Returns the LDD with the values and downs of elements, followed by tail.
+    ldd make_list(const node_list& elements, ldd tail = 0)
+    {
+      ldd result = tail;
+      for (auto i = elements.rbegin(); i != elements.rend(); ++i)
+      {
+        result = make_node(i->first, i->second, result);
+      }
+      return result;
+    }
+
+    ldd project(ldd a, const std::vector<bool>& mask, std::size_t level, std::unordered_map<ldd, ldd>& cache)
+    {
+      if (a == false_() || a == true_())
+      {
+        return a;
+      }
+      auto i = cache.find(a);
+      if (i != cache.end())
+      {
+        return i->second;
+      }
+      ldd result = false_();
+      if (mask[level])
+      {
+        node_list elements;
+        for (ldd x = a; x != false_(); x = right(x))
+        {
+          elements.emplace_back(value(x), project(down(x), mask, level + 1, cache));
+        }
+        result = make_list(elements);
+      }
+      else
+      {
+        for (ldd x = a; x != false_(); x = right(x))
+        {
+          result = union_(result, project(down(x), mask, level + 1, cache));
+        }
+      }
+      cache[a] = result;
+      return result;
+    }
+
+    ldd match(ldd a, ldd b, const std::vector<bool>& mask, std::size_t level, binary_cache& cache)
+    {
+      if (a == false_() || b == false_())
+      {
+        return false_();
+      }
+      if (b == true_())
+      {
+        return a;
+      }
+      const std::pair<ldd, ldd> key(a, b);
+      auto i = cache.find(key);
+      if (i != cache.end())
+      {
+        return i->second;
+      }
+      node_list elements;
+      if (mask[level])
+      {
+        ldd y = b;
+        for (ldd x = a; x != false_() && y != false_(); x = right(x))
+        {
+          while (y != false_() && value(y) < value(x))
+          {
+            y = right(y);
+          }
+          if (y != false_() && value(y) == value(x))
+          {
+            const ldd d = match(down(x), down(y), mask, level + 1, cache);
+            if (d != false_())
+            {
+              elements.emplace_back(value(x), d);
+            }
+          }
+        }
+      }
+      else
+      {
+        for (ldd x = a; x != false_(); x = right(x))
+        {
+          const ldd d = match(down(x), b, mask, level + 1, cache);
+          if (d != false_())
+          {
+            elements.emplace_back(value(x), d);
+          }
+        }
+      }
+      const ldd result = make_list(elements);
+      cache[key] = result;
+      return result;
+    }
+
+    ldd relational_product(ldd a, ldd r, const std::vector<relation_kind>& kinds, std::size_t level, binary_cache& cache)
+    {
+      if (a == false_() || r == false_())
+      {
+        return false_();
+      }
+      if (r == true_())
+      {
+        // The remaining values are copied.
+        return a;
+      }
+      const std::pair<ldd, ldd> key(a, r);
+      auto i = cache.find(key);
+      if (i != cache.end())
+      {
+        return i->second;
+      }
+      ldd result = false_();
+      switch (kinds[level])
+      {
+        case copy:
+        {
+          node_list elements;
+          for (ldd x = a; x != false_(); x = right(x))
+          {
+            const ldd d = relational_product(down(x), r, kinds, level + 1, cache);
+            if (d != false_())
+            {
+              elements.emplace_back(value(x), d);
+            }
+          }
+          result = make_list(elements);
+          break;
+        }
+        case read:
+        {
+          node_list elements;
+          ldd y = r;
+          for (ldd x = a; x != false_() && y != false_(); x = right(x))
+          {
+            while (y != false_() && value(y) < value(x))
+            {
+              y = right(y);
+            }
+            if (y != false_() && value(y) == value(x))
+            {
+              const ldd d = relational_product(down(x), down(y), kinds, level + 1, cache);
+              if (d != false_())
+              {
+                elements.emplace_back(value(x), d);
+              }
+            }
+          }
+          result = make_list(elements);
+          break;
+        }
+        case write:
+        {
+          node_list elements;
+          for (ldd y = r; y != false_(); y = right(y))
+          {
+            ldd d = false_();
+            for (ldd x = a; x != false_(); x = right(x))
+            {
+              d = union_(d, relational_product(down(x), down(y), kinds, level + 1, cache));
+            }
+            if (d != false_())
+            {
+              elements.emplace_back(value(y), d);
+            }
+          }
+          result = make_list(elements);
+          break;
+        }
+        case read_write:
+        {
+          ldd y = r;
+          for (ldd x = a; x != false_() && y != false_(); x = right(x))
+          {
+            while (y != false_() && value(y) < value(x))
+            {
+              y = right(y);
+            }
+            if (y != false_() && value(y) == value(x))
+            {
+              node_list elements;
+              for (ldd z = down(y); z != false_(); z = right(z))
+              {
+                const ldd d = relational_product(down(x), down(z), kinds, level + 1, cache);
+                if (d != false_())
+                {
+                  elements.emplace_back(value(z), d);
+                }
+              }
+              result = union_(result, make_list(elements));
+            }
+          }
+          break;
+        }
+      }
+      cache[key] = result;
+      return result;
+    }
+
+    template <typename Function>
+    void enumerate(ldd a, std::vector<std::size_t>& prefix, Function& f, std::size_t& remaining) const
+    {
+      if (a == true_())
+      {
+        f(prefix);
+        --remaining;
+        return;
+      }
+      for (ldd x = a; x != false_() && remaining > 0; x = right(x))
+      {
+        prefix.push_back(value(x));
+        enumerate(down(x), prefix, f, remaining);
+        prefix.pop_back();
+      }
+    }
+
+  public:
+    ldd_manager()
+    {
+      // The nodes for false and true are never accessed.
+      m_nodes.emplace_back(0, 0, 0);
+      m_nodes.emplace_back(0, 0, 0);
+    }
+
+    /// \brief The empty set.
+    static ldd false_()
+    {
+      return 0;
+    }
+
+    /// \brief The set that contains only the empty vector.
+    static ldd true_()
+    {
+      return 1;
+    }
+
+    std::size_t value(ldd a) const
+    {
+      assert(a > 1);
+      return m_nodes[a].value;
+    }
+
+    ldd down(ldd a) const
+    {
+      assert(a > 1);
+      return m_nodes[a].down;
+    }
+
+    ldd right(ldd a) const
+    {
+      assert(a > 1);
+      return m_nodes[a].right;
+    }
+
+    /// \brief Returns the node with the given value, down and right.
+    /// \pre The values of right are larger than value.
+    ldd make_node(std::size_t value, ldd down, ldd right)
+    {
+      assert(right == false_() || value < this->value(right));
+      if (down == false_())
+      {
+        return right;
+      }
+      const node n(value, down, right);
+      auto i = m_unique_table.find(n);
+      if (i != m_unique_table.end())
+      {
+        return i->second;
+      }
+      const ldd result = m_nodes.size();
+      m_nodes.push_back(n);
+      m_unique_table.insert(std::make_pair(n, result));
+      return result;
+    }
+
+    /// \brief Returns the set with only the vector v.
+    ldd singleton(const std::vector<std::size_t>& v)
+    {
+      ldd result = true_();
+      for (auto i = v.rbegin(); i != v.rend(); ++i)
+      {
+        result = make_node(*i, result, false_());
+      }
+      return result;
+    }
+
+    /// \brief Returns the union of a and b.
+    ldd union_(ldd a, ldd b)
+    {
+      if (a == b || b == false_())
+      {
+        return a;
+      }
+      if (a == false_())
+      {
+        return b;
+      }
+      const std::pair<ldd, ldd> key(std::min(a, b), std::max(a, b));
+      auto i = m_union_cache.find(key);
+      if (i != m_union_cache.end())
+      {
+        return i->second;
+      }
+      node_list elements;
+      ldd x = a;
+      ldd y = b;
+      while (x != false_() && y != false_())
+      {
+        if (value(x) < value(y))
+        {
+          elements.emplace_back(value(x), down(x));
+          x = right(x);
+        }
+        else if (value(y) < value(x))
+        {
+          elements.emplace_back(value(y), down(y));
+          y = right(y);
+        }
+        else
+        {
+          elements.emplace_back(value(x), union_(down(x), down(y)));
+          x = right(x);
+          y = right(y);
+        }
+      }
+      const ldd result = make_list(elements, x == false_() ? y : x);
+      m_union_cache[key] = result;
+      return result;
+    }
+
+    /// \brief Returns the vectors of a that are not in b.
+    ldd minus(ldd a, ldd b)
+    {
+      if (a == b || a == false_())
+      {
+        return false_();
+      }
+      if (b == false_())
+      {
+        return a;
+      }
+      const std::pair<ldd, ldd> key(a, b);
+      auto i = m_minus_cache.find(key);
+      if (i != m_minus_cache.end())
+      {
+        return i->second;
+      }
+      node_list elements;
+      ldd y = b;
+      for (ldd x = a; x != false_(); x = right(x))
+      {
+        while (y != false_() && value(y) < value(x))
+        {
+          y = right(y);
+        }
+        const ldd d = (y != false_() && value(y) == value(x)) ? minus(down(x), down(y)) : down(x);
+        if (d != false_())
+        {
+          elements.emplace_back(value(x), d);
+        }
+      }
+      const ldd result = make_list(elements);
+      m_minus_cache[key] = result;
+      return result;
+    }
+
+    /// \brief Returns the vectors of a restricted to the positions i for which mask[i] holds.
+    ldd project(ldd a, const std::vector<bool>& mask)
+    {
+      std::unordered_map<ldd, ldd> cache;
+      return project(a, mask, 0, cache);
+    }
+
+    /// \brief Returns the vectors of a of which the restriction to the positions i for which
+    ///        mask[i] holds is in b.
+    ldd match(ldd a, ldd b, const std::vector<bool>& mask)
+    {
+      binary_cache cache;
+      return match(a, b, mask, 0, cache);
+    }
+
+    /// \brief Returns the vectors that are related to a vector of a by the relation r.
+    /// \details The relation r is a set of vectors, in which kinds determines for every
+    ///          position of the vectors of a how it is represented, see relation_kind. The
+    ///          positions after the last position that is not a copy may be omitted from kinds.
+    ldd relational_product(ldd a, ldd r, const std::vector<relation_kind>& kinds)
+    {
+      binary_cache cache;
+      return relational_product(a, r, kinds, 0, cache);
+    }
+
+    /// \brief Returns the number of vectors in a.
+    double count(ldd a)
+    {
+      if (a == false_() || a == true_())
+      {
+        return a == true_() ? 1 : 0;
+      }
+      auto i = m_count_cache.find(a);
+      if (i != m_count_cache.end())
+      {
+        return i->second;
+      }
+      double result = 0;
+      for (ldd x = a; x != false_(); x = right(x))
+      {
+        result += count(down(x));
+      }
+      m_count_cache[a] = result;
+      return result;
+    }
+
+    /// \brief Applies f to the vectors of a, in lexicographical order.
+    /// \param max_count The maximal number of vectors to which f is applied.
+    template <typename Function>
+    void enumerate(ldd a, Function f, std::size_t max_count = std::numeric_limits<std::size_t>::max()) const
+    {
+      if (a != false_() && max_count > 0)
+      {
+        std::vector<std::size_t> prefix;
+        enumerate(a, prefix, f, max_count);
+      }
+    }
+
+    /// \brief Returns the number of nodes, including false and true.
+    std::size_t node_count() const
+    {
+      return m_nodes.size();
+    }
+
+    /// \brief Clears the caches of the operations.
+    void clear_caches()
+    {
+      m_union_cache.clear();
+      m_minus_cache.clear();
+      m_count_cache.clear();
+    }
+};
+
+} // namespace detail
+} // namespace lps
+} // namespace mcrl2
+
+#endif // MCRL2_LPS_DETAIL_LDD_H
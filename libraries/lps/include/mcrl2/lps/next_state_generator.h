@@ -19,6 +19,7 @@
 
 #include "mcrl2/atermpp/shared_subset.h"
 #include "mcrl2/data/enumerator.h"
+#include "mcrl2/lps/detail/enumeration_cache.h"
 #include "mcrl2/lps/stochastic_specification.h"
 #include "mcrl2/lps/state_probability_pair.h"
 #include "mcrl2/lps/state.h"
@@ -63,7 +64,6 @@ class next_state_generator
       std::vector<size_t> condition_parameters;
       atermpp::function_symbol condition_arguments_function;
       atermpp::aterm_appl condition_arguments_function_dummy;
-      std::map<condition_arguments_t, summand_enumeration_t> enumeration_cache;
     };
 
     struct pruning_tree_node_t
@@ -169,8 +169,9 @@ class next_state_generator
         summand_t *m_summand;
 
         bool m_cached;
-        summand_enumeration_t::iterator m_enumeration_cache_iterator;
-        summand_enumeration_t::iterator m_enumeration_cache_end;
+        detail::enumeration_cache::solutions_pointer m_cached_solutions;
+        summand_enumeration_t::const_iterator m_enumeration_cache_iterator;
+        summand_enumeration_t::const_iterator m_enumeration_cache_end;
         enumerator_iterator_t m_enumeration_iterator;
         bool m_caching;
         condition_arguments_t m_enumeration_cache_key;
@@ -178,6 +179,10 @@ class next_state_generator
 
         enumerator_queue_t* m_enumeration_queue;
 
+        // Buffers for the rewritten arguments of the target state and of the actions.
+        data::data_expression_vector m_target_state_arguments;
+        data::data_expression_vector m_action_arguments;
+
         /// \brief Enumerate <variables, phi> with substitution sigma.
         void enumerate(const data::variable_list& variables, const data::data_expression& phi, data::mutable_indexed_substitution<>& sigma)
         {
@@ -233,6 +238,7 @@ class next_state_generator
     enumerator_t m_enumerator;
 
     bool m_use_enumeration_caching;
+    detail::enumeration_cache m_enumeration_cache;
 
     data::variable_vector m_process_parameters;
     std::vector<summand_t> m_summands;
@@ -246,10 +252,12 @@ class next_state_generator
     /// \param rewriter The rewriter used
     /// \param use_enumeration_caching Cache intermediate enumeration results
     /// \param use_summand_pruning Preprocess summands using pruning strategy.
+    /// \param enumeration_cache_budget The maximal number of bytes of the enumeration cache.
     next_state_generator(const stochastic_specification& spec, 
                          const data::rewriter& rewriter, 
                          bool use_enumeration_caching = false, 
-                         bool use_summand_pruning = false);
+                         bool use_summand_pruning = false,
+                         std::size_t enumeration_cache_budget = detail::enumeration_cache::default_budget);
 
     ~next_state_generator();
 
@@ -290,6 +298,12 @@ class next_state_generator
       return m_rewriter;
     }
 
+    /// \brief Returns the enumeration cache, which is only used if enumeration caching is enabled.
+    const detail::enumeration_cache& get_enumeration_cache() const
+    {
+      return m_enumeration_cache;
+    }
+
     /// \brief Returns a reference to the summand subset containing all summands.
     summand_subset_t& full_subset()
     {
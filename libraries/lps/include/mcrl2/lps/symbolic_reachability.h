@@ -0,0 +1,322 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/symbolic_reachability.h
+/// \brief Symbolic computation of the reachable states of a linear process.
+
+#ifndef MCRL2_LPS_SYMBOLIC_REACHABILITY_H
+#define MCRL2_LPS_SYMBOLIC_REACHABILITY_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/data/find.h"
+#include "mcrl2/data/rewriter.h"
+#include "mcrl2/lps/detail/instantiate_global_variables.h"
+#include "mcrl2/lps/detail/ldd.h"
+#include "mcrl2/lps/find.h"
+#include "mcrl2/lps/next_state_generator.h"
+#include "mcrl2/lps/resolve_name_clashes.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2
+{
+namespace lps
+{
+
+struct symbolic_reachability_options
+{
+  data::rewrite_strategy rewrite_strategy = data::jitty;
+  bool detect_deadlocks = false;
+};
+
+/// \brief Computes the reachable states of a linear process symbolically, with the states
+///        stored in a list decision diagram.
+/// \details The values of the process parameters are numbered in the order in which they
+///          are found, such that a state is a vector of numbers. The transition relation of a
+///          summand is only defined on the parameters that it reads and writes. It is learned on
+///          the fly: for every new projection of the states onto the parameters read by the
+///          summand, its successors are computed with a next state generator. The reachable
+///          states are computed by chaining, i.e. the transition relations of the summands are
+///          applied one after another in every iteration.
+class symbolic_reachability_algorithm
+{
+  public:
+    typedef detail::ldd ldd;
+
+  protected:
+    struct summand_group
+    {
+      std::vector<bool> read_mask;  // For every parameter whether the summand reads it.
+      std::vector<std::size_t> read; // The parameters read by the summand.
+      std::vector<detail::ldd_manager::relation_kind> kinds;
+      ldd learned = detail::ldd_manager::false_(); // The projections for which the relation is known.
+      ldd enabled = detail::ldd_manager::false_(); // The projections in which the summand is enabled.
+      ldd relation = detail::ldd_manager::false_();
+    };
+
+    symbolic_reachability_options m_options;
+    stochastic_specification m_specification;
+    data::rewriter m_rewriter;
+    std::unique_ptr<next_state_generator> m_generator;
+    next_state_generator::enumerator_queue_t m_enumeration_queue;
+
+    std::vector<std::unordered_map<data::data_expression, std::size_t, std::hash<atermpp::aterm> > > m_value_indices;
+    std::vector<data::data_expression_vector> m_values;
+    data::data_expression_vector m_default_values;
+
+    detail::ldd_manager m_ldd;
+    std::vector<summand_group> m_groups;
+    ldd m_states = detail::ldd_manager::false_();
+    ldd m_deadlocks = detail::ldd_manager::false_();
+    std::set<std::string> m_action_labels;
+
+    static std::vector<bool> parameter_mask(const std::set<data::variable>& variables, const data::variable_list& parameters)
+    {
+      std::vector<bool> result;
+      for (const data::variable& v: parameters)
+      {
+        result.push_back(variables.count(v) > 0);
+      }
+      return result;
+    }
+
+    std::size_t value_index(std::size_t i, const data::data_expression& value)
+    {
+      auto j = m_value_indices[i].find(value);
+      if (j != m_value_indices[i].end())
+      {
+        return j->second;
+      }
+      const std::size_t result = m_values[i].size();
+      m_value_indices[i].insert(std::make_pair(value, result));
+      m_values[i].push_back(value);
+      return result;
+    }
+
+    std::vector<std::size_t> state_vector(const state& s)
+    {
+      const std::size_t n = m_default_values.size();
+      std::vector<std::size_t> result;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        result.push_back(value_index(i, s.element_at(i, n)));
+      }
+      return result;
+    }
+
+    // Adds the transition from the projection x to the state target to the relation of group g.
+    void add_transition(summand_group& g, const std::vector<std::size_t>& x, const state& target)
+    {
+      const std::size_t n = m_default_values.size();
+      std::vector<std::size_t> v;
+      std::size_t k = 0;
+      for (std::size_t i = 0; i < g.kinds.size(); ++i)
+      {
+        switch (g.kinds[i])
+        {
+          case detail::ldd_manager::copy: break;
+          case detail::ldd_manager::read: v.push_back(x[k++]); break;
+          case detail::ldd_manager::write: v.push_back(value_index(i, target.element_at(i, n))); break;
+          case detail::ldd_manager::read_write:
+          {
+            v.push_back(x[k++]);
+            v.push_back(value_index(i, target.element_at(i, n)));
+            break;
+          }
+        }
+      }
+      g.relation = m_ldd.union_(g.relation, m_ldd.singleton(v));
+    }
+
+    // Extends the relation of summand i with the projections of the states in todo that are not yet learned.
+    void learn_transitions(std::size_t i, ldd todo)
+    {
+      summand_group& g = m_groups[i];
+      const ldd projections = m_ldd.minus(m_ldd.project(todo, g.read_mask), g.learned);
+      if (projections == detail::ldd_manager::false_())
+      {
+        return;
+      }
+      g.learned = m_ldd.union_(g.learned, projections);
+
+      // The parameters that are not read by the summand get the values of the initial state.
+      data::data_expression_vector values = m_default_values;
+      m_ldd.enumerate(projections, [&](const std::vector<std::size_t>& x)
+        {
+          for (std::size_t k = 0; k < x.size(); ++k)
+          {
+            values[g.read[k]] = m_values[g.read[k]][x[k]];
+          }
+          const state s(values.begin(), values.size());
+          bool enabled = false;
+          m_enumeration_queue.clear();
+          for (next_state_generator::iterator t = m_generator->begin(s, i, &m_enumeration_queue); t != m_generator->end(); ++t)
+          {
+            enabled = true;
+            if (t->action().actions().empty())
+            {
+              m_action_labels.insert("tau");
+            }
+            for (const process::action& a: t->action().actions())
+            {
+              m_action_labels.insert(std::string(a.label().name()));
+            }
+            add_transition(g, x, t->target_state());
+            for (const next_state_generator::state_probability_pair& p: t->other_target_states())
+            {
+              add_transition(g, x, p.state());
+            }
+          }
+          if (enabled)
+          {
+            g.enabled = m_ldd.union_(g.enabled, m_ldd.singleton(x));
+          }
+        });
+    }
+
+  public:
+    symbolic_reachability_algorithm(const stochastic_specification& spec, const symbolic_reachability_options& options)
+      : m_options(options),
+        m_specification(spec),
+        m_rewriter(spec.data(), options.rewrite_strategy)
+    {
+      detail::instantiate_global_variables(m_specification);
+      resolve_summand_variable_name_clashes(m_specification);
+      m_generator = std::unique_ptr<next_state_generator>(new next_state_generator(m_specification, m_rewriter));
+
+      const data::variable_list& parameters = m_specification.process().process_parameters();
+      const std::size_t n = parameters.size();
+      m_value_indices.resize(n);
+      m_values.resize(n);
+
+      for (const stochastic_action_summand& summand: m_specification.process().action_summands())
+      {
+        std::set<data::variable> read_variables;
+        std::set<data::variable> write_variables;
+        data::find_free_variables(summand.condition(), std::inserter(read_variables, read_variables.end()));
+        lps::find_free_variables(summand.multi_action(), std::inserter(read_variables, read_variables.end()));
+        lps::find_free_variables(summand.distribution(), std::inserter(read_variables, read_variables.end()));
+        for (const data::assignment& a: summand.assignments())
+        {
+          if (a.lhs() != a.rhs())
+          {
+            write_variables.insert(a.lhs());
+            data::find_free_variables(a.rhs(), std::inserter(read_variables, read_variables.end()));
+          }
+        }
+        summand_group g;
+        g.read_mask = parameter_mask(read_variables, parameters);
+        const std::vector<bool> write_mask = parameter_mask(write_variables, parameters);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          if (g.read_mask[i])
+          {
+            g.read.push_back(i);
+          }
+          g.kinds.push_back(g.read_mask[i] ? (write_mask[i] ? detail::ldd_manager::read_write : detail::ldd_manager::read)
+                                           : (write_mask[i] ? detail::ldd_manager::write : detail::ldd_manager::copy));
+        }
+        while (!g.kinds.empty() && g.kinds.back() == detail::ldd_manager::copy)
+        {
+          g.kinds.pop_back();
+        }
+        m_groups.push_back(g);
+      }
+
+      const state& initial_state = m_generator->initial_states().front().state();
+      m_default_values = data::data_expression_vector(initial_state.begin(), initial_state.end());
+      for (const next_state_generator::state_probability_pair& p: m_generator->initial_states())
+      {
+        m_states = m_ldd.union_(m_states, m_ldd.singleton(state_vector(p.state())));
+      }
+    }
+
+    /// \brief Computes the reachable states, and if requested the deadlock states.
+    void run()
+    {
+      ldd todo = m_states;
+      std::size_t iteration = 0;
+      while (todo != detail::ldd_manager::false_())
+      {
+        const ldd explored = todo;
+        for (std::size_t i = 0; i < m_groups.size(); ++i)
+        {
+          learn_transitions(i, todo);
+          const ldd next = m_ldd.minus(m_ldd.relational_product(todo, m_groups[i].relation, m_groups[i].kinds), m_states);
+          m_states = m_ldd.union_(m_states, next);
+          todo = m_ldd.union_(todo, next);
+        }
+        todo = m_ldd.minus(todo, explored);
+        m_ldd.clear_caches();
+        mCRL2log(log::verbose) << "iteration " << ++iteration << ": " << m_ldd.count(m_states) << " states, "
+                               << m_ldd.node_count() << " LDD nodes" << std::endl;
+      }
+
+      if (m_options.detect_deadlocks)
+      {
+        ldd enabled = detail::ldd_manager::false_();
+        for (const summand_group& g: m_groups)
+        {
+          enabled = m_ldd.union_(enabled, m_ldd.match(m_states, g.enabled, g.read_mask));
+        }
+        m_deadlocks = m_ldd.minus(m_states, enabled);
+      }
+    }
+
+    /// \brief Returns the number of reachable states.
+    double state_count()
+    {
+      return m_ldd.count(m_states);
+    }
+
+    /// \brief Returns the number of reachable deadlock states.
+    /// \pre The deadlocks are detected, see symbolic_reachability_options.
+    double deadlock_count()
+    {
+      return m_ldd.count(m_deadlocks);
+    }
+
+    /// \brief Returns at most max_count of the reachable deadlock states.
+    std::vector<state> deadlock_states(std::size_t max_count)
+    {
+      std::vector<state> result;
+      m_ldd.enumerate(m_deadlocks, [&](const std::vector<std::size_t>& x)
+        {
+          data::data_expression_vector values;
+          for (std::size_t i = 0; i < x.size(); ++i)
+          {
+            values.push_back(m_values[i][x[i]]);
+          }
+          result.push_back(state(values.begin(), values.size()));
+        }, max_count);
+      return result;
+    }
+
+    /// \brief Returns the labels of the actions that occur on reachable transitions, where tau
+    ///        is used for the empty multi-action.
+    const std::set<std::string>& action_labels() const
+    {
+      return m_action_labels;
+    }
+
+    /// \brief Returns the number of nodes of the list decision diagrams.
+    std::size_t node_count() const
+    {
+      return m_ldd.node_count();
+    }
+};
+
+} // namespace lps
+} // namespace mcrl2
+
+#endif // MCRL2_LPS_SYMBOLIC_REACHABILITY_H
@@ -59,11 +59,13 @@ next_state_generator::next_state_generator(
   const stochastic_specification& spec,
   const data::rewriter& rewriter,
   bool use_enumeration_caching,
-  bool use_summand_pruning)
+  bool use_summand_pruning,
+  std::size_t enumeration_cache_budget)
   : m_specification(spec),
     m_rewriter(rewriter),
     m_enumerator(m_rewriter, m_specification.data(), m_rewriter,(std::numeric_limits<std::size_t>::max)(),true),  // Generate exceptions.
-    m_use_enumeration_caching(use_enumeration_caching)
+    m_use_enumeration_caching(use_enumeration_caching),
+    m_enumeration_cache(m_specification.process().action_summands().size(), enumeration_cache_budget)
 {
   m_process_parameters = data::variable_vector(m_specification.process().process_parameters().begin(), m_specification.process().process_parameters().end());
 
@@ -452,7 +454,8 @@ void next_state_generator::iterator::increment()
   {
     if (m_caching)
     {
-      m_summand->enumeration_cache[m_enumeration_cache_key] = m_enumeration_log;
+      m_generator->m_enumeration_cache.insert(m_summand - m_generator->m_summands.data(), m_enumeration_cache_key, std::move(m_enumeration_log));
+      m_enumeration_log.clear();
     }
 
     if (m_single_summand)
@@ -491,8 +494,9 @@ void next_state_generator::iterator::increment()
                                                       m_summand->condition_parameters.end(),
                                                       apply_m_state);
 
-      std::map<condition_arguments_t, summand_enumeration_t>::iterator position = m_summand->enumeration_cache.find(m_enumeration_cache_key);
-      if (position == m_summand->enumeration_cache.end())
+      // The solutions are shared with the cache, such that they remain valid if the entry is evicted.
+      m_cached_solutions = m_generator->m_enumeration_cache.find(m_summand - m_generator->m_summands.data(), m_enumeration_cache_key);
+      if (!m_cached_solutions)
       {
         m_cached = false;
         m_caching = true;
@@ -502,8 +506,8 @@ void next_state_generator::iterator::increment()
       {
         m_cached = true;
         m_caching = false;
-        m_enumeration_cache_iterator = position->second.begin();
-        m_enumeration_cache_end = position->second.end();
+        m_enumeration_cache_iterator = m_cached_solutions->begin();
+        m_enumeration_cache_end = m_cached_solutions->end();
       }
     }
     else
@@ -572,8 +576,9 @@ void next_state_generator::iterator::increment()
   { 
     // There is no distribution, and therefore only one target state is generated
     const data_expression_vector& state_args=m_summand->result_state;
-    rewriter_class r(m_generator->m_rewriter,*m_substitution);
-    m_transition.set_target_state(lps::state(state_args.begin(),state_args.size(),r));
+    m_target_state_arguments.resize(state_args.size());
+    m_generator->m_rewriter(state_args.data(), state_args.size(), m_target_state_arguments.data(), *m_substitution);
+    m_transition.set_target_state(lps::state(m_target_state_arguments.begin(),m_target_state_arguments.size()));
     m_transition.set_other_target_states(transition_t::state_probability_list());
   }
   else
@@ -598,15 +603,12 @@ void next_state_generator::iterator::increment()
 
   std::vector <process::action> actions;
   actions.resize(m_summand->action_label.size());
-  std::vector < data_expression> arguments;
   for (size_t i = 0; i < m_summand->action_label.size(); i++)
   {
-    arguments.resize(m_summand->action_label[i].arguments.size());
-    for (size_t j = 0; j < m_summand->action_label[i].arguments.size(); j++)
-    {
-      arguments[j] = m_generator->m_rewriter(m_summand->action_label[i].arguments[j], *m_substitution);
-    }
-    actions[i] = process::action(m_summand->action_label[i].label, data_expression_list(arguments.begin(), arguments.end()));
+    const data_expression_vector& action_args = m_summand->action_label[i].arguments;
+    m_action_arguments.resize(action_args.size());
+    m_generator->m_rewriter(action_args.data(), action_args.size(), m_action_arguments.data(), *m_substitution);
+    actions[i] = process::action(m_summand->action_label[i].label, data_expression_list(m_action_arguments.begin(), m_action_arguments.end()));
   }
   if (m_summand->time_tag==data_expression())  // Check whether the time_tag is valid.
   {
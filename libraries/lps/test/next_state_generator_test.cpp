@@ -37,10 +37,11 @@ void test_initial_state_successors(const stochastic_specification& lps_spec)
   }
 }
 
-void test_next_state_generator(const stochastic_specification& lps_spec, size_t expected_states, size_t expected_transitions, size_t expected_transition_labels, bool enumeration_caching, bool summand_pruning, bool per_summand)
+void test_next_state_generator(const stochastic_specification& lps_spec, size_t expected_states, size_t expected_transitions, size_t expected_transition_labels, bool enumeration_caching, bool summand_pruning, bool per_summand,
+                               std::size_t enumeration_cache_budget = enumeration_cache::default_budget)
 {
   data::rewriter rewriter(lps_spec.data());
-  next_state_generator generator(lps_spec, rewriter, enumeration_caching, summand_pruning);
+  next_state_generator generator(lps_spec, rewriter, enumeration_caching, summand_pruning, enumeration_cache_budget);
 
   state initial_state = generator.initial_states().front().state(); // Only the first state of the set of probabilistic states is considered.
 
@@ -95,6 +96,15 @@ void test_next_state_generator(const stochastic_specification& lps_spec, size_t
   BOOST_CHECK(seen.size() == expected_states);
   BOOST_CHECK(transitions == expected_transitions);
   BOOST_CHECK(transition_labels.size() == expected_transition_labels);
+
+  const enumeration_cache& cache = generator.get_enumeration_cache();
+  BOOST_CHECK(cache.bytes() <= enumeration_cache_budget);
+  for (std::size_t i = 0; i < cache.summand_count(); ++i)
+  {
+    const enumeration_cache::statistics& s = cache.summand_statistics(i);
+    BOOST_CHECK(enumeration_caching || s.hits + s.misses == 0);
+    BOOST_CHECK(s.entries <= s.misses);
+  }
 }
 
 BOOST_AUTO_TEST_CASE(single_state_test)
@@ -130,6 +140,47 @@ BOOST_AUTO_TEST_CASE(test_abp)
   {
     test_next_state_generator(spec, 74, 92, 19, i & 1, i & 2, i & 4);
   }
+
+  // A small budget forces the cache to evict entries, which should not change the result.
+  for (size_t i = 0; i < 4; i++)
+  {
+    test_next_state_generator(spec, 74, 92, 19, true, i & 1, i & 2, 1024);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_enumeration_cache)
+{
+  const std::size_t budget = 2048;
+  enumeration_cache cache(2, budget);
+  const atermpp::function_symbol f("condition_arguments", 1);
+  const data_expression_list solution = { sort_nat::nat(1), sort_nat::nat(2) };
+
+  for (std::size_t n = 0; n < 100; ++n)
+  {
+    const enumeration_cache::key_type key(f, sort_nat::nat(n));
+    BOOST_CHECK(!cache.find(0, key));
+    cache.insert(0, key, enumeration_cache::solutions_type(3, solution));
+    BOOST_CHECK(cache.bytes() <= budget);
+
+    // The solutions are shared with the cache.
+    const enumeration_cache::solutions_pointer solutions = cache.find(0, key);
+    BOOST_CHECK(solutions && solutions->size() == 3 && solutions->front() == solution);
+  }
+
+  const enumeration_cache::statistics& s = cache.summand_statistics(0);
+  BOOST_CHECK(s.hits == 100 && s.misses == 100);
+  BOOST_CHECK(s.evictions > 0 && s.entries + s.evictions == 100);
+  BOOST_CHECK(s.bytes == cache.bytes());
+  BOOST_CHECK(cache.summand_statistics(1).hits + cache.summand_statistics(1).misses == 0);
+
+  // The summand is part of the key.
+  const enumeration_cache::key_type key(f, sort_nat::nat(99));
+  BOOST_CHECK(cache.find(0, key));
+  BOOST_CHECK(!cache.find(1, key));
+
+  // An entry that exceeds the budget is not stored.
+  cache.insert(1, key, enumeration_cache::solutions_type(1000, solution));
+  BOOST_CHECK(!cache.find(1, key));
 }
 
 BOOST_AUTO_TEST_CASE(test_non_true_condition)
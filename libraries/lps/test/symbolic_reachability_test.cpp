@@ -25,6 +25,7 @@
 #include "mcrl2/lps/next_state_generator.h"
 #include "mcrl2/lps/io.h"
 #include "mcrl2/lps/linearise.h"
+#include "mcrl2/lps/symbolic_reachability.h"
 
 using namespace mcrl2;
 
@@ -177,6 +178,68 @@ void check_info(mcrl2::lps::stochastic_specification const& model)
 #endif
 }
 
+void test_ldd()
+{
+  using lps::detail::ldd;
+  using lps::detail::ldd_manager;
+
+  ldd_manager m;
+  const ldd a = m.union_(m.singleton({0, 1}), m.singleton({1, 2}));
+  BOOST_CHECK(a == m.union_(m.singleton({1, 2}), m.singleton({0, 1})));
+  BOOST_CHECK(m.count(a) == 2);
+  BOOST_CHECK(m.minus(a, m.singleton({0, 1})) == m.singleton({1, 2}));
+  BOOST_CHECK(m.project(a, {false, true}) == m.union_(m.singleton({1}), m.singleton({2})));
+  BOOST_CHECK(m.match(a, m.singleton({2}), {false, true}) == m.singleton({1, 2}));
+
+  // The relation changes the first value from 0 to 5 and copies the second value.
+  const std::vector<ldd_manager::relation_kind> kinds = { ldd_manager::read_write };
+  BOOST_CHECK(m.relational_product(a, m.singleton({0, 5}), kinds) == m.singleton({5, 1}));
+
+  std::vector<std::vector<std::size_t> > elements;
+  m.enumerate(a, [&](const std::vector<std::size_t>& x) { elements.push_back(x); });
+  BOOST_CHECK(elements.size() == 2 && elements[0] == std::vector<std::size_t>({0, 1}));
+}
+
+// Compares the number of states and deadlocks found by symbolic reachability with those of an
+// explicit exploration.
+void test_reachability(const std::string& text)
+{
+  lps::stochastic_specification spec = lps::linearise(text);
+
+  data::rewriter rewriter(spec.data());
+  lps::next_state_generator generator(spec, rewriter);
+  std::set<lps::state> known;
+  std::stack<lps::state> todo;
+  std::size_t deadlocks = 0;
+  todo.push(generator.initial_states().front().state());
+  known.insert(todo.top());
+  while (!todo.empty())
+  {
+    const lps::state s = todo.top();
+    todo.pop();
+    bool deadlock = true;
+    lps::next_state_generator::enumerator_queue_t queue;
+    for (lps::next_state_generator::iterator i = generator.begin(s, &queue); i != generator.end(); ++i)
+    {
+      deadlock = false;
+      if (known.insert(i->target_state()).second)
+      {
+        todo.push(i->target_state());
+      }
+    }
+    deadlocks += deadlock ? 1 : 0;
+  }
+
+  lps::symbolic_reachability_options options;
+  options.detect_deadlocks = true;
+  lps::symbolic_reachability_algorithm algorithm(spec, options);
+  algorithm.run();
+  std::cout << "states: " << algorithm.state_count() << " deadlocks: " << algorithm.deadlock_count() << std::endl;
+  BOOST_CHECK(algorithm.state_count() == known.size());
+  BOOST_CHECK(algorithm.deadlock_count() == deadlocks);
+  BOOST_CHECK(algorithm.deadlock_states(1).size() == (deadlocks > 0 ? 1 : 0));
+}
+
 int test_main(int argc, char** argv)
 {
   using namespace mcrl2;
@@ -191,6 +254,22 @@ int test_main(int argc, char** argv)
   check_info(linearise(case_summands));
   check_info(linearise(case_last));
 
+  test_ldd();
+  test_reachability(case_influenced_condition);
+  test_reachability(case_influenced_next);
+  test_reachability(case_two_parameters);
+  test_reachability(case_last);
+  test_reachability(
+    "act a, b;\n\n"
+    "proc X(i: Nat, j: Nat) = (i < 3) -> a.X(i + 1, j) + (j < 3) -> b.X(i, j + 1);\n\n"
+    "init X(0, 0);\n");
+
+  lps::symbolic_reachability_options options;
+  lps::symbolic_reachability_algorithm algorithm(linearise(case_summands), options);
+  algorithm.run();
+  BOOST_CHECK(algorithm.state_count() == 1);
+  BOOST_CHECK(algorithm.action_labels() == std::set<std::string>({ "a" }));
+
   lps::stochastic_specification model=linearise(case_no_influenced_parameters);
 
   if (1 < argc)
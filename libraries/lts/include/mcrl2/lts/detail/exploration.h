@@ -22,6 +22,10 @@
 #include "mcrl2/lts/detail/queue.h"
 #include "mcrl2/lts/detail/lts_generation_options.h"
 #include "mcrl2/lts/detail/exploration_strategy.h"
+#include "mcrl2/lts/detail/external_state_store.h"
+#include "mcrl2/lts/detail/parallel_transition_generator.h"
+#include "mcrl2/lts/detail/state_store.h"
+#include "mcrl2/lts/detail/stubborn_set.h"
 
 #include "mcrl2/utilities/workarounds.h"
 
@@ -71,7 +75,7 @@ class lps2lts_algorithm
     next_state_generator::summand_subset_t m_nonprioritized_subset;
     next_state_generator::summand_subset_t m_prioritized_subset;
 
-    atermpp::indexed_set<lps::state> m_state_numbers;
+    detail::state_store m_state_numbers;
     bit_hash_table m_bit_hash_table;
 
     probabilistic_lts_lts_t m_output_lts;
@@ -93,6 +97,23 @@ class lps2lts_algorithm
     next_state_generator::transition_t::state_probability_list m_initial_states;
     size_t m_level;
 
+    // The generators and summand subsets of the threads that compute the transitions of the states, if
+    // more than one thread is used. The generator m_generator is only used by the main thread.
+    std::vector<std::unique_ptr<next_state_generator> > m_worker_generators;
+    std::vector<next_state_generator::summand_subset_t> m_worker_subsets;
+    std::unique_ptr<detail::parallel_transition_generator> m_parallel_generator;
+
+    // The stubborn sets for partial order reduction, and the transitions per summand of the
+    // state that is explored. If m_por_proviso holds, a state with a reduced set of transitions
+    // to a state that has already been seen is fully explored.
+    std::unique_ptr<detail::stubborn_set_reduction> m_stubborn_sets;
+    std::vector<std::vector<next_state_generator::transition_t> > m_summand_transitions;
+    bool m_por_proviso;
+    size_t m_reduced_states;
+
+    // The states and transitions on disk, if the states are stored in external memory.
+    std::unique_ptr<detail::external_state_store> m_external_states;
+
     std::unordered_set<lps::state> non_divergent_states;  // This set is filled with states proven not to be divergent, 
                                                           // when lps2lts_algorithm is requested to search for divergencies.
 
@@ -108,6 +129,7 @@ class lps2lts_algorithm
 
     ~lps2lts_algorithm()
     {
+      m_parallel_generator.reset();
       delete m_generator;
     }
 
@@ -144,19 +166,28 @@ class lps2lts_algorithm
     void check_divergence(const detail::state_index_pair<COUNTER_EXAMPLE_GENERATOR>& state, 
                           COUNTER_EXAMPLE_GENERATOR divergence_loop);
     void save_actions(const lps::state& state, const next_state_generator::transition_t& transition);
-    void save_deadlock(const lps::state& state);
+    void save_deadlock(const lps::state& state, size_t state_number = std::string::npos);
     void save_error(const lps::state& state);
     std::pair<size_t, bool> add_target_state(const lps::state& source_state, const lps::state& target_state);
     bool add_transition(const lps::state& source_state, const next_state_generator::transition_t& transition);
     void get_transitions(const lps::state& state,
                          std::vector<lps2lts_algorithm::next_state_generator::transition_t>& transitions,
-                         next_state_generator::enumerator_queue_t& enumeration_queue
+                         next_state_generator::enumerator_queue_t& enumeration_queue,
+                         const size_t state_number = std::string::npos
     );
+    void get_reduced_transitions(const lps::state& state,
+                                 std::vector<lps2lts_algorithm::next_state_generator::transition_t>& transitions,
+                                 next_state_generator::enumerator_queue_t& enumeration_queue);
+    void initialise_worker_generators(const lps::stochastic_specification& specification,
+                                      const data::rewriter& rewriter,
+                                      const lps::stochastic_action_summand_vector& nonprioritised_summands);
     void generate_lts_breadth_todo_max_is_npos();
     void generate_lts_breadth_todo_max_is_not_npos(const next_state_generator::transition_t::state_probability_list& initial_states);
     void generate_lts_breadth_bithashing(const next_state_generator::transition_t::state_probability_list& initial_states);
+    void generate_lts_breadth_external(const next_state_generator::transition_t::state_probability_list& initial_states);
     void generate_lts_depth(const next_state_generator::transition_t::state_probability_list& initial_states);
     void generate_lts_random(const next_state_generator::transition_t::state_probability_list& initial_states);
+    void report_enumeration_cache();
     void print_target_distribution_in_aut_format(
                const lps::next_state_generator::transition_t::state_probability_list& state_probability_list,
                const size_t last_state_number,
@@ -0,0 +1,527 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/external_state_store.h
+/// \brief The states and transitions of a breadth first exploration by lps2lts,
+///        stored in sorted files on disk.
+
+#ifndef MCRL2_LTS_DETAIL_EXTERNAL_STATE_STORE_H
+#define MCRL2_LTS_DETAIL_EXTERNAL_STATE_STORE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief Writes records that consist of a fixed number of numbers to a binary file.
+class record_writer
+{
+  protected:
+    std::vector<char> m_buffer;
+    std::ofstream m_stream;
+    std::string m_filename;
+    std::size_t m_width;
+
+  public:
+    record_writer(const std::string& filename, const std::size_t width)
+      : m_buffer(1 << 16),
+        m_filename(filename),
+        m_width(width)
+    {
+      m_stream.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+      m_stream.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!m_stream.is_open())
+      {
+        throw mcrl2::runtime_error("cannot open '" + filename + "' for writing.");
+      }
+    }
+
+    void write(const std::size_t* record)
+    {
+      m_stream.write(reinterpret_cast<const char*>(record), m_width*sizeof(std::size_t));
+    }
+
+    void close()
+    {
+      m_stream.close();
+      if (m_stream.fail())
+      {
+        throw mcrl2::runtime_error("could not write '" + m_filename + "'.");
+      }
+    }
+};
+
+/// \brief Reads the records of a file that is written by a record_writer.
+class record_reader
+{
+  protected:
+    std::vector<char> m_buffer;
+    std::ifstream m_stream;
+    std::vector<std::size_t> m_record;
+    std::size_t m_position;
+    bool m_valid;
+
+  public:
+    record_reader(const std::string& filename, const std::size_t width)
+      : m_buffer(1 << 16),
+        m_record(width),
+        m_position(0),
+        m_valid(false)
+    {
+      m_stream.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+      m_stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+      if (!m_stream.is_open())
+      {
+        throw mcrl2::runtime_error("cannot open '" + filename + "' for reading.");
+      }
+      m_valid = static_cast<bool>(m_stream.read(reinterpret_cast<char*>(m_record.data()), m_record.size()*sizeof(std::size_t)));
+    }
+
+    /// \brief Returns true if the reader is at a record, and false at the end of the file.
+    bool valid() const
+    {
+      return m_valid;
+    }
+
+    const std::size_t* record() const
+    {
+      assert(m_valid);
+      return m_record.data();
+    }
+
+    /// \brief The position of the current record in the file, starting at 0.
+    std::size_t position() const
+    {
+      return m_position;
+    }
+
+    void next()
+    {
+      m_valid = static_cast<bool>(m_stream.read(reinterpret_cast<char*>(m_record.data()), m_record.size()*sizeof(std::size_t)));
+      ++m_position;
+    }
+};
+
+/// \brief Merges sorted files of records into one sorted sequence of records.
+/// \details The records are ordered lexicographically on the key_width numbers from position
+///          key_offset. Equal records of different files are all delivered.
+class record_merger
+{
+  protected:
+    std::vector<std::unique_ptr<record_reader> > m_readers;
+    std::vector<std::size_t> m_heap;
+    std::size_t m_key_offset;
+    std::size_t m_key_width;
+
+    // Returns true if the record of reader i comes after the record of reader j, such that
+    // the heap has the reader with the smallest record on top.
+    bool greater(std::size_t i, std::size_t j) const
+    {
+      const std::size_t* x = m_readers[i]->record() + m_key_offset;
+      const std::size_t* y = m_readers[j]->record() + m_key_offset;
+      return std::lexicographical_compare(y, y + m_key_width, x, x + m_key_width);
+    }
+
+  public:
+    record_merger(const std::vector<std::string>& filenames, const std::size_t width, const std::size_t key_offset, const std::size_t key_width)
+      : m_key_offset(key_offset),
+        m_key_width(key_width)
+    {
+      for (const std::string& filename: filenames)
+      {
+        m_readers.emplace_back(new record_reader(filename, width));
+        if (m_readers.back()->valid())
+        {
+          m_heap.push_back(m_readers.size() - 1);
+        }
+      }
+      std::make_heap(m_heap.begin(), m_heap.end(), [&](std::size_t i, std::size_t j) { return greater(i, j); });
+    }
+
+    bool valid() const
+    {
+      return !m_heap.empty();
+    }
+
+    const std::size_t* record() const
+    {
+      return m_readers[m_heap.front()]->record();
+    }
+
+    /// \brief The index of the file of the current record.
+    std::size_t file() const
+    {
+      return m_heap.front();
+    }
+
+    /// \brief The position of the current record in its file.
+    std::size_t position() const
+    {
+      return m_readers[m_heap.front()]->position();
+    }
+
+    void next()
+    {
+      auto greater_ = [&](std::size_t i, std::size_t j) { return greater(i, j); };
+      std::pop_heap(m_heap.begin(), m_heap.end(), greater_);
+      m_readers[m_heap.back()]->next();
+      if (m_readers[m_heap.back()]->valid())
+      {
+        std::push_heap(m_heap.begin(), m_heap.end(), greater_);
+      }
+      else
+      {
+        m_heap.pop_back();
+      }
+    }
+};
+
+/// \brief Stores the states and transitions of a breadth first exploration on disk, such that
+///        only a bounded amount of memory is used.
+/// \details A state is stored as a vector with a number for every process parameter. The values
+///          of the parameters are numbered in memory, as there are normally only few of them.
+///          Every level of the exploration is stored in a sorted file. The states of a level are
+///          numbered in this order, after the states of the previous levels.
+///
+///          The successors of the states of a level are collected in a buffer, which is written to
+///          a sorted file if it is full. When the level is explored, these files are merged, and
+///          the states that occur in a previous level are removed by merging with the files of the
+///          previous levels. This is delayed duplicate detection as described in U. Stern and
+///          D.L. Dill, Using magnetic disk instead of main memory in the Murphi verifier, CAV 1998
+///          and R.E. Korf, Best-first frontier search with delayed duplicate detection, AAAI 2004.
+///          A bit array with the hashes of the visited states filters the states that certainly
+///          did not occur in a previous level, such that the previous levels are only read if
+///          there are candidates that may have been visited.
+///
+///          The transitions are also written to sorted files, ordered on their target state.
+///          As the number of a state is only known when its level is complete, the target
+///          states of the transitions are renumbered when the transitions are written.
+class external_state_store
+{
+  protected:
+    std::string m_prefix;
+    std::size_t m_file_count;
+    std::size_t m_parameter_count;
+    std::size_t m_width;                  // The number of numbers of a state, which is at least one.
+    std::size_t m_state_buffer_size;      // The maximal number of numbers in m_states.
+    std::size_t m_transition_buffer_size; // The maximal number of numbers in m_transitions.
+
+    std::vector<std::unordered_map<data::data_expression, std::size_t, std::hash<atermpp::aterm> > > m_value_numbers;
+    std::vector<data::data_expression_vector> m_values;
+    std::vector<bool> m_filter;
+
+    std::vector<std::size_t> m_states;      // The states of the next level that are not yet written.
+    std::vector<std::string> m_state_files; // The sorted files of states of the next level.
+    std::vector<std::size_t> m_transitions; // Transitions as the source, the label and the target state.
+    std::vector<std::string> m_transition_files;
+    std::size_t m_transition_count;
+    std::vector<std::string> m_labels;
+    std::unordered_map<std::string, std::size_t> m_label_numbers;
+
+    std::vector<std::string> m_levels;
+    std::vector<std::size_t> m_level_offsets; // The number of the first state of every level.
+    std::size_t m_state_count;
+    std::unique_ptr<record_reader> m_current_level;
+    data::data_expression_vector m_state_arguments;
+
+    std::string new_filename()
+    {
+      return m_prefix + std::to_string(m_file_count++) + ".dat";
+    }
+
+    std::size_t hash(const std::size_t* record) const
+    {
+      std::uint64_t result = 0;
+      for (std::size_t i = 0; i < m_width; ++i)
+      {
+        // The finalizer of MurmurHash3.
+        std::uint64_t key = result ^ (record[i] + 0x9e3779b97f4a7c15ULL);
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        result = key;
+      }
+      return static_cast<std::size_t>(result % m_filter.size());
+    }
+
+    bool equal(const std::size_t* x, const std::size_t* y) const
+    {
+      return std::equal(x, x + m_width, y);
+    }
+
+    bool less(const std::size_t* x, const std::size_t* y) const
+    {
+      return std::lexicographical_compare(x, x + m_width, y, y + m_width);
+    }
+
+    void add_state_vector(const lps::state& s, std::vector<std::size_t>& buffer)
+    {
+      if (m_parameter_count == 0)
+      {
+        buffer.push_back(0);
+        return;
+      }
+      std::size_t i = 0;
+      for (const data::data_expression& value: s)
+      {
+        auto j = m_value_numbers[i].find(value);
+        if (j == m_value_numbers[i].end())
+        {
+          j = m_value_numbers[i].insert(std::make_pair(value, m_values[i].size())).first;
+          m_values[i].push_back(value);
+        }
+        buffer.push_back(j->second);
+        ++i;
+      }
+    }
+
+    // Sorts the records of the given width in buffer on their last m_width numbers, writes
+    // them to a new file and clears the buffer. If remove_duplicates holds, equal records
+    // are written once.
+    void write_sorted(std::vector<std::size_t>& buffer, const std::size_t width, const bool remove_duplicates, std::vector<std::string>& files)
+    {
+      if (buffer.empty())
+      {
+        return;
+      }
+      const std::size_t key_offset = width - m_width;
+      std::vector<std::size_t> order(buffer.size() / width);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j)
+                { return less(&buffer[i*width + key_offset], &buffer[j*width + key_offset]); });
+      files.push_back(new_filename());
+      record_writer out(files.back(), width);
+      const std::size_t* last = nullptr;
+      for (std::size_t i: order)
+      {
+        const std::size_t* record = &buffer[i*width];
+        if (!remove_duplicates || last == nullptr || !equal(last, record))
+        {
+          out.write(record);
+        }
+        last = record;
+      }
+      out.close();
+      buffer.clear();
+    }
+
+    // Removes the states of the file candidates that occur in the visited level with the given index.
+    // Only the states of which the hash is in the filter are looked up.
+    std::string remove_visited(const std::string& candidates, const std::size_t level)
+    {
+      const std::string result = new_filename();
+      {
+        record_reader in(candidates, m_width);
+        record_reader visited(m_levels[level], m_width);
+        record_writer out(result, m_width);
+        for (; in.valid(); in.next())
+        {
+          if (m_filter[hash(in.record())])
+          {
+            while (visited.valid() && less(visited.record(), in.record()))
+            {
+              visited.next();
+            }
+            if (visited.valid() && equal(visited.record(), in.record()))
+            {
+              continue;
+            }
+          }
+          out.write(in.record());
+        }
+        out.close();
+      }
+      std::remove(candidates.c_str());
+      return result;
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param directory The directory in which the files are stored.
+    /// \param parameter_count The number of process parameters.
+    /// \param memory_budget The number of bytes of memory for the buffers and the filter. One
+    ///        eighth is used for the filter, and the rest for the buffers of states and transitions.
+    external_state_store(const std::string& directory, const std::size_t parameter_count, const std::size_t memory_budget)
+      : m_prefix(directory + "/lps2lts_" + std::to_string(std::time(nullptr)) + "_" +
+                 std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "_"),
+        m_file_count(0),
+        m_parameter_count(parameter_count),
+        m_width(std::max<std::size_t>(parameter_count, 1)),
+        m_state_buffer_size(std::max<std::size_t>(3 * memory_budget / 8 / sizeof(std::size_t), m_width)),
+        m_transition_buffer_size(std::max<std::size_t>(memory_budget / 2 / sizeof(std::size_t), m_width + 2)),
+        m_value_numbers(parameter_count),
+        m_values(parameter_count),
+        m_filter(std::max<std::size_t>(memory_budget, 64)),
+        m_transition_count(0),
+        m_state_count(0),
+        m_state_arguments(parameter_count)
+    {}
+
+    ~external_state_store()
+    {
+      m_current_level.reset();
+      for (const std::vector<std::string>* files: { &m_state_files, &m_transition_files, &m_levels })
+      {
+        for (const std::string& filename: *files)
+        {
+          std::remove(filename.c_str());
+        }
+      }
+    }
+
+    /// \brief Adds a state to the next level, unless it is visited before.
+    void add_state(const lps::state& s)
+    {
+      add_state_vector(s, m_states);
+      if (m_states.size() >= m_state_buffer_size)
+      {
+        write_sorted(m_states, m_width, true, m_state_files);
+      }
+    }
+
+    /// \brief Adds a transition, and adds its target to the next level unless it is visited before.
+    void add_transition(const std::size_t source, const std::string& label, const lps::state& target)
+    {
+      auto i = m_label_numbers.find(label);
+      if (i == m_label_numbers.end())
+      {
+        i = m_label_numbers.insert(std::make_pair(label, m_labels.size())).first;
+        m_labels.push_back(label);
+      }
+      m_transitions.push_back(source);
+      m_transitions.push_back(i->second);
+      add_state_vector(target, m_transitions);
+      add_state(target);
+      ++m_transition_count;
+      if (m_transitions.size() >= m_transition_buffer_size)
+      {
+        write_sorted(m_transitions, m_width + 2, false, m_transition_files);
+      }
+    }
+
+    /// \brief Completes the next level, of which the states become available with next_state.
+    /// \return The number of states of the new level.
+    std::size_t next_level()
+    {
+      write_sorted(m_states, m_width, true, m_state_files);
+
+      std::string candidates = new_filename();
+      bool maybe_visited = false;
+      {
+        record_merger merger(m_state_files, m_width, 0, m_width);
+        record_writer out(candidates, m_width);
+        std::vector<std::size_t> last;
+        for (; merger.valid(); merger.next())
+        {
+          if (last.empty() || !equal(last.data(), merger.record()))
+          {
+            out.write(merger.record());
+            last.assign(merger.record(), merger.record() + m_width);
+            maybe_visited = maybe_visited || m_filter[hash(merger.record())];
+          }
+        }
+        out.close();
+      }
+      for (const std::string& filename: m_state_files)
+      {
+        std::remove(filename.c_str());
+      }
+      m_state_files.clear();
+
+      for (std::size_t level = 0; maybe_visited && level < m_levels.size(); ++level)
+      {
+        candidates = remove_visited(candidates, level);
+      }
+
+      std::size_t size = 0;
+      for (record_reader in(candidates, m_width); in.valid(); in.next())
+      {
+        m_filter[hash(in.record())] = true;
+        ++size;
+      }
+      m_levels.push_back(candidates);
+      m_level_offsets.push_back(m_state_count);
+      m_state_count += size;
+      m_current_level.reset(new record_reader(candidates, m_width));
+      return size;
+    }
+
+    /// \brief Reads the next state of the last completed level.
+    /// \return The number of the state.
+    std::size_t next_state(lps::state& s)
+    {
+      assert(m_current_level && m_current_level->valid());
+      const std::size_t* record = m_current_level->record();
+      for (std::size_t i = 0; i < m_parameter_count; ++i)
+      {
+        m_state_arguments[i] = m_values[i][record[i]];
+      }
+      s = lps::state(m_state_arguments.begin(), m_parameter_count);
+      const std::size_t result = m_level_offsets.back() + m_current_level->position();
+      m_current_level->next();
+      return result;
+    }
+
+    /// \brief The number of states in the completed levels.
+    std::size_t state_count() const
+    {
+      return m_state_count;
+    }
+
+    /// \brief The number of transitions.
+    std::size_t transition_count() const
+    {
+      return m_transition_count;
+    }
+
+    /// \brief Writes the transitions in the AUT format, with the numbers of the target states.
+    /// \pre The targets of all transitions are in a completed level.
+    void write_aut(std::ostream& out, const std::size_t initial_state)
+    {
+      write_sorted(m_transitions, m_width + 2, false, m_transition_files);
+      m_current_level.reset();
+
+      out << "des (" << initial_state << "," << m_transition_count << "," << m_state_count << ")\n";
+      record_merger states(m_levels, m_width, 0, m_width);
+      for (record_merger transitions(m_transition_files, m_width + 2, 2, m_width); transitions.valid(); transitions.next())
+      {
+        const std::size_t* t = transitions.record();
+        while (less(states.record(), t + 2))
+        {
+          states.next();
+        }
+        assert(equal(states.record(), t + 2));
+        out << "(" << t[0] << ",\"" << m_labels[t[1]] << "\"," << m_level_offsets[states.file()] + states.position() << ")\n";
+      }
+    }
+};
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_EXTERNAL_STATE_STORE_H
@@ -13,6 +13,7 @@
 #define MCRL2_LTS_DETAIL_LTS_GENERATION_OPTIONS_H
 
 #include "mcrl2/data/rewrite_strategy.h"
+#include "mcrl2/lps/detail/enumeration_cache.h"
 #include "mcrl2/lts/lts_io.h"
 #include "mcrl2/lts/detail/exploration_strategy.h"
 #include "mcrl2/process/action_parse.h"
@@ -29,6 +30,7 @@ class lts_generation_options
     static const size_t default_max_states=ULONG_MAX;
     static const size_t default_bithashsize=209715200ULL; // ~25 MB
     static const size_t default_init_tsize=10000UL;
+    static const size_t default_external_memory_budget=1024UL*1024UL*1024UL; // 1 GB
 
   public:
     static const size_t default_max_traces=ULONG_MAX;
@@ -47,6 +49,7 @@ class lts_generation_options
 
     bool bithashing;
     size_t bithashsize;
+    bool use_tree_compression;
 
     mcrl2::lts::lts_type outformat;
     bool outinfo;
@@ -64,7 +67,12 @@ class lts_generation_options
     std::set < mcrl2::lps::multi_action > trace_multiactions;
 
     bool use_enumeration_caching;
+    size_t enumeration_cache_budget;
     bool use_summand_pruning;
+    bool use_partial_order_reduction;
+    size_t threads;
+    std::string external_memory_directory;
+    size_t external_memory_budget;
     std::set< mcrl2::core::identifier_string > actions_internal_for_divergencies;
 
     /// \brief Constructor
@@ -79,6 +87,7 @@ class lts_generation_options
       suppress_progress_messages(false),
       bithashing(false),
       bithashsize(default_bithashsize),
+      use_tree_compression(false),
       outformat(mcrl2::lts::lts_none),
       outinfo(true),
       trace(false),
@@ -88,7 +97,11 @@ class lts_generation_options
       detect_divergence(false),
       detect_action(false),
       use_enumeration_caching(false),
-      use_summand_pruning(false)
+      enumeration_cache_budget(mcrl2::lps::detail::enumeration_cache::default_budget),
+      use_summand_pruning(false),
+      use_partial_order_reduction(false),
+      threads(1),
+      external_memory_budget(default_external_memory_budget)
     {}
 
     /// \brief Copy assignment operator.
@@ -0,0 +1,211 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/parallel_transition_generator.h
+/// \brief Computes the outgoing transitions of the states of a breadth first
+///        exploration with several threads.
+
+#ifndef MCRL2_LTS_DETAIL_PARALLEL_TRANSITION_GENERATOR_H
+#define MCRL2_LTS_DETAIL_PARALLEL_TRANSITION_GENERATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "mcrl2/lps/next_state_generator.h"
+#include "mcrl2/lts/detail/state_store.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief Computes the outgoing transitions of the states in a state store with several
+///        threads, ahead of the single thread that adds the transitions to the state space.
+/// \details The states must be requested in the order of their numbers, as in a breadth
+///          first exploration. The states that are in the store, but whose transitions have
+///          not been requested, are explored in batches. The threads take the next state of
+///          the batch when they are done with a state, such that a thread that gets
+///          expensive states does not hold up the others. As the transitions of a state are
+///          handed out in the order of the state numbers, the numbering of the states and
+///          the order of the transitions is the same as in a sequential exploration.
+///          Every thread uses its own next state generator, with its own rewriter.
+class parallel_transition_generator
+{
+  public:
+    typedef lps::next_state_generator next_state_generator;
+    typedef next_state_generator::transition_t transition_t;
+
+  protected:
+    // The outgoing transitions of one state, or the error that occurred when computing them.
+    struct exploration_result
+    {
+      std::vector<transition_t> transitions;
+      std::exception_ptr error;
+      bool ready;
+
+      exploration_result()
+        : ready(false)
+      {}
+    };
+
+    std::vector<next_state_generator*> m_generators;
+    std::vector<next_state_generator::summand_subset_t*> m_subsets;
+    state_store& m_states;
+    std::size_t m_max_states;
+    std::size_t m_batch_size;
+
+    // The states of the current batch, and the number of the first of them.
+    std::vector<lps::state> m_batch;
+    std::size_t m_batch_begin;
+    std::unique_ptr<exploration_result[]> m_results;
+
+    // The position in the batch of the next state that is requested.
+    std::size_t m_position;
+
+    std::atomic<std::size_t> m_next_to_explore;
+    std::atomic<bool> m_stop;
+    std::mutex m_mutex;
+    std::condition_variable m_result_ready;
+    std::vector<std::thread> m_threads;
+
+    void explore(const std::size_t k)
+    {
+      next_state_generator& generator = *m_generators[k];
+      next_state_generator::enumerator_queue_t enumeration_queue;
+      for (std::size_t i = m_next_to_explore++; i < m_batch.size() && !m_stop; i = m_next_to_explore++)
+      {
+        exploration_result& result = m_results[i];
+        try
+        {
+          enumeration_queue.clear();
+          next_state_generator::iterator it(generator.begin(m_batch[i], *m_subsets[k], &enumeration_queue));
+          while (it)
+          {
+            result.transitions.push_back(*it++);
+          }
+        }
+        catch (...)
+        {
+          result.error = std::current_exception();
+        }
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          result.ready = true;
+        }
+        m_result_ready.notify_all();
+      }
+    }
+
+    void stop_batch()
+    {
+      m_stop = true;
+      for (std::thread& t: m_threads)
+      {
+        t.join();
+      }
+      m_threads.clear();
+    }
+
+    // Starts the exploration of the states in the store from state number first.
+    void start_batch(const std::size_t first)
+    {
+      stop_batch();
+      const std::size_t last = std::min(std::min(m_states.size(), m_max_states), first + m_batch_size);
+      assert(first < last);
+      m_batch.clear();
+      for (std::size_t i = first; i < last; ++i)
+      {
+        m_batch.push_back(m_states.get(i));
+      }
+      m_batch_begin = first;
+      m_results.reset(new exploration_result[m_batch.size()]);
+      m_position = 0;
+      m_next_to_explore = 0;
+      m_stop = false;
+      for (std::size_t k = 0; k < m_generators.size(); ++k)
+      {
+        m_threads.emplace_back(&parallel_transition_generator::explore, this, k);
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param generators The next state generators, one for every thread.
+    /// \param subsets For every generator the subset of its summands that is used.
+    /// \param states The states that are explored.
+    /// \param max_states No states with a number of at least max_states are explored.
+    /// \param batch_size_per_thread The number of states that is explored per thread
+    ///        before new states are taken from the store.
+    parallel_transition_generator(const std::vector<next_state_generator*>& generators,
+                                  const std::vector<next_state_generator::summand_subset_t*>& subsets,
+                                  state_store& states,
+                                  const std::size_t max_states,
+                                  const std::size_t batch_size_per_thread = 1024)
+      : m_generators(generators),
+        m_subsets(subsets),
+        m_states(states),
+        m_max_states(max_states),
+        m_batch_size(batch_size_per_thread * generators.size()),
+        m_batch_begin(0),
+        m_position(0),
+        m_next_to_explore(0),
+        m_stop(false)
+    {
+      assert(!generators.empty() && generators.size() == subsets.size());
+    }
+
+    ~parallel_transition_generator()
+    {
+      stop_batch();
+    }
+
+    /// \brief Returns the number of threads.
+    std::size_t thread_count() const
+    {
+      return m_generators.size();
+    }
+
+    /// \brief Stores the outgoing transitions of the state with the given number in transitions.
+    /// \details If an exception occurred while computing them, it is thrown.
+    void get_transitions(const std::size_t state_number, std::vector<transition_t>& transitions)
+    {
+      if (state_number < m_batch_begin || state_number >= m_batch_begin + m_batch.size())
+      {
+        start_batch(state_number);
+      }
+      assert(state_number == m_batch_begin + m_position);
+
+      exploration_result& result = m_results[m_position++];
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_result_ready.wait(lock, [&result]() { return result.ready; });
+      }
+      if (result.error)
+      {
+        stop_batch();
+        std::rethrow_exception(result.error);
+      }
+      assert(transitions.empty());
+      transitions.swap(result.transitions);
+    }
+};
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_PARALLEL_TRANSITION_GENERATOR_H
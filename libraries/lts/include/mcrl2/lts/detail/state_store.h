@@ -0,0 +1,388 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/state_store.h
+/// \brief The set of states that is visited by lps2lts, in which states
+///        are numbered, and optionally stored using tree compression.
+
+#ifndef MCRL2_LTS_DETAIL_STATE_STORE_H
+#define MCRL2_LTS_DETAIL_STATE_STORE_H
+
+#include <cstdint>
+#include <vector>
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief A set of pairs of 32 bit numbers, in which the pairs are numbered 0, 1, 2, ...
+///        in the order in which they are inserted.
+/// \details A pair occupies 8 bytes, plus a 4 byte entry in a hashtable that is at least
+///          25% and at most 75% filled.
+class index_pair_table
+{
+  protected:
+    static const std::uint32_t EMPTY = static_cast<std::uint32_t>(-1);
+
+    std::vector<std::uint64_t> m_pairs;
+    std::vector<std::uint32_t> m_hashtable;
+
+    static std::uint64_t combine(const std::size_t left, const std::size_t right)
+    {
+      return (static_cast<std::uint64_t>(left)<<32) | right;
+    }
+
+    // The finalizer of MurmurHash3, which spreads consecutive numbers over the hashtable.
+    static std::size_t hash(std::uint64_t key)
+    {
+      key ^= key >> 33;
+      key *= 0xff51afd7ed558ccdULL;
+      key ^= key >> 33;
+      key *= 0xc4ceb9fe1a85ec53ULL;
+      key ^= key >> 33;
+      return static_cast<std::size_t>(key);
+    }
+
+    // Returns the position in the hashtable that contains key, or the empty position where it must be inserted.
+    std::size_t find_position(const std::uint64_t key) const
+    {
+      const std::size_t mask=m_hashtable.size()-1;
+      std::size_t c=hash(key) & mask;
+      while (m_hashtable[c]!=EMPTY && m_pairs[m_hashtable[c]]!=key)
+      {
+        c=(c+1) & mask;
+      }
+      return c;
+    }
+
+    void resize()
+    {
+      m_hashtable.assign(2*m_hashtable.size(), std::uint32_t(EMPTY));
+      for (std::size_t i=0; i<m_pairs.size(); ++i)
+      {
+        m_hashtable[find_position(m_pairs[i])]=static_cast<std::uint32_t>(i);
+      }
+    }
+
+  public:
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    index_pair_table()
+      : m_hashtable(1024, std::uint32_t(EMPTY))
+    {}
+
+    std::size_t size() const
+    {
+      return m_pairs.size();
+    }
+
+    /// \brief Puts the pair (left, right) in the table.
+    /// \return The number of the pair, and a boolean that is true if the pair is new.
+    /// \exception mcrl2::runtime_error if the table contains 2^32-1 pairs, or left or right does not fit in 32 bits.
+    std::pair<std::size_t, bool> put(const std::size_t left, const std::size_t right)
+    {
+      const std::uint64_t key=combine(left, right);
+      const std::size_t c=find_position(key);
+      if (m_hashtable[c]!=EMPTY)
+      {
+        return std::make_pair(m_hashtable[c], false);
+      }
+      if (m_pairs.size()>=EMPTY || left>=EMPTY || right>=EMPTY)
+      {
+        throw mcrl2::runtime_error("Tree compression cannot store more than " + std::to_string(EMPTY) + " different vectors at one position.");
+      }
+      const std::size_t n=m_pairs.size();
+      m_pairs.push_back(key);
+      m_hashtable[c]=static_cast<std::uint32_t>(n);
+      if (4*m_pairs.size()>3*m_hashtable.size())
+      {
+        resize();
+      }
+      return std::make_pair(n, true);
+    }
+
+    /// \brief Returns the number of the pair (left, right), or npos if it is not in the table.
+    std::size_t index(const std::size_t left, const std::size_t right) const
+    {
+      const std::size_t c=find_position(combine(left, right));
+      return m_hashtable[c]==EMPTY?npos:m_hashtable[c];
+    }
+
+    std::size_t left(const std::size_t n) const
+    {
+      return static_cast<std::size_t>(m_pairs[n]>>32);
+    }
+
+    std::size_t right(const std::size_t n) const
+    {
+      return static_cast<std::size_t>(m_pairs[n] & 0xffffffffULL);
+    }
+
+    /// \brief The number of bytes occupied by the table.
+    std::size_t memory_in_bytes() const
+    {
+      return m_pairs.capacity()*sizeof(std::uint64_t)+m_hashtable.capacity()*sizeof(std::uint32_t);
+    }
+};
+
+/// \brief A set of state vectors of equal length, stored using tree compression.
+/// \details The vector is split recursively in two halves, which yields a binary tree of which
+///          the leaves are the parameters. The values of a parameter are numbered using an indexed
+///          set, and each inner node has an index_pair_table, in which the pairs of numbers of the
+///          two halves are numbered. The number of a state is its number at the root.
+///          As the subvectors of the states are shared, a new state typically only needs a new
+///          pair at the root, and a few pairs near the root, i.e., a few times 12 bytes.
+///          This technique is described in: S.C.C. Blom, B. Lisser, J.C. van de Pol and
+///          M. Weber. A database approach to distributed state-space generation. Journal
+///          of Logic and Computation 21(1):45-62, 2011.
+class tree_compressed_state_store
+{
+  protected:
+    std::size_t m_state_size;                 // The length of the vectors, or npos if no vector has been stored yet.
+    std::vector<atermpp::indexed_set<atermpp::aterm> > m_values; // The values of each parameter.
+    std::vector<index_pair_table> m_tables;   // The tables of the inner nodes, in preorder.
+    std::size_t m_number_of_states;           // Only used for vectors of length 0.
+    std::vector<data::data_expression> m_vector;
+
+    void initialise(const std::size_t state_size)
+    {
+      m_state_size=state_size;
+      m_values.resize(state_size);
+      m_tables.resize(state_size==0?0:state_size-1);
+    }
+
+    void set_vector(const lps::state& s)
+    {
+      m_vector.assign(s.begin(), s.end());
+      if (m_state_size==npos)
+      {
+        initialise(m_vector.size());
+      }
+      else if (m_vector.size()!=m_state_size)
+      {
+        throw mcrl2::runtime_error("Tree compression requires all states to have the same number of parameters.");
+      }
+    }
+
+    // Puts the subvector [first, last) of m_vector in the tree, of which the inner node
+    // with the lowest number is node. The boolean new_at_top indicates whether the
+    // subvector was new, and node is set to the lowest number of the next subtree.
+    std::size_t put(const std::size_t first, const std::size_t last, std::size_t& node, bool& new_at_top)
+    {
+      if (last-first==1)
+      {
+        const std::pair<std::size_t, bool> p=m_values[first].put(m_vector[first]);
+        new_at_top=p.second;
+        return p.first;
+      }
+      const std::size_t this_node=node++;
+      const std::size_t middle=(first+last)/2;
+      bool is_new;
+      const std::size_t left=put(first, middle, node, is_new);
+      const std::size_t right=put(middle, last, node, is_new);
+      const std::pair<std::size_t, bool> p=m_tables[this_node].put(left, right);
+      new_at_top=p.second;
+      return p.first;
+    }
+
+    std::size_t index(const std::size_t first, const std::size_t last, std::size_t& node) const
+    {
+      if (last-first==1)
+      {
+        const ssize_t n=m_values[first].index(m_vector[first]);
+        return n<0?npos:static_cast<std::size_t>(n);
+      }
+      const std::size_t this_node=node++;
+      const std::size_t middle=(first+last)/2;
+      const std::size_t left=index(first, middle, node);
+      if (left==npos)
+      {
+        return npos;
+      }
+      const std::size_t right=index(middle, last, node);
+      if (right==npos)
+      {
+        return npos;
+      }
+      return m_tables[this_node].index(left, right);
+    }
+
+    void get(const std::size_t n, const std::size_t first, const std::size_t last, std::size_t& node, std::vector<data::data_expression>& result) const
+    {
+      if (last-first==1)
+      {
+        result[first]=atermpp::down_cast<data::data_expression>(m_values[first].get(n));
+        return;
+      }
+      const std::size_t this_node=node++;
+      const std::size_t middle=(first+last)/2;
+      get(m_tables[this_node].left(n), first, middle, node, result);
+      get(m_tables[this_node].right(n), middle, last, node, result);
+    }
+
+  public:
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    tree_compressed_state_store()
+      : m_state_size(npos),
+        m_number_of_states(0)
+    {}
+
+    /// \brief Puts the state s in the store.
+    /// \return The number of s, and a boolean that is true if s was not yet in the store.
+    std::pair<std::size_t, bool> put(const lps::state& s)
+    {
+      set_vector(s);
+      if (m_state_size==0)
+      {
+        const bool is_new=(m_number_of_states==0);
+        m_number_of_states=1;
+        return std::make_pair(0, is_new);
+      }
+      std::size_t node=0;
+      bool is_new;
+      const std::size_t n=put(0, m_state_size, node, is_new);
+      return std::make_pair(n, is_new);
+    }
+
+    /// \brief Returns the number of s, or npos if s is not in the store.
+    std::size_t index(const lps::state& s)
+    {
+      if (m_state_size==npos)
+      {
+        return npos;
+      }
+      set_vector(s);
+      if (m_state_size==0)
+      {
+        return m_number_of_states==0?npos:0;
+      }
+      std::size_t node=0;
+      return index(0, m_state_size, node);
+    }
+
+    /// \brief Returns the state with number n, which must be in the store.
+    lps::state get(const std::size_t n)
+    {
+      assert(n<size());
+      m_vector.resize(m_state_size);
+      std::size_t node=0;
+      if (m_state_size>0)
+      {
+        get(n, 0, m_state_size, node, m_vector);
+      }
+      return lps::state(m_vector.begin(), m_state_size);
+    }
+
+    /// \brief The number of states in the store.
+    std::size_t size() const
+    {
+      if (m_state_size==npos)
+      {
+        return 0;
+      }
+      if (m_state_size==0)
+      {
+        return m_number_of_states;
+      }
+      if (m_state_size==1)
+      {
+        return m_values[0].size();
+      }
+      return m_tables[0].size();
+    }
+
+    /// \brief The number of bytes used by the tables of the inner nodes.
+    /// \details The indexed sets of the values of the parameters are not included.
+    std::size_t memory_in_bytes() const
+    {
+      std::size_t result=0;
+      for (const index_pair_table& t: m_tables)
+      {
+        result=result+t.memory_in_bytes();
+      }
+      return result;
+    }
+};
+
+/// \brief The numbered set of states of lps2lts, which stores states either as terms
+///        in an indexed set, or using tree compression.
+class state_store
+{
+  protected:
+    bool m_use_tree_compression;
+    atermpp::indexed_set<lps::state> m_indexed_set;
+    tree_compressed_state_store m_tree_store;
+
+  public:
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// \brief Constructor.
+    /// \param initial_size The initial size of the indexed set. Not used with tree compression.
+    /// \param use_tree_compression If true, tree compression is used.
+    state_store(const std::size_t initial_size = 100, const bool use_tree_compression = false)
+      : m_use_tree_compression(use_tree_compression),
+        m_indexed_set(use_tree_compression?100:initial_size, 50)
+    {}
+
+    bool uses_tree_compression() const
+    {
+      return m_use_tree_compression;
+    }
+
+    std::pair<std::size_t, bool> put(const lps::state& s)
+    {
+      return m_use_tree_compression?m_tree_store.put(s):m_indexed_set.put(s);
+    }
+
+    /// \brief Returns the number of s, or npos if s is not in the store.
+    std::size_t index(const lps::state& s)
+    {
+      if (m_use_tree_compression)
+      {
+        return m_tree_store.index(s);
+      }
+      const ssize_t n=m_indexed_set.index(s);
+      return n<0?npos:static_cast<std::size_t>(n);
+    }
+
+    /// \brief Returns the number of s, after putting it in the store if necessary.
+    std::size_t operator[](const lps::state& s)
+    {
+      return put(s).first;
+    }
+
+    lps::state get(const std::size_t n)
+    {
+      return m_use_tree_compression?m_tree_store.get(n):m_indexed_set.get(n);
+    }
+
+    std::size_t size() const
+    {
+      return m_use_tree_compression?m_tree_store.size():m_indexed_set.size();
+    }
+
+    /// \brief The number of bytes used by the tables of the tree compression, or by the
+    ///        hashtable of the indexed set. The terms themselves are not included.
+    std::size_t memory_in_bytes() const
+    {
+      return m_use_tree_compression?m_tree_store.memory_in_bytes():m_indexed_set.hashtable_memory_in_bytes();
+    }
+};
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_STATE_STORE_H
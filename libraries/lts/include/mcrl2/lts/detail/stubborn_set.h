@@ -0,0 +1,346 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/stubborn_set.h
+/// \brief Computes stubborn sets of summands for partial order reduction during
+///        state space generation.
+
+#ifndef MCRL2_LTS_DETAIL_STUBBORN_SET_H
+#define MCRL2_LTS_DETAIL_STUBBORN_SET_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <vector>
+#include "mcrl2/data/bool.h"
+#include "mcrl2/data/find.h"
+#include "mcrl2/data/join.h"
+#include "mcrl2/data/rewriter.h"
+#include "mcrl2/data/substitutions/mutable_indexed_substitution.h"
+#include "mcrl2/lps/find.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/lps/stochastic_specification.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief Computes stubborn sets of the action summands of a linear process.
+/// \details The dependencies between summands are determined statically from the process
+///          parameters that they read and write, as is done for the read and write groups
+///          of the PINS interface in mcrl2/lps/ltsmin.h. Two summands are dependent if one of
+///          them writes a parameter that the other reads or writes. A summand that is disabled
+///          in a state can only be enabled by a summand that writes a parameter of a conjunct
+///          of its condition that is false in that state.
+///
+///          A stubborn set of a state is closed under these relations: for an enabled summand
+///          it contains all dependent summands, and for a disabled summand all summands that
+///          can enable it. Exploring only the enabled summands of a stubborn set preserves the
+///          deadlocks of the state space (A. Valmari, Stubborn sets for reduced state space
+///          generation, 1991). If visible actions are given, a stubborn set that contains an
+///          enabled summand with a visible action contains all summands with a visible action.
+///          Together with a proviso that every cycle contains a fully explored state, this
+///          also preserves the reachability of the visible actions.
+class stubborn_set_reduction
+{
+  protected:
+    // A conjunct of the condition of a summand, without summation variables, with the
+    // indices of the process parameters that occur in it.
+    struct guard
+    {
+      data::data_expression expression;
+      std::vector<std::size_t> parameters;
+
+      bool operator<(const guard& other) const
+      {
+        return parameters < other.parameters;
+      }
+    };
+
+    data::variable_vector m_process_parameters;
+    std::vector<std::vector<std::size_t> > m_dependent;         // For every summand, the summands that are dependent with it.
+    std::vector<std::vector<std::size_t> > m_condition_writers; // For every summand, the summands that write a parameter in its condition.
+    std::vector<std::vector<guard> > m_guards;
+    std::vector<std::vector<std::size_t> > m_writers;           // For every parameter, the summands that write it.
+    std::vector<bool> m_visible;
+    std::vector<std::size_t> m_visible_summands;
+
+    // The summands that can enable a disabled summand in the current state, or nullptr
+    // if they have not been computed yet.
+    std::vector<const std::vector<std::size_t>*> m_enabling;
+    std::vector<std::vector<std::size_t> > m_guard_enabling;
+
+    static std::vector<std::size_t> parameter_indices(const std::set<data::variable>& variables, const data::variable_vector& parameters)
+    {
+      std::vector<std::size_t> result;
+      for (std::size_t j = 0; j < parameters.size(); ++j)
+      {
+        if (variables.count(parameters[j]) > 0)
+        {
+          result.push_back(j);
+        }
+      }
+      return result;
+    }
+
+    static bool intersect(const std::vector<std::size_t>& v, const std::vector<std::size_t>& w)
+    {
+      std::vector<std::size_t>::const_iterator i = v.begin();
+      std::vector<std::size_t>::const_iterator j = w.begin();
+      while (i != v.end() && j != w.end())
+      {
+        if (*i < *j)
+        {
+          ++i;
+        }
+        else if (*j < *i)
+        {
+          ++j;
+        }
+        else
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    std::vector<std::size_t> writers_of(const std::vector<std::size_t>& parameters) const
+    {
+      std::set<std::size_t> result;
+      for (std::size_t p: parameters)
+      {
+        result.insert(m_writers[p].begin(), m_writers[p].end());
+      }
+      return std::vector<std::size_t>(result.begin(), result.end());
+    }
+
+    // Returns the summands that can enable the disabled summand i in state s. If a conjunct
+    // of the condition of i is false in s, only the writers of its parameters can enable i.
+    // Of these conjuncts the one with the fewest writers is taken.
+    const std::vector<std::size_t>& enabling_summands(std::size_t i, const lps::state& s, data::rewriter& rewr, data::mutable_indexed_substitution<>& sigma)
+    {
+      if (m_enabling[i] == nullptr)
+      {
+        m_enabling[i] = &m_condition_writers[i];
+        for (const guard& g: m_guards[i])
+        {
+          for (std::size_t p: g.parameters)
+          {
+            sigma[m_process_parameters[p]] = s.element_at(p, m_process_parameters.size());
+          }
+          if (rewr(g.expression, sigma) == data::sort_bool::false_())
+          {
+            std::vector<std::size_t> enabling = writers_of(g.parameters);
+            if (enabling.size() < m_enabling[i]->size())
+            {
+              m_guard_enabling[i].swap(enabling);
+              m_enabling[i] = &m_guard_enabling[i];
+            }
+          }
+        }
+      }
+      return *m_enabling[i];
+    }
+
+    // Computes in stubborn the stubborn set that contains the summand seed. The computation is
+    // abandoned if it contains more than bound enabled summands. The number of enabled summands
+    // in the set is returned.
+    std::size_t closure(std::size_t seed, const std::vector<bool>& enabled, std::size_t bound, std::vector<bool>& stubborn,
+                        const lps::state& s, data::rewriter& rewr, data::mutable_indexed_substitution<>& sigma)
+    {
+      stubborn.assign(enabled.size(), false);
+      std::vector<std::size_t> todo(1, seed);
+      stubborn[seed] = true;
+      std::size_t enabled_count = 0;
+      bool visible_added = false;
+      while (!todo.empty())
+      {
+        const std::size_t i = todo.back();
+        todo.pop_back();
+        const std::vector<std::size_t>* successors;
+        if (enabled[i])
+        {
+          if (++enabled_count > bound)
+          {
+            return enabled_count;
+          }
+          successors = &m_dependent[i];
+          if (m_visible[i] && !visible_added)
+          {
+            visible_added = true;
+            for (std::size_t j: m_visible_summands)
+            {
+              if (!stubborn[j])
+              {
+                stubborn[j] = true;
+                todo.push_back(j);
+              }
+            }
+          }
+        }
+        else
+        {
+          successors = &enabling_summands(i, s, rewr, sigma);
+        }
+        for (std::size_t j: *successors)
+        {
+          if (!stubborn[j])
+          {
+            stubborn[j] = true;
+            todo.push_back(j);
+          }
+        }
+      }
+      return enabled_count;
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param spec The specification, of which the action summands are numbered as in a next state generator.
+    /// \param visible_actions The action labels of which the occurrence must be preserved.
+    stubborn_set_reduction(const lps::stochastic_specification& spec, const std::set<core::identifier_string>& visible_actions)
+      : m_process_parameters(spec.process().process_parameters().begin(), spec.process().process_parameters().end())
+    {
+      const lps::stochastic_action_summand_vector& summands = spec.process().action_summands();
+      const std::size_t n = summands.size();
+
+      std::vector<std::vector<std::size_t> > read(n);
+      std::vector<std::vector<std::size_t> > write(n);
+      std::vector<std::vector<std::size_t> > condition_parameters(n);
+      m_guards.resize(n);
+      m_visible.resize(n, false);
+      m_writers.resize(m_process_parameters.size());
+
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        const lps::stochastic_action_summand& summand = summands[i];
+        std::set<data::variable> read_variables;
+        std::set<data::variable> write_variables;
+        std::set<data::variable> condition_variables;
+        data::find_free_variables(summand.condition(), std::inserter(condition_variables, condition_variables.end()));
+        read_variables = condition_variables;
+        lps::find_free_variables(summand.multi_action(), std::inserter(read_variables, read_variables.end()));
+        lps::find_free_variables(summand.distribution(), std::inserter(read_variables, read_variables.end()));
+        for (const data::assignment& a: summand.assignments())
+        {
+          if (a.lhs() != a.rhs())
+          {
+            write_variables.insert(a.lhs());
+            data::find_free_variables(a.rhs(), std::inserter(read_variables, read_variables.end()));
+          }
+        }
+        // Summation variables with the name of a parameter are not parameters.
+        for (const data::variable& v: summand.summation_variables())
+        {
+          read_variables.erase(v);
+          condition_variables.erase(v);
+        }
+        read[i] = parameter_indices(read_variables, m_process_parameters);
+        write[i] = parameter_indices(write_variables, m_process_parameters);
+        condition_parameters[i] = parameter_indices(condition_variables, m_process_parameters);
+        for (std::size_t p: write[i])
+        {
+          m_writers[p].push_back(i);
+        }
+
+        const std::set<data::variable> summation_variables(summand.summation_variables().begin(), summand.summation_variables().end());
+        for (const data::data_expression& conjunct: data::split_and(summand.condition()))
+        {
+          const std::set<data::variable> variables = data::find_free_variables(conjunct);
+          if (std::none_of(variables.begin(), variables.end(), [&](const data::variable& v) { return summation_variables.count(v) > 0; }))
+          {
+            guard g;
+            g.expression = conjunct;
+            g.parameters = parameter_indices(variables, m_process_parameters);
+            m_guards[i].push_back(g);
+          }
+        }
+        // The conjuncts are ordered on their parameters, such that the result does not depend
+        // on the order of the set of conjuncts.
+        std::stable_sort(m_guards[i].begin(), m_guards[i].end());
+
+        for (const process::action& a: summand.multi_action().actions())
+        {
+          if (visible_actions.count(a.label().name()) > 0)
+          {
+            m_visible[i] = true;
+          }
+        }
+        if (m_visible[i])
+        {
+          m_visible_summands.push_back(i);
+        }
+      }
+
+      m_dependent.resize(n);
+      m_condition_writers.resize(n);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        for (std::size_t j = 0; j < n; ++j)
+        {
+          if (i != j && (intersect(write[i], read[j]) || intersect(write[i], write[j]) || intersect(write[j], read[i])))
+          {
+            m_dependent[i].push_back(j);
+          }
+        }
+        m_condition_writers[i] = writers_of(condition_parameters[i]);
+      }
+      m_enabling.resize(n);
+      m_guard_enabling.resize(n);
+    }
+
+    /// \brief Computes a stubborn set of the state s.
+    /// \details Every enabled summand is tried as the seed of the stubborn set, and the set with
+    ///          the fewest enabled summands is taken.
+    /// \param s The state.
+    /// \param enabled For every summand whether it is enabled in s.
+    /// \param rewr A rewriter that is used to evaluate the conditions of summands in s.
+    /// \param stubborn For every summand whether it is in the stubborn set.
+    /// \return The number of enabled summands in the stubborn set.
+    std::size_t compute(const lps::state& s, const std::vector<bool>& enabled, data::rewriter& rewr, std::vector<bool>& stubborn)
+    {
+      assert(enabled.size() == m_dependent.size());
+      std::fill(m_enabling.begin(), m_enabling.end(), nullptr);
+      data::mutable_indexed_substitution<> sigma;
+
+      std::size_t best = std::count(enabled.begin(), enabled.end(), true);
+      stubborn = enabled;
+      std::vector<bool> candidate;
+      for (std::size_t i = 0; i < enabled.size() && best > 1; ++i)
+      {
+        if (enabled[i])
+        {
+          const std::size_t count = closure(i, enabled, best - 1, candidate, s, rewr, sigma);
+          if (count < best)
+          {
+            best = count;
+            stubborn.swap(candidate);
+          }
+        }
+      }
+      return best;
+    }
+
+    /// \brief Returns true if the summand with index i has a visible action.
+    bool is_visible(std::size_t i) const
+    {
+      return m_visible[i];
+    }
+};
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_STUBBORN_SET_H
@@ -93,6 +93,13 @@ bool lps2lts_algorithm::initialise_lts_generation(lts_generation_options *option
   m_options=*options;
 
   assert(!(m_options.bithashing && m_options.outformat != lts_aut && m_options.outformat != lts_none));
+  assert(!(m_options.use_partial_order_reduction && (m_options.bithashing || m_options.priority_action != "" || m_options.detect_divergence)));
+  assert(m_options.external_memory_directory.empty() ||
+         (m_options.expl_strat == es_breadth && !m_options.bithashing && m_options.todo_max == std::string::npos &&
+          !m_options.trace && !m_options.save_error_trace && m_options.priority_action.empty() &&
+          !m_options.detect_divergence && !m_options.detect_action && m_options.trace_multiaction_strings.empty() &&
+          !m_options.use_partial_order_reduction && m_options.threads == 1 &&
+          (m_options.outformat == lts_aut || m_options.outformat == lts_none)));
 
   if (m_options.bithashing)
   {
@@ -100,7 +107,7 @@ bool lps2lts_algorithm::initialise_lts_generation(lts_generation_options *option
   }
   else
   {
-    m_state_numbers = atermpp::indexed_set<lps::state>(m_options.initial_table_size, 50);
+    m_state_numbers = detail::state_store(m_options.initial_table_size, m_options.use_tree_compression);
   }
 
   m_num_states = 0;
@@ -253,7 +260,8 @@ bool lps2lts_algorithm::initialise_lts_generation(lts_generation_options *option
       }
     }
   }
-  m_generator = new next_state_generator(specification, rewriter, m_options.use_enumeration_caching, m_options.use_summand_pruning);
+  m_generator = new next_state_generator(specification, rewriter, m_options.use_enumeration_caching, m_options.use_summand_pruning,
+                                         m_options.enumeration_cache_budget);
 
   if (m_use_confluence_reduction)
   {
@@ -271,6 +279,38 @@ bool lps2lts_algorithm::initialise_lts_generation(lts_generation_options *option
     m_tau_summands = next_state_generator::summand_subset_t(m_generator, tau_summands, m_options.use_summand_pruning);
   }
 
+  m_reduced_states = 0;
+  if (m_options.use_partial_order_reduction)
+  {
+    // The actions that are detected must remain reachable in the reduced state space.
+    std::set<core::identifier_string> visible_actions;
+    if (m_options.detect_action)
+    {
+      visible_actions = m_options.trace_actions;
+    }
+    for (const lps::multi_action& ma: m_options.trace_multiactions)
+    {
+      for (const process::action& a: ma.actions())
+      {
+        visible_actions.insert(a.label().name());
+      }
+    }
+    mCRL2log(verbose) << "applying partial order reduction with stubborn sets";
+    if (!visible_actions.empty())
+    {
+      mCRL2log(verbose) << ", preserving the reachability of the detected actions";
+    }
+    mCRL2log(verbose) << "." << std::endl;
+    m_stubborn_sets.reset(new detail::stubborn_set_reduction(specification, visible_actions));
+    m_summand_transitions.resize(specification.process().action_summands().size());
+    m_por_proviso = !visible_actions.empty();
+  }
+
+  if (m_options.threads > 1)
+  {
+    initialise_worker_generators(specification, rewriter, nonprioritised_summands);
+  }
+
   if (m_options.detect_deadlock)
   {
     mCRL2log(verbose) << "Detect deadlocks.\n" ;
@@ -279,6 +319,51 @@ bool lps2lts_algorithm::initialise_lts_generation(lts_generation_options *option
   return true;
 }
 
+void lps2lts_algorithm::initialise_worker_generators(const stochastic_specification& specification,
+                                                     const data::rewriter& rewriter,
+                                                     const stochastic_action_summand_vector& nonprioritised_summands)
+{
+#ifdef MCRL2_ATERMPP_THREAD_SAFE
+  if (m_options.bithashing || m_options.todo_max != std::string::npos || m_options.use_partial_order_reduction ||
+      (m_options.expl_strat != es_breadth && m_options.expl_strat != es_value_prioritized))
+  {
+    mCRL2log(warning) << "several threads can only be used for breadth first exploration without bit hashing, "
+                         "without partial order reduction and without a bound on the todo list; the state space "
+                         "is generated with one thread." << std::endl;
+    return;
+  }
+
+  mCRL2log(verbose) << "computing the transitions of states with " << m_options.threads << " threads." << std::endl;
+
+  // Every thread gets its own generator, with its own copy of the rewriter, and its own summand subset.
+  for (size_t i = 0; i < m_options.threads; ++i)
+  {
+    next_state_generator* generator = new next_state_generator(specification, rewriter.clone(), m_options.use_enumeration_caching,
+                                                               m_options.use_summand_pruning, m_options.enumeration_cache_budget);
+    m_worker_generators.emplace_back(generator);
+    if (m_use_confluence_reduction)
+    {
+      m_worker_subsets.push_back(next_state_generator::summand_subset_t(generator, nonprioritised_summands, m_options.use_summand_pruning));
+    }
+    else
+    {
+      m_worker_subsets.push_back(next_state_generator::summand_subset_t(generator, m_options.use_summand_pruning));
+    }
+  }
+
+  std::vector<next_state_generator*> generators;
+  std::vector<next_state_generator::summand_subset_t*> subsets;
+  for (size_t i = 0; i < m_worker_generators.size(); ++i)
+  {
+    generators.push_back(m_worker_generators[i].get());
+    subsets.push_back(&m_worker_subsets[i]);
+  }
+  m_parallel_generator.reset(new detail::parallel_transition_generator(generators, subsets, m_state_numbers, m_options.max_states));
+#else
+  mCRL2log(warning) << "the terms are not thread safe in this build of the toolset; the state space is generated with one thread." << std::endl;
+#endif
+}
+
 bool lps2lts_algorithm::generate_lts()
 {
   // First generate a vector of initial states from the initial distribution.
@@ -298,6 +383,19 @@ bool lps2lts_algorithm::generate_lts()
     set_prioritised_representatives(m_initial_states);
   }
 
+  if (!m_options.external_memory_directory.empty())
+  {
+    mCRL2log(verbose) << "generating state space with '" << m_options.expl_strat << "' strategy, storing the states in '"
+                      << m_options.external_memory_directory << "'...\n";
+    generate_lts_breadth_external(m_initial_states);
+    mCRL2log(verbose) << "done with state space generation ("
+                      << m_level-1 << " level" << ((m_level==2)?"":"s") << ", "
+                      << m_num_states << " state" << ((m_num_states == 1)?"":"s")
+                      << " and " << m_num_transitions << " transition" << ((m_num_transitions==1)?"":"s") << ")" << std::endl;
+    report_enumeration_cache();
+    return true;
+  }
+
   if (m_options.bithashing)
   {
     m_bit_hash_table.add_states(m_initial_states);
@@ -345,6 +443,7 @@ bool lps2lts_algorithm::generate_lts()
       if (m_options.todo_max==std::string::npos)
       {
         generate_lts_breadth_todo_max_is_npos();
+        m_parallel_generator.reset();
       }
       else
       {
@@ -388,12 +487,79 @@ bool lps2lts_algorithm::generate_lts()
     return false;
   }
 
+  if (m_stubborn_sets)
+  {
+    mCRL2log(verbose) << "partial order reduction explored a subset of the transitions of "
+                      << m_reduced_states << " state" << ((m_reduced_states == 1)?"":"s") << "." << std::endl;
+  }
+
+  if (m_state_numbers.uses_tree_compression())
+  {
+    mCRL2log(verbose) << "tree compression used " << m_state_numbers.memory_in_bytes()
+                      << " bytes to store the states, excluding the values of the parameters." << std::endl;
+  }
+
+  report_enumeration_cache();
   return true;
 }
 
+void lps2lts_algorithm::report_enumeration_cache()
+{
+  if (!m_options.use_enumeration_caching || !mCRL2logEnabled(verbose))
+  {
+    return;
+  }
+
+  // The statistics of the caches of the generators of all threads are added up.
+  std::vector<const lps::detail::enumeration_cache*> caches(1, &m_generator->get_enumeration_cache());
+  for (const std::unique_ptr<next_state_generator>& generator: m_worker_generators)
+  {
+    caches.push_back(&generator->get_enumeration_cache());
+  }
+
+  size_t bytes = 0;
+  for (const lps::detail::enumeration_cache* cache: caches)
+  {
+    bytes += cache->bytes();
+  }
+  mCRL2log(verbose) << "the enumeration cache uses " << bytes << " bytes, with a budget of "
+                    << m_options.enumeration_cache_budget << " bytes per generator." << std::endl;
+
+  for (size_t i = 0; i < m_generator->get_enumeration_cache().summand_count(); ++i)
+  {
+    lps::detail::enumeration_cache::statistics total;
+    for (const lps::detail::enumeration_cache* cache: caches)
+    {
+      const lps::detail::enumeration_cache::statistics& s = cache->summand_statistics(i);
+      total.hits += s.hits;
+      total.misses += s.misses;
+      total.evictions += s.evictions;
+      total.entries += s.entries;
+      total.bytes += s.bytes;
+    }
+    if (total.hits + total.misses == 0)
+    {
+      continue;
+    }
+    mCRL2log(verbose) << "  summand " << i + 1 << ": " << total.hits << " hits, " << total.misses << " misses ("
+                      << std::fixed << std::setprecision(1) << (100.0 * total.hits) / (total.hits + total.misses)
+                      << "% hit rate), " << total.evictions << " evictions, " << total.entries << " entries of "
+                      << total.bytes << " bytes." << std::endl;
+  }
+}
+
 bool lps2lts_algorithm::finalise_lts_generation()
 {
-  if (m_options.outformat == lts_aut)
+  if (m_external_states)
+  {
+    if (m_options.outformat == lts_aut)
+    {
+      m_external_states->write_aut(m_aut_file, 0);
+      m_aut_file.close();
+    }
+    m_external_states.reset();
+  }
+  else if (m_options.outformat == lts_aut)
   {
     m_aut_file.flush();
     m_aut_file.seekp(0);
@@ -779,9 +945,12 @@ void lps2lts_algorithm::save_actions(const lps::state& state, const next_state_g
   mCRL2log(info) << std::endl;
 }
 
-void lps2lts_algorithm::save_deadlock(const lps::state& state)
+void lps2lts_algorithm::save_deadlock(const lps::state& state, size_t state_number)
 {
-  size_t state_number = m_state_numbers.index(state);
+  if (state_number == std::string::npos)
+  {
+    state_number = m_state_numbers.index(state);
+  }
   if (m_options.trace && m_traces_saved < m_options.max_traces)
   {
     std::string filename = m_options.trace_prefix + "_dlk_" + std::to_string(m_traces_saved) + ".trc";
@@ -964,7 +1133,8 @@ bool lps2lts_algorithm::add_transition(const lps::state& source_state, const nex
 
 void lps2lts_algorithm::get_transitions(const lps::state& state,
                                         std::vector<lps2lts_algorithm::next_state_generator::transition_t>& transitions,
-                                        next_state_generator::enumerator_queue_t& enumeration_queue
+                                        next_state_generator::enumerator_queue_t& enumeration_queue,
+                                        const size_t state_number
                                        )
 {
   assert(transitions.empty());
@@ -990,11 +1160,23 @@ void lps2lts_algorithm::get_transitions(const lps::state& state,
 
   try
   {
-    enumeration_queue.clear();
-    next_state_generator::iterator it(m_generator->begin(state, *m_main_subset, &enumeration_queue));
-    while (it)
+    if (m_parallel_generator)
     {
-      transitions.push_back(*it++);
+      assert(state_number != std::string::npos);
+      m_parallel_generator->get_transitions(state_number, transitions);
+    }
+    else if (m_stubborn_sets)
+    {
+      get_reduced_transitions(state, transitions, enumeration_queue);
+    }
+    else
+    {
+      enumeration_queue.clear();
+      next_state_generator::iterator it(m_generator->begin(state, *m_main_subset, &enumeration_queue));
+      while (it)
+      {
+        transitions.push_back(*it++);
+      }
     }
   }
   catch (mcrl2::runtime_error& e)
@@ -1015,7 +1197,7 @@ void lps2lts_algorithm::get_transitions(const lps::state& state,
 
   if (transitions.empty() && m_options.detect_deadlock)
   {
-    save_deadlock(state);
+    save_deadlock(state, state_number);
   }
 
   if (m_use_confluence_reduction)
@@ -1027,6 +1209,65 @@ void lps2lts_algorithm::get_transitions(const lps::state& state,
   }
 }
 
+void lps2lts_algorithm::get_reduced_transitions(const lps::state& state,
+                                                std::vector<lps2lts_algorithm::next_state_generator::transition_t>& transitions,
+                                                next_state_generator::enumerator_queue_t& enumeration_queue)
+{
+  std::vector<bool> enabled(m_summand_transitions.size());
+  for (size_t i = 0; i < m_summand_transitions.size(); ++i)
+  {
+    m_summand_transitions[i].clear();
+    enumeration_queue.clear();
+    for (next_state_generator::iterator it = m_generator->begin(state, i, &enumeration_queue); it; it++)
+    {
+      m_summand_transitions[i].push_back(*it);
+    }
+    enabled[i] = !m_summand_transitions[i].empty();
+  }
+
+  std::vector<bool> stubborn;
+  const size_t enabled_count = std::count(enabled.begin(), enabled.end(), true);
+  if (m_stubborn_sets->compute(state, enabled, m_generator->get_rewriter(), stubborn) < enabled_count)
+  {
+    if (m_por_proviso)
+    {
+      // Every cycle in the reduced state space must contain a fully explored state. This is
+      // guaranteed by exploring a state fully if a reduced transition leads to a known state.
+      for (size_t i = 0; i < stubborn.size() && stubborn != enabled; ++i)
+      {
+        if (stubborn[i] && enabled[i])
+        {
+          for (const next_state_generator::transition_t& t: m_summand_transitions[i])
+          {
+            bool known = m_state_numbers.index(t.target_state()) != detail::state_store::npos;
+            for (const next_state_generator::state_probability_pair& p: t.other_target_states())
+            {
+              known = known || m_state_numbers.index(p.state()) != detail::state_store::npos;
+            }
+            if (known)
+            {
+              stubborn = enabled;
+              break;
+            }
+          }
+        }
+      }
+    }
+    if (stubborn != enabled)
+    {
+      m_reduced_states++;
+    }
+  }
+
+  for (size_t i = 0; i < m_summand_transitions.size(); ++i)
+  {
+    if (stubborn[i] && enabled[i])
+    {
+      transitions.insert(transitions.end(), m_summand_transitions[i].begin(), m_summand_transitions[i].end());
+    }
+  }
+}
+
 void lps2lts_algorithm::generate_lts_breadth_todo_max_is_npos()
 {
   assert(m_options.todo_max==std::string::npos);
@@ -1041,7 +1282,7 @@ void lps2lts_algorithm::generate_lts_breadth_todo_max_is_npos()
          (current_state < m_options.max_states) && (!m_options.trace || m_traces_saved < m_options.max_traces))
   {
     lps::state state=m_state_numbers.get(current_state);
-    get_transitions(state,transitions,enumeration_queue);
+    get_transitions(state,transitions,enumeration_queue,current_state);
     for (const next_state_generator::transition_t& t: transitions)
     {
       add_transition(state, t);
@@ -1231,6 +1472,80 @@ void lps2lts_algorithm::generate_lts_breadth_bithashing(const next_state_generat
   }
 }
 
+void lps2lts_algorithm::generate_lts_breadth_external(const next_state_generator::transition_t::state_probability_list& initial_states)
+{
+  if (++initial_states.begin() != initial_states.end())
+  {
+    throw mcrl2::runtime_error("the states cannot be stored in external memory if the initial state is a probability distribution.");
+  }
+  m_external_states.reset(new detail::external_state_store(m_options.external_memory_directory,
+                                                           m_options.specification.process().process_parameters().size(),
+                                                           m_options.external_memory_budget));
+  m_external_states->add_state(initial_states.front().state());
+  size_t level_size = m_external_states->next_level();
+
+  size_t current_state = 0;
+  time_t last_log_time = time(nullptr) - 1, new_log_time;
+  std::vector<next_state_generator::transition_t> transitions;
+  next_state_generator::enumerator_queue_t enumeration_queue;
+  lps::state state;
+
+  while (!m_must_abort && level_size > 0 && (current_state < m_options.max_states))
+  {
+    const size_t start_level_transitions = m_num_transitions;
+    for (size_t i = 0; i < level_size && !m_must_abort && (current_state < m_options.max_states); ++i)
+    {
+      const size_t state_number = m_external_states->next_state(state);
+      get_transitions(state, transitions, enumeration_queue, state_number);
+      for (const next_state_generator::transition_t& t: transitions)
+      {
+        if (!t.other_target_states().empty())
+        {
+          throw mcrl2::runtime_error("the states cannot be stored in external memory for a probabilistic transition.");
+        }
+        if (m_options.outformat == lts_aut)
+        {
+          m_external_states->add_transition(state_number, lps::pp(t.action()), t.target_state());
+        }
+        else
+        {
+          m_external_states->add_state(t.target_state());
+        }
+        m_num_transitions++;
+      }
+      transitions.clear();
+      current_state++;
+
+      if (!m_options.suppress_progress_messages && time(&new_log_time) > last_log_time)
+      {
+        last_log_time = new_log_time;
+        mCRL2log(status) << std::fixed << std::setprecision(2)
+                         << m_external_states->state_count() << "st, " << m_num_transitions << "tr"
+                         << ", explored " << 100.0 * ((float)current_state / m_external_states->state_count())
+                         << "%. Last level: " << m_level << ", " << level_size << "st, "
+                         << m_num_transitions - start_level_transitions << "tr.\n";
+      }
+    }
+
+    // The successors of the states of the level are compared with the visited states on disk,
+    // which also happens if the exploration is stopped, such that all targets get a number.
+    level_size = m_external_states->next_level();
+    if (!m_options.suppress_progress_messages)
+    {
+      mCRL2log(verbose) << "monitor: level " << m_level << " done. (" << m_num_transitions - start_level_transitions
+                        << " transition" << ((m_num_transitions - start_level_transitions)==1?"":"s") << ", "
+                        << level_size << " new state" << (level_size==1?"":"s") << ")\n";
+    }
+    m_level++;
+  }
+  m_num_states = m_external_states->state_count();
+
+  if (current_state == m_options.max_states)
+  {
+    mCRL2log(verbose) << "explored the maximum number (" << m_options.max_states << ") of states, terminating." << std::endl;
+  }
+}
+
 void lps2lts_algorithm::generate_lts_depth(const next_state_generator::transition_t::state_probability_list& initial_states)
 {
   std::list<lps::state> stack;
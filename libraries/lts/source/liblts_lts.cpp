@@ -11,8 +11,11 @@
 #include <string>
 #include <cstring>
 #include <sstream>
+#include <fstream>
+#include <memory>
 #include "mcrl2/core/nil.h"
 #include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_io_indexed.h"
 #include "mcrl2/data/data_expression.h"
 #include "mcrl2/data/detail/io.h"
 #include "mcrl2/lps/multi_action.h"
@@ -233,12 +236,35 @@ class aterm_labelled_transition_system: public atermpp::aterm_appl
     }
 };
 
+// The names of the sections of an .lts file in the indexed binary aterm format. They
+// correspond to the arguments of an aterm_labelled_transition_system.
+static const char* const lts_section_names[] = { "meta_data", "transitions", "state_labels", "action_labels" };
+
 static void read_from_lts(probabilistic_lts_lts_t& l, const std::string& filename)
 {
+  // An .lts file is either a single term in binary aterm format, or an indexed binary aterm
+  // file with a section per argument of the lts term. In the latter case the sections are
+  // only decoded when they are needed, such that a large list of transitions has been
+  // converted, and can be garbage collected, before the state labels are decoded.
   aterm input;
+  std::unique_ptr<indexed_binary_aterm_file> indexed_input;
   if (filename=="")
   {
-    input=read_term_from_binary_stream(std::cin);
+    // Standard input cannot be rewound, so its format is determined without consuming it, and it
+    // is read only once, by the reader of that format.
+    inspectable_binary_aterm_istream standard_input(std::cin);
+    if (standard_input.is_indexed())
+    {
+      indexed_input.reset(new indexed_binary_aterm_file(standard_input));
+    }
+    else
+    {
+      input=read_term_from_binary_stream(standard_input);
+    }
+  }
+  else if (is_indexed_binary_aterm_file(filename))
+  {
+    indexed_input.reset(new indexed_binary_aterm_file(filename));
   }
   else 
   {
@@ -278,21 +304,44 @@ static void read_from_lts(probabilistic_lts_lts_t& l, const std::string& filenam
     }
     
   }
-  input=data::detail::add_index(input);
-  
-  if (!input.type_is_appl() || down_cast<aterm_appl>(input).function()!=lts_header())
+
+  if (indexed_input)
   {
-    throw runtime_error("The input file " + filename + " is not in proper .lts format.");
+    for(const char* name: lts_section_names)
+    {
+      if (!indexed_input->has_section(name))
+      {
+        throw runtime_error("The input file " + filename + " is not in proper .lts format. The section " + name + " is missing.");
+      }
+    }
+  }
+  else
+  {
+    input=data::detail::add_index(input);
+    if (!input.type_is_appl() || down_cast<aterm_appl>(input).function()!=lts_header())
+    {
+      throw runtime_error("The input file " + filename + " is not in proper .lts format.");
+    }
   }
+
+  // Returns the i-th argument of the lts term.
+  auto section=[&](const size_t i) -> aterm
+  {
+    if (indexed_input)
+    {
+      return data::detail::add_index(indexed_input->read_section(lts_section_names[i]));
+    }
+    return down_cast<aterm_appl>(input)[i];
+  };
   
-  const aterm meta_data=atermpp::down_cast<aterm_appl>(input)[0];
+  const aterm meta_data=section(0);
   
   if (!meta_data.type_is_appl() || down_cast<aterm_appl>(meta_data).function()!=meta_data_header())
   {
     throw runtime_error("The input file " + filename + " is not in proper .lts format. There is a problem with the datatypes, process parameters and action declarations.");
   }
   
-  const aterm_labelled_transition_system input_lts(input);
+  const aterm_labelled_transition_system input_lts(aterm_appl(lts_header(), meta_data, aterm_list(), aterm_list(), aterm_list()));
   if (input_lts.has_data())
   {
     l.set_data(input_lts.data());
@@ -308,35 +357,41 @@ static void read_from_lts(probabilistic_lts_lts_t& l, const std::string& filenam
     l.set_action_labels(input_lts.action_labels());
   }
   
-  const aterm_transition_list& input_transitions=input_lts.transitions();
-  for(const aterm_probabilistic_transition& t: input_transitions)
   {
-    const size_t prob_state_index=l.add_probabilistic_state(t.target());
-    l.add_transition(transition(t.source(), t.label(), prob_state_index));
+    const aterm_transition_list input_transitions=down_cast<aterm_transition_list>(section(1));
+    for(const aterm_probabilistic_transition& t: input_transitions)
+    {
+      const size_t prob_state_index=l.add_probabilistic_state(t.target());
+      l.add_transition(transition(t.source(), t.label(), prob_state_index));
+    }
   }
   
-  if (input_lts.get_state_labels().size()==0)
-  {
-    l.set_num_states(input_lts.num_states());
-  }
-  else
   {
-    assert(input_lts.num_states()==input_lts.get_state_labels().size());
-    for (const lps::state& state_label:input_lts.get_state_labels())
+    const state_labels_t state_labels=down_cast<state_labels_t>(section(2));
+    if (state_labels.size()==0)
     {
-      l.add_state(state_label_lts(state_label));
+      l.set_num_states(input_lts.num_states());
+    }
+    else
+    {
+      assert(input_lts.num_states()==state_labels.size());
+      for (const lps::state& state_label: state_labels)
+      {
+        l.add_state(state_label_lts(state_label));
+      }
     }
   }
 
-  if (input_lts.get_action_labels().size()==0)
+  const action_labels_t action_labels=down_cast<action_labels_t>(section(3));
+  if (action_labels.size()==0)
   {
     l.set_num_action_labels(input_lts.num_action_labels());
   }
   else
   {
-    assert(input_lts.num_action_labels()==input_lts.get_action_labels().size());
+    assert(input_lts.num_action_labels()==action_labels.size());
     // for (const lps::multi_action& action: input_lts.get_action_labels())
-    for (const atermpp::aterm_appl& t: input_lts.get_action_labels())
+    for (const atermpp::aterm_appl& t: action_labels)
     {
       assert(t.function()==temporary_multi_action_header());
       const lps::multi_action action=lps::multi_action(process::action_list(t[0]), data::data_expression(t[1]));
@@ -386,11 +441,21 @@ static void write_to_lts(const probabilistic_lts_lts_t& l, const std::string& fi
                                             transitions,
                                             state_label_list,
                                             action_label_list);
-  const aterm t1 = data::detail::remove_index(t0);
+
+  // The lts is written as an indexed binary aterm file, with a section per argument of t0.
+  auto write_sections=[&](std::ostream& os)
+  {
+    indexed_binary_aterm_writer writer(os);
+    for(size_t i=0; i<t0.size(); ++i)
+    {
+      writer.add_section(lts_section_names[i], data::detail::remove_index(t0[i]));
+    }
+    writer.close();
+  };
   
   if (filename=="")
   {
-    atermpp::write_term_to_binary_stream(t1, std::cout);
+    write_sections(std::cout);
   }
   else 
   {
@@ -406,7 +471,7 @@ static void write_to_lts(const probabilistic_lts_lts_t& l, const std::string& fi
     }
     try
     { 
-      atermpp::write_term_to_binary_stream(t1, stream);
+      write_sections(stream);
       stream.close();
     }
     catch (std::ofstream::failure)
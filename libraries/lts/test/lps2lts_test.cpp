@@ -36,7 +36,10 @@ template <class LTS_TYPE>
 LTS_TYPE translate_lps_to_lts(lps::stochastic_specification const& specification,
                               lts::exploration_strategy const strategy = lts::es_breadth,
                               mcrl2::data::rewrite_strategy const rewrite_strategy = mcrl2::data::jitty,
-                              const std::string& priority_action = "")
+                              const std::string& priority_action = "",
+                              const bool use_tree_compression = false,
+                              const size_t threads = 1,
+                              const bool external_memory = false)
 {
   std::clog << "Translating LPS to LTS with exploration strategy " << strategy << ", rewrite strategy " << rewrite_strategy << "." << std::endl;
   lts::lts_generation_options options;
@@ -45,6 +48,14 @@ LTS_TYPE translate_lps_to_lts(lps::stochastic_specification const& specification
   options.priority_action = priority_action;
   options.strat = rewrite_strategy;
   options.expl_strat = strategy;
+  options.use_tree_compression = use_tree_compression;
+  options.threads = threads;
+  if (external_memory)
+  {
+    // A small budget, such that the states and transitions are written to several files.
+    options.external_memory_directory = ".";
+    options.external_memory_budget = 4096;
+  }
 
   options.lts = utilities::temporary_filename("lps2lts_test_file");
 
@@ -126,6 +137,41 @@ static void check_lps2lts_specification(const std::string& specification,
       BOOST_CHECK_EQUAL(result3.num_transitions(), expected_transitions);
       BOOST_CHECK_EQUAL(result3.num_action_labels(), expected_labels);
 
+      std::cerr << "LTS FORMAT WITH TREE COMPRESSION\n";
+      lts::lts_lts_t result4 = translate_lps_to_lts<lts::lts_lts_t>(lps, *expl_strategy, *rewr_strategy, priority_action, true);
+
+      BOOST_CHECK_EQUAL(result4.num_states(), expected_states);
+      BOOST_CHECK_EQUAL(result4.num_transitions(), expected_transitions);
+      BOOST_CHECK_EQUAL(result4.num_action_labels(), expected_labels);
+      BOOST_CHECK_EQUAL(result4.num_state_labels(), result2.num_state_labels());
+      for (size_t i = 0; i < std::min(result4.num_state_labels(), result2.num_state_labels()); ++i)
+      {
+        // The states are numbered in the same order, with or without tree compression.
+        BOOST_CHECK(result4.state_label(i) == result2.state_label(i));
+      }
+
+      std::cerr << "LTS FORMAT WITH 4 THREADS\n";
+      lts::lts_lts_t result5 = translate_lps_to_lts<lts::lts_lts_t>(lps, *expl_strategy, *rewr_strategy, priority_action, false, 4);
+
+      BOOST_CHECK_EQUAL(result5.num_states(), expected_states);
+      BOOST_CHECK_EQUAL(result5.num_transitions(), expected_transitions);
+      BOOST_CHECK_EQUAL(result5.num_action_labels(), expected_labels);
+      BOOST_CHECK_EQUAL(result5.num_state_labels(), result2.num_state_labels());
+      for (size_t i = 0; i < std::min(result5.num_state_labels(), result2.num_state_labels()); ++i)
+      {
+        // The states are numbered in the same order, with one or with several threads.
+        BOOST_CHECK(result5.state_label(i) == result2.state_label(i));
+      }
+
+      if (*expl_strategy == lts::es_breadth && priority_action.empty())
+      {
+        std::cerr << "AUT FORMAT WITH EXTERNAL MEMORY\n";
+        lts::lts_aut_t result6 = translate_lps_to_lts<lts::lts_aut_t>(lps, *expl_strategy, *rewr_strategy, priority_action, false, 1, true);
+
+        BOOST_CHECK_EQUAL(result6.num_states(), expected_states);
+        BOOST_CHECK_EQUAL(result6.num_transitions(), expected_transitions);
+        BOOST_CHECK_EQUAL(result6.num_action_labels(), expected_labels);
+      }
     }
   }
 }
@@ -423,6 +469,69 @@ BOOST_AUTO_TEST_CASE(test_max_states)
   BOOST_CHECK_LT(result.num_states(), 10u);
 }
 
+static lts::lts_aut_t translate_lps_to_lts_with_por(const std::string& spec, const std::string& detected_action = "")
+{
+  lps::stochastic_specification specification;
+  parse_lps(spec,specification);
+
+  lts::lts_generation_options options;
+  options.trace_prefix = "lps2lts_test";
+  options.specification = specification;
+  options.lts = utilities::temporary_filename("lps2lts_test_file");
+  options.use_partial_order_reduction = true;
+  if (!detected_action.empty())
+  {
+    options.detect_action = true;
+    options.trace_actions.insert(core::identifier_string(detected_action));
+  }
+
+  lts::lts_aut_t result;
+  options.outformat = result.type();
+  lts::lps2lts_algorithm lps2lts;
+  lps2lts.initialise_lts_generation(&options);
+  lps2lts.generate_lts();
+  lps2lts.finalise_lts_generation();
+  result.load(options.lts);
+  remove(options.lts.c_str()); // Clean up after ourselves
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_partial_order_reduction)
+{
+  // The independent actions a and b are not interleaved, but the deadlock in P(3, 3) is found.
+  std::string spec1(
+  "act a, b;\n"
+  "proc P(x, y: Nat) =\n"
+  "  (x < 3) -> a . P(x = x + 1) +\n"
+  "  (y < 3) -> b . P(y = y + 1);\n"
+  "init P(0, 0);\n");
+
+  lts::lts_aut_t result = translate_lps_to_lts_with_por(spec1);
+  BOOST_CHECK_EQUAL(result.num_states(), 7u);
+  BOOST_CHECK_EQUAL(result.num_transitions(), 6u);
+
+  // Without visible actions the action b is ignored, as the a loop is independent of it.
+  std::string spec2(
+  "act a, b;\n"
+  "proc P(x, y: Bool) =\n"
+  "  a . P(x = !x) +\n"
+  "  b . P(y = !y);\n"
+  "init P(false, false);\n");
+
+  result = translate_lps_to_lts_with_por(spec2);
+  BOOST_CHECK_EQUAL(result.num_states(), 2u);
+  BOOST_CHECK_EQUAL(result.num_transitions(), 2u);
+
+  // If b is detected, it must remain reachable.
+  result = translate_lps_to_lts_with_por(spec2, "b");
+  bool b_found = false;
+  for (const lts::transition& t: result.get_transitions())
+  {
+    b_found = b_found || pp(result.action_label(t.label())) == "b";
+  }
+  BOOST_CHECK(b_found);
+}
+
 BOOST_AUTO_TEST_CASE(test_interaction_sum_and_assignment_notation1)
 {
   std::string spec(
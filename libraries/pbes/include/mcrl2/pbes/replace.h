@@ -314,6 +314,29 @@ T replace_pbes_expressions(const T& x,
   return pbes_system::detail::make_replace_pbes_expressions_builder<pbes_system::pbes_expression_builder>(sigma, innermost).apply(x);
 }
 
+/// \brief Applies the substitution sigma to x, like replace_variables, but each distinct
+/// pbes expression in x is traversed only once. This is much faster for the heavily
+/// shared expressions that are for instance generated by lps2pbes.
+template <typename T, typename Substitution>
+void memoized_replace_variables(T& x,
+                                const Substitution& sigma,
+                                typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                               )
+{
+  core::make_memoizing_update_apply_builder<pbes_system::data_expression_builder, pbes_expression>(sigma).update(x);
+}
+
+/// \brief Applies the substitution sigma to x, like replace_variables, but each distinct
+/// pbes expression in x is traversed only once.
+template <typename T, typename Substitution>
+T memoized_replace_variables(const T& x,
+                             const Substitution& sigma,
+                             typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
+                            )
+{
+  return core::make_memoizing_update_apply_builder<pbes_system::data_expression_builder, pbes_expression>(sigma).apply(x);
+}
+
 } // namespace pbes_system
 
 } // namespace mcrl2
@@ -24,6 +24,7 @@
 #include "mcrl2/pbes/rewriters/simplify_rewriter.h"
 #include "mcrl2/pbes/enumerator.h"
 #include "mcrl2/data/optimized_boolean_operators.h"
+#include "mcrl2/data/parallel_enumerator.h"
 #include "mcrl2/utilities/detail/join.h"
 
 namespace mcrl2 {
@@ -54,6 +55,10 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
   /// The enumerator
   data::enumerator_algorithm<self> E;
 
+  /// Clones of the data rewriter that are used to enumerate quantifiers in other threads.
+  /// If it is nullptr, quantifiers are enumerated by this builder only.
+  const std::vector<DataRewriter>* m_worker_rewriters;
+
   /// \brief Constructor.
   /// \param r A data rewriter.
   /// \param sigma A mutable substitution.
@@ -65,7 +70,8 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
                                 const data::data_specification& dataspec, 
                                 data::enumerator_identifier_generator& id_generator, 
                                 bool enumerate_infinite_sorts = true)
-    : super(r, sigma), m_dataspec(dataspec), m_enumerate_infinite_sorts(enumerate_infinite_sorts), E(*this, m_dataspec, r, id_generator, (std::numeric_limits<std::size_t>::max)(), true)
+    : super(r, sigma), m_dataspec(dataspec), m_enumerate_infinite_sorts(enumerate_infinite_sorts), E(*this, m_dataspec, r, id_generator, (std::numeric_limits<std::size_t>::max)(), true),
+      m_worker_rewriters(nullptr)
   {
     id_generator.clear();
   }
@@ -97,10 +103,60 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
     }
   }
 
+  /// \brief Returns true if the variables v are enumerated in parallel. This is only done if all
+  /// their sorts are finite. Each thread finishes a part of the enumeration on its own, and for an
+  /// infinite sort that part may never finish, while another part contains a solution that ends
+  /// the enumeration, which the sequential breadth first enumeration does find.
+  bool use_parallel_enumeration(const data::variable_list& v) const
+  {
+    if (m_worker_rewriters == nullptr || !data::detail::use_parallel_enumeration())
+    {
+      return false;
+    }
+    data::variable_list finite;
+    data::variable_list infinite;
+    data::detail::split_finite_variables(v, m_dataspec, finite, infinite);
+    return infinite.empty();
+  }
+
+  /// \brief Computes the solutions of phi for the variables v with this builder and builders
+  /// that use the worker rewriters, each in its own thread.
+  template <typename Filter, typename IsFinal>
+  std::vector<enumerator_element> parallel_enumerate(const data::variable_list& v, const pbes_expression& phi, Filter accept, IsFinal is_final)
+  {
+    std::deque<MutableSubstitution> worker_sigmas;
+    std::deque<data::enumerator_identifier_generator> worker_id_generators;
+    std::deque<Derived> workers;
+    std::vector<const data::enumerator_algorithm<self>*> enumerators(1, &E);
+    std::vector<MutableSubstitution*> sigmas(1, &sigma);
+    for (const DataRewriter& r: *m_worker_rewriters)
+    {
+      worker_sigmas.push_back(sigma);
+      worker_id_generators.emplace_back();
+      workers.emplace_back(r, worker_sigmas.back(), m_dataspec, worker_id_generators.back(), m_enumerate_infinite_sorts);
+      enumerators.push_back(&workers.back().E);
+      sigmas.push_back(&worker_sigmas.back());
+    }
+    std::vector<enumerator_element> result;
+    std::deque<enumerator_element> P;
+    P.push_back(enumerator_element(v, derived().apply(phi)));
+    data::parallel_enumerate(enumerators, sigmas, P, accept, is_final, result);
+    return result;
+  }
+
   pbes_expression enumerate_forall(const data::variable_list& v, const pbes_expression& phi)
   {
     auto undo = undo_substitution(v);
     pbes_expression result = true_();
+    if (use_parallel_enumeration(v))
+    {
+      for (const enumerator_element& p: parallel_enumerate(v, phi, is_not_true(), [](const pbes_expression& x) { return is_false(x); }))
+      {
+        result = data::optimized_and(result, p.expression());
+      }
+      redo_substitution(v, undo);
+      return result;
+    }
     std::deque<enumerator_element> P;
     P.push_back(enumerator_element(v, derived().apply(phi)));
     E.next(P, sigma, is_not_true());
@@ -122,6 +178,15 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
   {
     auto undo = undo_substitution(v);
     pbes_expression result = false_();
+    if (use_parallel_enumeration(v))
+    {
+      for (const enumerator_element& p: parallel_enumerate(v, phi, is_not_false(), [](const pbes_expression& x) { return is_true(x); }))
+      {
+        result = data::optimized_or(result, p.expression());
+      }
+      redo_substitution(v, undo);
+      return result;
+    }
     std::deque<enumerator_element> P;
     P.push_back(enumerator_element(v, derived().apply(phi)));
     E.next(P, sigma, is_not_false());
@@ -231,6 +296,14 @@ struct enumerate_quantifiers_rewriter
 
   mutable data::enumerator_identifier_generator m_id_generator;
 
+  /// \brief The domains of the sorts that have been enumerated. As a builder is created
+  /// for every call, the domains are kept here.
+  mutable data::detail::enumerator_domain_cache m_domain_cache;
+
+  /// \brief Clones of m_rewriter that enumerate quantifiers in other threads, if
+  /// data::detail::get_enumerator_thread_count() is larger than one.
+  mutable std::vector<data::rewriter> m_worker_rewriters;
+
   typedef pbes_expression term_type;
   typedef data::variable variable_type;
 
@@ -238,18 +311,40 @@ struct enumerate_quantifiers_rewriter
     : m_rewriter(R), m_dataspec(dataspec), m_enumerate_infinite_sorts(enumerate_infinite_sorts)
   {}
 
+  /// \brief Returns the rewriters of the threads that enumerate quantifiers, or nullptr if
+  /// quantifiers are enumerated sequentially.
+  const std::vector<data::rewriter>* worker_rewriters() const
+  {
+    const std::size_t thread_count = data::detail::get_enumerator_thread_count();
+    if (thread_count <= 1)
+    {
+      return nullptr;
+    }
+    while (m_worker_rewriters.size() + 1 < thread_count)
+    {
+      m_worker_rewriters.push_back(m_rewriter.clone());
+    }
+    return &m_worker_rewriters;
+  }
+
   pbes_expression operator()(const pbes_expression& x) const
   {
     data::rewriter::substitution_type sigma;
     m_id_generator.clear();
-    return detail::apply_enumerate_builder<detail::enumerate_quantifiers_builder, data::rewriter, data::rewriter::substitution_type>(m_rewriter, sigma, m_dataspec, m_id_generator, m_enumerate_infinite_sorts).apply(x);
+    detail::apply_enumerate_builder<detail::enumerate_quantifiers_builder, data::rewriter, data::rewriter::substitution_type> f(m_rewriter, sigma, m_dataspec, m_id_generator, m_enumerate_infinite_sorts);
+    f.E.set_domain_cache(m_domain_cache);
+    f.m_worker_rewriters = worker_rewriters();
+    return f.apply(x);
   }
 
   template <typename MutableSubstitution>
   pbes_expression operator()(const pbes_expression& x, MutableSubstitution& sigma) const
   {
     m_id_generator.clear();
-    return detail::apply_enumerate_builder<detail::enumerate_quantifiers_builder, data::rewriter, MutableSubstitution>(m_rewriter, sigma, m_dataspec, m_id_generator, m_enumerate_infinite_sorts).apply(x);
+    detail::apply_enumerate_builder<detail::enumerate_quantifiers_builder, data::rewriter, MutableSubstitution> f(m_rewriter, sigma, m_dataspec, m_id_generator, m_enumerate_infinite_sorts);
+    f.E.set_domain_cache(m_domain_cache);
+    f.m_worker_rewriters = worker_rewriters();
+    return f.apply(x);
   }
 };
 
@@ -387,6 +387,26 @@ void test_enumerate_quantifiers_rewriter2()
   // R2(y) = X(e1) || X(e2)
 }
 
+// Quantifiers over infinite sorts are enumerated sequentially, also if several threads are used.
+// A thread could otherwise keep enumerating an infinite part of the domain of n, while the
+// solution n == 1000 is in another part.
+void test_enumerate_quantifiers_rewriter_infinite_threads()
+{
+  std::cout << "<test_enumerate_quantifiers_rewriter_infinite_threads>" << std::endl;
+
+  data::data_specification dataspec = data::data_specification();
+  dataspec.add_context_sort(data::sort_nat::nat());
+  data::rewriter datar(dataspec);
+  pbes_system::data_rewriter<data::rewriter> r(datar);
+  enumerate_quantifiers_rewriter R(datar, dataspec);
+
+  data::detail::set_enumerator_thread_count(4);
+  test_rewriters(N(R), N(r), "exists n: Nat. val(n == 1000) || Y(n)"                             , "true");
+  test_rewriters(N(R), N(r), "forall n: Nat. val(n != 1000) && Y(n)"                             , "false");
+  test_rewriters(N(R), N(r), "exists b: Bool, n: Nat. val(b && n == 1000) || Y(n)"               , "true");
+  data::detail::set_enumerator_thread_count(1);
+}
+
 void test_enumerate_quantifiers_rewriter_finite()
 {
   std::cout << "<test_enumerate_quantifiers_rewriter_finite>" << std::endl;
@@ -730,6 +750,13 @@ int test_main(int argc, char* argv[])
   test_simplifying_rewriter();
   test_enumerate_quantifiers_rewriter();
   test_enumerate_quantifiers_rewriter2();
+
+  // Quantifiers that are enumerated with several threads give the same results.
+  data::detail::set_enumerator_thread_count(4);
+  test_enumerate_quantifiers_rewriter();
+  data::detail::set_enumerator_thread_count(1);
+  test_enumerate_quantifiers_rewriter_infinite_threads();
+
   test_enumerate_quantifiers_rewriter_finite();
   test_substitutions1();
   test_substitutions2();
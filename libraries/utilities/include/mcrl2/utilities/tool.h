@@ -20,6 +20,7 @@
 
 #include "mcrl2/utilities/command_line_interface.h"
 #include "mcrl2/utilities/execution_timer.h"
+#include "mcrl2/utilities/tool_statistics.h"
 
 #ifdef WIN32
 #include <io.h>
@@ -65,6 +66,9 @@ class tool
     /// Determines whether timing output should be written
     bool m_timing_enabled;
 
+    /// Determines whether statistics about the term library must be written
+    bool m_term_statistics_enabled;
+
     /// \brief Add options to an interface description.
     /// \param desc An interface description
     virtual void add_options(interface_description& desc)
@@ -72,6 +76,14 @@ class tool
       desc.add_option("timings", make_optional_argument<std::string>("FILE", ""),
                       "append timing measurements to FILE. Measurements are written to "
                       "standard error if no FILE is provided");
+      desc.add_option("term-stats",
+                      "print statistics about the memory used by terms, the term hashtable and "
+                      "garbage collection to standard error when the tool finishes");
+      desc.add_option("gc-slice", make_mandatory_argument("NUM"),
+                      "collect the garbage of the term library incrementally, inspecting at most NUM "
+                      "blocks of terms per collection. This bounds the pauses of long runs, at the "
+                      "expense of keeping empty blocks for reuse. If NUM is 0, all garbage is "
+                      "collected at once, which is the default");
     }
 
     /// \brief Parse non-standard options
@@ -83,6 +95,19 @@ class tool
         m_timing_enabled = true;
         m_timing_filename = parser.option_argument("timings");
       }
+      m_term_statistics_enabled = parser.options.count("term-stats") > 0;
+      if (parser.options.count("gc-slice") > 0)
+      {
+        const size_t blocks_per_slice = parser.option_argument_as<size_t>("gc-slice");
+        if (incremental_garbage_collection_configurator() != nullptr)
+        {
+          incremental_garbage_collection_configurator()(blocks_per_slice);
+        }
+        else
+        {
+          mCRL2log(log::warning) << "option --gc-slice is ignored, as this tool does not use the term library" << std::endl;
+        }
+      }
     }
 
     /// \brief Executed only if run would be executed and invoked before run.
@@ -158,7 +183,8 @@ class tool
         m_known_issues(known_issues),
         m_timing_filename(""),
         m_timer(name),
-        m_timing_enabled(false)
+        m_timing_enabled(false),
+        m_term_statistics_enabled(false)
     {}
 
     /// \brief Destructor.
@@ -226,6 +252,18 @@ class tool
             {
               timer().report();
             }
+
+            if (m_term_statistics_enabled)
+            {
+              if (term_statistics_printer() != nullptr)
+              {
+                term_statistics_printer()(std::cerr);
+              }
+              else
+              {
+                mCRL2log(log::warning) << "no term statistics are available, as this tool does not use the term library" << std::endl;
+              }
+            }
           }
 
           // Either pre_run or run failed.
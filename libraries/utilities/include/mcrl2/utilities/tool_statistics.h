@@ -0,0 +1,45 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/tool_statistics.h
+/// \brief Statistics that tools can print at the end of a run, and the settings of the
+///        term library that tools can change.
+
+#ifndef MCRL2_UTILITIES_TOOL_STATISTICS_H
+#define MCRL2_UTILITIES_TOOL_STATISTICS_H
+
+#include <cstddef>
+#include <iostream>
+
+namespace mcrl2
+{
+
+namespace utilities
+{
+
+/// \brief A function that prints statistics to a stream.
+typedef void (*statistics_printer)(std::ostream&);
+
+/// \brief The function that prints statistics about the term library, or nullptr
+///        if the term library has not been loaded.
+/// \details The term library registers this function itself, as the utilities library,
+///          which contains the tool classes, cannot depend on the term library.
+statistics_printer& term_statistics_printer();
+
+/// \brief A function that sets the number of blocks per slice of the garbage collector.
+typedef void (*garbage_collection_configurator)(std::size_t);
+
+/// \brief The function that sets the garbage collector of the term library to incremental
+///        mode, or nullptr if the term library has not been loaded. See the option --gc-slice.
+garbage_collection_configurator& incremental_garbage_collection_configurator();
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_TOOL_STATISTICS_H
@@ -14,6 +14,10 @@
  *
  * Remarks:
  *
+ * The script runs in a process group of its own, such that cancel() can stop
+ * it, including the compiler it started, from another thread. A cancelled
+ * library does not start the script anymore.
+ *
  * The source is compiled using a script that must take two string arguments.
  * The first argument is the source file, the second is the destination file.
  * After (successful) termination, only the source and destination files must
@@ -22,13 +26,18 @@
  *
  */
 
+#include <atomic>
 #include <cassert>
 #include <cerrno>
+#include <csignal>
 #include <cstdio>
 #include <list>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include "dynamiclibrary.h"
 #include "mcrl2/utilities/file_utility.h"
 #include "mcrl2/utilities/logger.h"
@@ -38,17 +47,73 @@ class uncompiled_library : public dynamic_library
 private:
     std::list<std::string> m_tempfiles;
     std::string m_compile_script;
+    std::atomic<pid_t> m_script_pid;
+    std::atomic<bool> m_cancelled;
+
+    // Starts the command in a new process group, and returns a stream from which
+    // its output can be read.
+    FILE* start_script(const std::string& commandline)
+    {
+      int fds[2];
+      if (pipe(fds) != 0)
+      {
+        return NULL;
+      }
+      pid_t pid = fork();
+      if (pid < 0)
+      {
+        close(fds[0]);
+        close(fds[1]);
+        return NULL;
+      }
+      if (pid == 0)
+      {
+        setpgid(0, 0);
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execl("/bin/sh", "sh", "-c", commandline.c_str(), static_cast<char*>(NULL));
+        _exit(127);
+      }
+      // Also set the process group here, to avoid a race with cancel().
+      setpgid(pid, pid);
+      close(fds[1]);
+      m_script_pid = pid;
+      // If cancel() was called before it could see the pid, the script is stopped here.
+      if (m_cancelled)
+      {
+        kill(-pid, SIGTERM);
+      }
+      return fdopen(fds[0], "r");
+    }
+
+    // Closes the stream and returns the exit status of the script.
+    int finish_script(FILE* stream)
+    {
+      fclose(stream);
+      int status = 0;
+      pid_t pid = m_script_pid.exchange(0);
+      while (pid > 0 && waitpid(pid, &status, 0) < 0 && errno == EINTR)
+      {
+      }
+      return status;
+    }
 
 public:
-    uncompiled_library(const std::string& script) : m_compile_script(script) {}
+    uncompiled_library(const std::string& script) : m_compile_script(script), m_script_pid(0), m_cancelled(false) {}
 
     void compile(const std::string& filename) throw(std::runtime_error)
     {
       std::stringstream commandline;
       commandline << '"' << m_compile_script << "\" " << filename << " " << " 2>&1";
-      
+
+      if (m_cancelled)
+      {
+        throw std::runtime_error("Compile script was terminated.");
+      }
+
       // Execute script.
-      FILE* stream = popen(commandline.str().c_str(), "r");
+      FILE* stream = start_script(commandline.str());
       if (stream == NULL)
       {
         throw std::runtime_error("Could not execute compile script.");
@@ -78,7 +143,7 @@ public:
             {
               mCRL2log(mcrl2::log::error) << std::string(buf);
             }
-            pclose(stream);
+            finish_script(stream);
             throw std::runtime_error("Compile script failed.");
           }
           m_tempfiles.push_back(line);
@@ -96,15 +161,59 @@ public:
       
       if (ferror(stream))
       {
-        pclose(stream);
+        finish_script(stream);
         throw std::runtime_error("There was a problem reading the output of the compile script.");
       }
       
-      pclose(stream);
+      if (WIFSIGNALED(finish_script(stream)))
+      {
+        // The compilation was cancelled; there is nothing to inspect.
+        cleanup();
+        m_tempfiles.clear();
+        throw std::runtime_error("Compile script was terminated.");
+      }
+      if (m_tempfiles.empty())
+      {
+        throw std::runtime_error("Compile script did not produce a library.");
+      }
 
       m_filename = m_tempfiles.back();
     }
 
+    /// Stops a compilation that is running in another thread, or that is about to
+    /// start. The call of compile() in that thread then throws an exception, unless
+    /// the script had already finished.
+    void cancel()
+    {
+      m_cancelled = true;
+      pid_t pid = m_script_pid;
+      if (pid > 0)
+      {
+        kill(-pid, SIGTERM);
+      }
+    }
+
+    /// Use the already compiled library in filename instead of compiling a source
+    /// file. The library is treated as a temporary file, i.e., it is removed by
+    /// cleanup().
+    void use_compiled(const std::string& filename)
+    {
+      m_tempfiles.push_back(filename);
+      m_filename = filename;
+    }
+
+    /// The file name of the compiled library.
+    const std::string& filename() const
+    {
+      return m_filename;
+    }
+
+    /// The script that is used to compile the library.
+    const std::string& compile_script() const
+    {
+      return m_compile_script;
+    }
+
     void leave_files()
     {
       m_tempfiles.clear();
@@ -0,0 +1,24 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file tool_statistics.cpp
+
+#include "mcrl2/utilities/tool_statistics.h"
+
+mcrl2::utilities::statistics_printer& mcrl2::utilities::term_statistics_printer()
+{
+  // A local static, such that it is initialised before the term library registers itself.
+  static statistics_printer printer=nullptr;
+  return printer;
+}
+
+mcrl2::utilities::garbage_collection_configurator& mcrl2::utilities::incremental_garbage_collection_configurator()
+{
+  static garbage_collection_configurator configurator=nullptr;
+  return configurator;
+}
@@ -88,7 +88,8 @@ class lps2lts_tool : public lps2lts_base
                    "If the 'jittyc' rewriter is used, then the MCRL2_COMPILEREWRITER environment "
                    "variable (default value: 'mcrl2compilerewriter') determines the script that "
                    "compiles the rewriter, and MCRL2_COMPILEDIR (default value: '.') determines "
-                   "where temporary files are stored.\n"
+                   "where temporary files are stored. If MCRL2_COMPILECACHE is set, compiled "
+                   "rewriters are kept in that directory and reused by later runs.\n"
                    "\n"
                    "Note that lps2lts can deliver multiple transitions with the same label between"
                    "any pair of states. If this is not desired, such transitions can be removed by"
@@ -101,7 +102,8 @@ class lps2lts_tool : public lps2lts_base
                    "If the jittyc rewriter is used, then the MCRL2_COMPILEREWRITER environment "
                    "variable (default value: mcrl2compilerewriter) determines the script that "
                    "compiles the rewriter, and MCRL2_COMPILEDIR (default value: '.') "
-                   "determines where temporary files are stored."
+                   "determines where temporary files are stored. If MCRL2_COMPILECACHE is set, "
+                   "compiled rewriters are kept in that directory and reused by later runs."
                    "\n"
                    "Note that lps2lts can deliver multiple transitions with the same "
                    "label between any pair of states. If this is not desired, such "
@@ -152,6 +154,10 @@ class lps2lts_tool : public lps2lts_base
       desc.
       add_option("cached",
                  "use enumeration caching techniques to speed up state space generation.").
+      add_option("cache-budget", make_mandatory_argument("NUM"),
+                 "use at most NUM megabytes of memory for the enumeration cache of --cached (default is 256). "
+                 "If the cache is full, the entries that were not used recently are removed. With --verbose "
+                 "the hits, misses and evictions of the cache are reported for every summand.").
       add_option("prune",
                  "use summand pruning to speed up state space generation.").
       add_option("dummy", make_mandatory_argument("BOOL"),
@@ -167,6 +173,13 @@ class lps2lts_tool : public lps2lts_base
                  "they are mapped to the same hash), it can be useful to explore very "
                  "large LTSs that are otherwise not explorable. The default value for NUM is "
                  "approximately 2*10^8 (this corresponds to about 25MB of memory)",'b').
+      add_option("tree-compression",
+                 "store states using tree compression. The parameters of each state are "
+                 "stored in a binary tree, of which each node is stored in a table of pairs "
+                 "of 32 bit numbers. As the nodes are shared between states, a new state "
+                 "typically costs a few tens of bytes, which allows to store many more states "
+                 "than normally. Storing and retrieving a state is somewhat slower, however. "
+                 "This option cannot be combined with --bit-hash.").
       add_option("max", make_mandatory_argument("NUM"),
                  "explore at most NUM states", 'l').
       add_option("todo-max", make_mandatory_argument("NUM"),
@@ -208,6 +221,14 @@ class lps2lts_tool : public lps2lts_base
                  "to tau use the flag -ctau. Note that if the linear process is not tau-confluent, the generated "
                  "state space is necessarily branching bisimilar to the state space of the lps. The generation "
                  "algorithm that is used does not require the linear process to be tau convergent.", 'c').
+      add_option("por",
+                 "apply partial order reduction with stubborn sets, which are computed from the "
+                 "process parameters that the summands read and write. Only some of the outgoing "
+                 "transitions of a state are explored, such that all deadlocks are still found. "
+                 "With --action or --multiaction the reachability of the detected actions is also "
+                 "preserved. The generated state space is in general not equivalent to the full "
+                 "state space. This option cannot be combined with --bit-hash, --confluence, "
+                 "--divergence and --threads.").
       add_option("strategy", make_enum_argument<exploration_strategy>("NAME")
                  .add_value_short(es_breadth, "b", true)
                  .add_value_short(es_depth, "d")
@@ -229,6 +250,23 @@ class lps2lts_tool : public lps2lts_base
                  "For large state spaces the number of progress messages can be quite "
                  "horrendous. This feature helps to suppress those. Other verbose messages, "
                  "such as the total number of states explored, just remain visible.").
+      add_option("threads", make_mandatory_argument("NUM"),
+                 "compute the outgoing transitions of states with NUM threads. The states are "
+                 "numbered and the transitions are written in the same order as with one thread. "
+                 "This is only possible for breadth first search without --bit-hash, --por, --rewrite-profile "
+                 "and --todo-max, and requires a toolset that is built with thread-safe terms (default is 1).").
+      add_option("external-memory", make_mandatory_argument("DIR"),
+                 "store the visited states and the transitions in files in the directory DIR instead of "
+                 "in memory. The states of every level of the breadth first search are kept in a sorted "
+                 "file, and the new states of a level are found by merging with the files of the previous "
+                 "levels. The transitions are written to OUTFILE when the exploration is finished. This is "
+                 "only possible for breadth first search with the aut format or without output, and "
+                 "cannot be combined with --bit-hash, --tree-compression, --todo-max, --confluence, --por, "
+                 "--divergence, --action, --multiaction, --trace, --error-trace and --threads.").
+      add_option("external-memory-budget", make_mandatory_argument("NUM"),
+                 "use at most NUM megabytes of memory for the buffers of states and transitions with "
+                 "--external-memory (default is 1024). The memory that is needed to explore a state "
+                 "and to store the values of the process parameters comes on top of this.").
       add_option("init-tsize", make_mandatory_argument("NUM"),
                  "set the initial size of the internally used hash tables (default is 10000)").
       add_option("tau",make_mandatory_argument("ACTNAMES"),
@@ -275,6 +313,14 @@ class lps2lts_tool : public lps2lts_base
         m_options.bithashing  = true;
         m_options.bithashsize = parser.option_argument_as< unsigned long > ("bit-hash");
       }
+      if (parser.options.count("tree-compression"))
+      {
+        if (parser.options.count("bit-hash"))
+        {
+          throw parser.error("Option --tree-compression cannot be combined with --bit-hash.");
+        }
+        m_options.use_tree_compression = true;
+      }
       if (parser.options.count("max"))
       {
         m_options.max_states = parser.option_argument_as< unsigned long > ("max");
@@ -326,6 +372,27 @@ class lps2lts_tool : public lps2lts_base
           parser.error("Format '" + parser.option_argument("out") + "' is not recognised.");
         }
       }
+      if (parser.options.count("por"))
+      {
+        if (parser.options.count("bit-hash") || parser.options.count("confluence") || parser.options.count("divergence") ||
+            (parser.options.count("threads") && parser.option_argument_as< unsigned long >("threads") > 1))
+        {
+          throw parser.error("Option --por cannot be combined with --bit-hash, --confluence, --divergence or --threads.");
+        }
+        m_options.use_partial_order_reduction = true;
+      }
+      if (parser.options.count("threads"))
+      {
+        m_options.threads = parser.option_argument_as< unsigned long >("threads");
+        if (m_options.threads == 0)
+        {
+          throw parser.error("Option --threads requires a number of threads of at least 1.");
+        }
+        if (m_options.threads > 1 && parser.options.count("rewrite-profile"))
+        {
+          throw parser.error("Option --threads cannot be combined with --rewrite-profile, as the rewriters of all threads would update the same profile.");
+        }
+      }
       if (parser.options.count("init-tsize"))
       {
         m_options.initial_table_size = parser.option_argument_as< unsigned long >("init-tsize");
@@ -367,6 +434,43 @@ class lps2lts_tool : public lps2lts_base
           m_options.outformat = lts_lts;
         }
       }
+
+      if (parser.options.count("external-memory"))
+      {
+        if (parser.options.count("bit-hash") || parser.options.count("tree-compression") || parser.options.count("todo-max") ||
+            parser.options.count("confluence") || parser.options.count("por") || parser.options.count("divergence") ||
+            parser.options.count("action") || parser.options.count("multiaction") || parser.options.count("trace") ||
+            parser.options.count("error-trace") || m_options.threads > 1)
+        {
+          throw parser.error("Option --external-memory cannot be combined with --bit-hash, --tree-compression, --todo-max, "
+                       "--confluence, --por, --divergence, --action, --multiaction, --trace, --error-trace or --threads.");
+        }
+        if (m_options.expl_strat != es_breadth)
+        {
+          throw parser.error("Option --external-memory requires breadth first search.");
+        }
+        if (m_options.outformat != lts_aut && m_options.outformat != lts_none)
+        {
+          throw parser.error("Option --external-memory requires the aut format.");
+        }
+        m_options.external_memory_directory = parser.option_argument("external-memory");
+      }
+      if (parser.options.count("external-memory-budget"))
+      {
+        if (!parser.options.count("external-memory"))
+        {
+          throw parser.error("Option --external-memory-budget requires the option --external-memory.");
+        }
+        m_options.external_memory_budget = parser.option_argument_as< unsigned long >("external-memory-budget") * 1024UL * 1024UL;
+      }
+      if (parser.options.count("cache-budget"))
+      {
+        if (!m_options.use_enumeration_caching)
+        {
+          throw parser.error("Option --cache-budget requires the option --cached.");
+        }
+        m_options.enumeration_cache_budget = parser.option_argument_as< unsigned long >("cache-budget") * 1024UL * 1024UL;
+      }
     }
 
 };
@@ -0,0 +1,98 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file lpsreach.cpp
+
+#include <iomanip>
+#include <iostream>
+#include "mcrl2/data/rewriter_tool.h"
+#include "mcrl2/lps/io.h"
+#include "mcrl2/lps/symbolic_reachability.h"
+#include "mcrl2/utilities/input_tool.h"
+
+using namespace mcrl2;
+using namespace mcrl2::log;
+using namespace mcrl2::utilities;
+using namespace mcrl2::utilities::tools;
+using data::tools::rewriter_tool;
+
+class lpsreach_tool: public rewriter_tool<input_tool>
+{
+  typedef rewriter_tool<input_tool> super;
+
+  protected:
+    bool m_detect_deadlocks;
+    std::size_t m_max_deadlocks;
+
+    void parse_options(const command_line_parser& parser)
+    {
+      super::parse_options(parser);
+      m_detect_deadlocks = parser.options.count("deadlock") > 0;
+      m_max_deadlocks = 10;
+      if (parser.options.count("max-deadlocks"))
+      {
+        m_max_deadlocks = parser.option_argument_as<std::size_t>("max-deadlocks");
+      }
+    }
+
+    void add_options(interface_description& desc)
+    {
+      super::add_options(desc);
+      desc.add_option("deadlock", "detect the reachable deadlock states", 'D');
+      desc.add_option("max-deadlocks", make_mandatory_argument("NUM"), "print at most NUM deadlock states (default 10)");
+    }
+
+  public:
+    lpsreach_tool()
+      : super(
+        "lpsreach",
+        "agent",
+        "compute the reachable states of an LPS symbolically",
+        "Computes the reachable states of the LPS in INFILE, stored in list decision diagrams, "
+        "and prints the number of states, the reachable action labels and optionally the number "
+        "of deadlock states. The transition relations of the summands are learned on the fly. "
+        "If INFILE is not present, standard input is used."
+      )
+    {}
+
+    bool run()
+    {
+      lps::stochastic_specification spec;
+      lps::load_lps(spec, input_filename());
+
+      lps::symbolic_reachability_options options;
+      options.rewrite_strategy = rewrite_strategy();
+      options.detect_deadlocks = m_detect_deadlocks;
+      lps::symbolic_reachability_algorithm algorithm(spec, options);
+      algorithm.run();
+
+      std::cout << std::fixed << std::setprecision(0);
+      std::cout << "number of states: " << algorithm.state_count() << std::endl;
+      mCRL2log(verbose) << "number of LDD nodes: " << algorithm.node_count() << std::endl;
+      if (m_detect_deadlocks)
+      {
+        std::cout << "number of deadlock states: " << algorithm.deadlock_count() << std::endl;
+        for (const lps::state& s: algorithm.deadlock_states(m_max_deadlocks))
+        {
+          std::cout << "deadlock: " << lps::pp(s) << std::endl;
+        }
+      }
+      std::cout << "reachable actions:";
+      for (const std::string& a: algorithm.action_labels())
+      {
+        std::cout << " " << a;
+      }
+      std::cout << std::endl;
+      return true;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+  return lpsreach_tool().execute(argc, argv);
+}
@@ -59,7 +59,8 @@ class network2lts_tool : public network2lts_base
                    "If the 'jittyc' rewriter is used, then the MCRL2_COMPILEREWRITER environment "
                    "variable (default value: 'mcrl2compilerewriter') determines the script that "
                    "compiles the rewriter, and MCRL2_COMPILEDIR (default value: '.') determines "
-                   "where temporary files are stored.\n"
+                   "where temporary files are stored. If MCRL2_COMPILECACHE is set, compiled "
+                   "rewriters are kept in that directory and reused by later runs.\n"
                    "\n"
                    "Note that network2lts can deliver multiple transitions with the same label between"
                    "any pair of states. If this is not desired, such transitions can be removed by"
@@ -72,7 +73,8 @@ class network2lts_tool : public network2lts_base
                    "If the jittyc rewriter is used, then the MCRL2_COMPILEREWRITER environment "
                    "variable (default value: mcrl2compilerewriter) determines the script that "
                    "compiles the rewriter, and MCRL2_COMPILEDIR (default value: '.') "
-                   "determines where temporary files are stored."
+                   "determines where temporary files are stored. If MCRL2_COMPILECACHE is set, "
+                   "compiled rewriters are kept in that directory and reused by later runs."
                    "\n"
                    "Note that network2lts can deliver multiple transitions with the same "
                    "label between any pair of states. If this is not desired, such "